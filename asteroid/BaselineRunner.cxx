@@ -32,6 +32,15 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "BenchStats.h"
+#include "BrickedVolume.h"
+#include "FusedContour.h"
+#include "MappedImageReader.h"
+#include "MultiBlockContour.h"
+#include "PartitionedGrid.h"
+#include "SpanIndex.h"
+#include "ThreadPool.h"
+
 #include <vtkActor.h>
 #include <vtkContourFilter.h>
 #include <vtkDataArraySelection.h>
@@ -40,16 +49,19 @@
 #include <vtkOutlineFilter.h>
 #include <vtkPNGWriter.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkWindowToImageFilter.h>
 #include <vtkXMLImageDataReader.h>
 #include <vtkXMLPolyDataWriter.h>
 #include <vtkXMLUnstructuredGridReader.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <getopt.h>
@@ -57,60 +69,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <string>
+#include <vector>
 
-void Run0(vtkXMLDataReader* reader, const char* outputPng, bool v02, bool v03, bool tev, bool debug,
-  bool lz4, bool gz)
+/*
+ * Renders the meshes of the requested fields (null for the others) and
+ * reports the timings, given the time it took to contour them.
+ */
+void Render(vtkPolyData* mesh1, vtkPolyData* mesh2, vtkPolyData* mesh3, double contouring,
+  const char* outputPng, bool debug, bool lz4, bool gz)
 {
-  vtkDataSet* const inputData = reader->GetOutputAsDataSet();
-  vtkNew<vtkPointData> inputPointData;
-  inputPointData->ShallowCopy(inputData->GetPointData());
-  auto t0 = std::chrono::high_resolution_clock::now();
-
-  vtkNew<vtkContourFilter> cf1;
-  if (v02)
-  {
-    vtkNew<vtkPointData> pd;
-    pd->AddArray(inputPointData->GetAbstractArray("v02"));
-    inputData->GetPointData()->ShallowCopy(pd);
-    cf1->SetInputData(inputData);
-    cf1->ComputeScalarsOff();
-    cf1->ComputeNormalsOff();
-    cf1->SetInputArrayToProcess(
-      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "v02");
-    cf1->SetValue(0, 0.8);
-    cf1->Update();
-  }
-
-  vtkNew<vtkContourFilter> cf2;
-  if (v03)
-  {
-    vtkNew<vtkPointData> pd;
-    pd->AddArray(inputPointData->GetAbstractArray("v03"));
-    inputData->GetPointData()->ShallowCopy(pd);
-    cf2->SetInputData(inputData);
-    cf2->ComputeScalarsOff();
-    cf2->ComputeNormalsOff();
-    cf2->SetInputArrayToProcess(
-      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "v03");
-    cf2->SetValue(0, 0.5);
-    cf2->Update();
-  }
-
-  vtkNew<vtkContourFilter> cf3;
-  if (tev)
-  {
-    vtkNew<vtkPointData> pd;
-    pd->AddArray(inputPointData->GetAbstractArray("tev"));
-    inputData->GetPointData()->ShallowCopy(pd);
-    cf3->SetInputData(inputData);
-    cf3->ComputeScalarsOff();
-    cf3->ComputeNormalsOff();
-    cf3->SetInputArrayToProcess(
-      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "tev");
-    cf3->SetValue(0, 0.1);
-    cf3->Update();
-  }
-
   auto t1 = std::chrono::high_resolution_clock::now();
 
   vtkNew<vtkRenderer> renderer;
@@ -136,9 +103,9 @@ void Run0(vtkXMLDataReader* reader, const char* outputPng, bool v02, bool v03, b
 
   vtkNew<vtkPolyDataMapper> mp1;
   vtkNew<vtkActor> ac1;
-  if (v02)
+  if (mesh1)
   {
-    mp1->SetInputData(cf1->GetOutput());
+    mp1->SetInputData(mesh1);
     mp1->ScalarVisibilityOff();
     ac1->SetMapper(mp1);
     ac1->GetProperty()->LightingOff();
@@ -149,9 +116,9 @@ void Run0(vtkXMLDataReader* reader, const char* outputPng, bool v02, bool v03, b
 
   vtkNew<vtkPolyDataMapper> mp2;
   vtkNew<vtkActor> ac2;
-  if (v03)
+  if (mesh2)
   {
-    mp2->SetInputData(cf2->GetOutput());
+    mp2->SetInputData(mesh2);
     mp2->ScalarVisibilityOff();
     ac2->SetMapper(mp2);
     ac2->GetProperty()->LightingOff();
@@ -162,9 +129,9 @@ void Run0(vtkXMLDataReader* reader, const char* outputPng, bool v02, bool v03, b
 
   vtkNew<vtkPolyDataMapper> mp3;
   vtkNew<vtkActor> ac3;
-  if (tev)
+  if (mesh3)
   {
-    mp3->SetInputData(cf3->GetOutput());
+    mp3->SetInputData(mesh3);
     mp3->ScalarVisibilityOff();
     ac3->SetMapper(mp3);
     ac3->GetProperty()->LightingOff();
@@ -194,10 +161,11 @@ void Run0(vtkXMLDataReader* reader, const char* outputPng, bool v02, bool v03, b
 
   auto t3 = std::chrono::high_resolution_clock::now();
 
-  std::cout << "contouring: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+  std::cout << "contouring: " << contouring << std::endl
             << "rendering: " << std::chrono::duration<double>(t3 - t1).count() << std::endl
             << " - win2image: " << std::chrono::duration<double>(t2 - t1).count() << std::endl
-            << " - png: " << std::chrono::duration<double>(t3 - t2).count() << std::endl;
+            << " - png: " << std::chrono::duration<double>(t3 - t2).count() << std::endl
+            << "peak-rss-kb: " << GetPeakRSS() << std::endl;
 
   if (!debug)
   {
@@ -217,34 +185,139 @@ void Run0(vtkXMLDataReader* reader, const char* outputPng, bool v02, bool v03, b
     writer->SetCompressorTypeToZLib();
   }
 
-  if (v02)
+  if (mesh1)
   {
-    std::cout << "v02-mesh: " << cf1->GetOutput()->GetNumberOfCells() << ", "
-              << cf1->GetOutput()->GetNumberOfPoints() << std::endl;
-    writer->SetInputConnection(cf1->GetOutputPort());
+    std::cout << "v02-mesh: " << mesh1->GetNumberOfCells() << ", " << mesh1->GetNumberOfPoints()
+              << std::endl;
+    writer->SetInputData(mesh1);
     writer->Write();
     std::cout << "v02-size: " << writer->GetOutputString().size() << std::endl;
   }
 
-  if (v03)
+  if (mesh2)
   {
-    std::cout << "v03-mesh: " << cf2->GetOutput()->GetNumberOfCells() << ", "
-              << cf2->GetOutput()->GetNumberOfPoints() << std::endl;
-    writer->SetInputConnection(cf2->GetOutputPort());
+    std::cout << "v03-mesh: " << mesh2->GetNumberOfCells() << ", " << mesh2->GetNumberOfPoints()
+              << std::endl;
+    writer->SetInputData(mesh2);
     writer->Write();
     std::cout << "v03-size: " << writer->GetOutputString().size() << std::endl;
   }
 
-  if (tev)
+  if (mesh3)
   {
-    std::cout << "tev-mesh: " << cf3->GetOutput()->GetNumberOfCells() << ", "
-              << cf3->GetOutput()->GetNumberOfPoints() << std::endl;
-    writer->SetInputConnection(cf3->GetOutputPort());
+    std::cout << "tev-mesh: " << mesh3->GetNumberOfCells() << ", " << mesh3->GetNumberOfPoints()
+              << std::endl;
+    writer->SetInputData(mesh3);
     writer->Write();
     std::cout << "tev-size: " << writer->GetOutputString().size() << std::endl;
   }
 }
 
+void Run0(vtkDataSet* inputData, const char* outputPng, bool v02, bool v03, bool tev, bool debug,
+  bool lz4, bool gz, bool fused, const SpanIndex* span)
+{
+  vtkNew<vtkPointData> inputPointData;
+  inputPointData->ShallowCopy(inputData->GetPointData());
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  vtkSmartPointer<vtkPolyData> mesh1, mesh2, mesh3;
+  if (span)
+  {
+    // Visit only the cells the span index finds active for each field
+    std::vector<vtkIdType> cells;
+    auto contourActive = [&](const ContourRequest& request) {
+      GetActiveCells(*span->FindArray(request.Array), request.Value, &cells);
+      std::cout << request.Array << "-active-cells: " << cells.size() << "/"
+                << inputData->GetNumberOfCells() << std::endl;
+      return FusedContour(inputData, { request }, cells)[0];
+    };
+    if (v02)
+    {
+      mesh1 = contourActive(FieldRequests[0]);
+    }
+    if (v03)
+    {
+      mesh2 = contourActive(FieldRequests[1]);
+    }
+    if (tev)
+    {
+      mesh3 = contourActive(FieldRequests[2]);
+    }
+  }
+  else if (fused)
+  {
+    // One pass over the cells for all requested fields
+    const std::vector<ContourRequest> requests = SelectFieldRequests(v02, v03, tev);
+    std::vector<vtkSmartPointer<vtkPolyData>> meshes = FusedContour(inputData, requests);
+    size_t next = 0;
+    if (v02)
+    {
+      mesh1 = meshes[next++];
+    }
+    if (v03)
+    {
+      mesh2 = meshes[next++];
+    }
+    if (tev)
+    {
+      mesh3 = meshes[next++];
+    }
+  }
+
+  vtkNew<vtkContourFilter> cf1;
+  if (v02 && !fused && !span)
+  {
+    vtkNew<vtkPointData> pd;
+    pd->AddArray(inputPointData->GetAbstractArray("v02"));
+    inputData->GetPointData()->ShallowCopy(pd);
+    cf1->SetInputData(inputData);
+    cf1->ComputeScalarsOff();
+    cf1->ComputeNormalsOff();
+    cf1->SetInputArrayToProcess(
+      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "v02");
+    cf1->SetValue(0, FieldRequests[0].Value);
+    cf1->Update();
+    mesh1 = cf1->GetOutput();
+  }
+
+  vtkNew<vtkContourFilter> cf2;
+  if (v03 && !fused && !span)
+  {
+    vtkNew<vtkPointData> pd;
+    pd->AddArray(inputPointData->GetAbstractArray("v03"));
+    inputData->GetPointData()->ShallowCopy(pd);
+    cf2->SetInputData(inputData);
+    cf2->ComputeScalarsOff();
+    cf2->ComputeNormalsOff();
+    cf2->SetInputArrayToProcess(
+      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "v03");
+    cf2->SetValue(0, FieldRequests[1].Value);
+    cf2->Update();
+    mesh2 = cf2->GetOutput();
+  }
+
+  vtkNew<vtkContourFilter> cf3;
+  if (tev && !fused && !span)
+  {
+    vtkNew<vtkPointData> pd;
+    pd->AddArray(inputPointData->GetAbstractArray("tev"));
+    inputData->GetPointData()->ShallowCopy(pd);
+    cf3->SetInputData(inputData);
+    cf3->ComputeScalarsOff();
+    cf3->ComputeNormalsOff();
+    cf3->SetInputArrayToProcess(
+      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "tev");
+    cf3->SetValue(0, FieldRequests[2].Value);
+    cf3->Update();
+    mesh3 = cf3->GetOutput();
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  Render(mesh1, mesh2, mesh3, std::chrono::duration<double>(t1 - t0).count(), outputPng, debug,
+    lz4, gz);
+}
+
 void EnableArrays(vtkDataArraySelection* selection, bool v02, bool v03, bool tev)
 {
   if (v02)
@@ -261,11 +334,235 @@ void EnableArrays(vtkDataArraySelection* selection, bool v02, bool v03, bool tev
   }
 }
 
+/*
+ * Bricked volume: reads only the bricks that cross each requested isovalue,
+ * contours them and stitches the pieces.
+ */
+void RunBricked(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool tev,
+  bool debug, bool lz4, bool gz)
+{
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  BrickIndex index;
+  if (!ReadBrickIndex(inputVTK, &index))
+  {
+    exit(EXIT_FAILURE);
+  }
+  const std::vector<ContourRequest> requests = SelectFieldRequests(v02, v03, tev);
+  std::vector<BrickSet> bricks(requests.size());
+  uint64_t bytes = 0;
+  for (size_t r = 0; r < requests.size(); r++)
+  {
+    if (!ReadBricks(inputVTK, index, requests[r].Array, requests[r].Value, &bricks[r]))
+    {
+      exit(EXIT_FAILURE);
+    }
+    bytes += bricks[r].BytesRead;
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl;
+  for (size_t r = 0; r < requests.size(); r++)
+  {
+    std::cout << requests[r].Array << "-bricks: " << bricks[r].Bricks.size() << "/"
+              << index.Bricks.size() << std::endl;
+  }
+  std::cout << "brick-bytes: " << bytes << std::endl;
+
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+  for (size_t r = 0; r < requests.size(); r++)
+  {
+    IsoSurface surface;
+    ContourBricks(index, bricks[r], requests[r].Value, &surface);
+    meshes.push_back(IsoSurfaceToPolyData(surface, index.WholeDims, index.Origin, index.Spacing));
+  }
+  size_t next = 0;
+  vtkPolyData* mesh1 = v02 ? meshes[next++].Get() : nullptr;
+  vtkPolyData* mesh2 = v03 ? meshes[next++].Get() : nullptr;
+  vtkPolyData* mesh3 = tev ? meshes[next++].Get() : nullptr;
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  Render(mesh1, mesh2, mesh3, std::chrono::duration<double>(t2 - t1).count(), outputPng, debug,
+    lz4, gz);
+}
+
+/*
+ * Partitioned grid: loads, then contours, only the pieces whose range spans
+ * an isovalue, one pool task per piece in each phase.
+ */
+void RunPartitioned(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool tev,
+  bool debug, bool lz4, bool gz)
+{
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  PartitionManifest manifest;
+  if (!ReadPartitionManifest(inputVTK, &manifest))
+  {
+    exit(EXIT_FAILURE);
+  }
+  const std::vector<ContourRequest> requests = SelectFieldRequests(v02, v03, tev);
+  std::vector<size_t> active;
+  for (size_t p = 0; p < manifest.Pieces.size(); p++)
+  {
+    for (const ContourRequest& request : requests)
+    {
+      if (manifest.IsActive(p, request))
+      {
+        active.push_back(p);
+        break;
+      }
+    }
+  }
+  ThreadPool pool;
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid>> grids(active.size());
+  for (size_t n = 0; n < active.size(); n++)
+  {
+    pool.Submit([&, n]() { grids[n] = ReadPiece(manifest, active[n], requests); });
+  }
+  pool.Wait();
+  if (std::find(grids.begin(), grids.end(), nullptr) != grids.end())
+  {
+    exit(EXIT_FAILURE);
+  }
+  uint64_t bytes = 0;
+  for (size_t p : active)
+  {
+    std::error_code ec;
+    bytes += std::filesystem::file_size(
+      std::filesystem::path(manifest.Directory) / manifest.Pieces[p].File, ec);
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+            << "pieces: " << active.size() << "/" << manifest.Pieces.size() << std::endl
+            << "piece-bytes: " << bytes << std::endl;
+
+  std::vector<std::vector<vtkSmartPointer<vtkPolyData>>> pieceMeshes(active.size());
+  for (size_t n = 0; n < active.size(); n++)
+  {
+    pool.Submit(
+      [&, n]() { pieceMeshes[n] = ContourPiece(manifest, active[n], grids[n], requests); });
+  }
+  pool.Wait();
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    std::vector<vtkSmartPointer<vtkPolyData>> parts;
+    for (const std::vector<vtkSmartPointer<vtkPolyData>>& piece : pieceMeshes)
+    {
+      if (!piece.empty())
+      {
+        parts.push_back(piece[i]);
+      }
+    }
+    meshes.push_back(AppendMeshes(parts));
+  }
+  size_t next = 0;
+  vtkPolyData* mesh1 = v02 ? meshes[next++].Get() : nullptr;
+  vtkPolyData* mesh2 = v03 ? meshes[next++].Get() : nullptr;
+  vtkPolyData* mesh3 = tev ? meshes[next++].Get() : nullptr;
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  Render(mesh1, mesh2, mesh3, std::chrono::duration<double>(t2 - t1).count(), outputPng, debug,
+    lz4, gz);
+}
+
+/*
+ * AMR multiblock: contours the blocks as they are, one pool task per block,
+ * instead of a volume resampled from them.
+ */
+void RunMultiBlock(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool tev,
+  bool debug, bool lz4, bool gz)
+{
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  const std::vector<ContourRequest> requests = SelectFieldRequests(v02, v03, tev);
+  std::vector<std::string> arrays;
+  for (const ContourRequest& request : requests)
+  {
+    arrays.push_back(request.Array);
+  }
+  std::vector<vtkSmartPointer<vtkDataSet>> blocks = ReadMultiBlock(inputVTK, arrays);
+  if (blocks.empty())
+  {
+    exit(EXIT_FAILURE);
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+            << "blocks: " << blocks.size() << std::endl;
+
+  ThreadPool pool;
+  blocks = BlockCellDataToPointData(blocks, arrays, &pool);
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  std::cout << "point-data: " << std::chrono::duration<double>(t2 - t1).count() << std::endl;
+
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes = ContourBlocks(blocks, requests, &pool);
+  size_t next = 0;
+  vtkPolyData* mesh1 = v02 ? meshes[next++].Get() : nullptr;
+  vtkPolyData* mesh2 = v03 ? meshes[next++].Get() : nullptr;
+  vtkPolyData* mesh3 = tev ? meshes[next++].Get() : nullptr;
+
+  auto t3 = std::chrono::high_resolution_clock::now();
+
+  Render(mesh1, mesh2, mesh3, std::chrono::duration<double>(t3 - t2).count(), outputPng, debug,
+    lz4, gz);
+}
+
 void Run(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool tev, bool debug,
-  bool lz4, bool gz)
+  bool lz4, bool gz, bool fused, bool mapped, bool span)
 {
   char t = inputVTK[strlen(inputVTK) - 1];
-  if (t == 'i')
+  if (t == 'k')
+  {
+    RunBricked(inputVTK, outputPng, v02, v03, tev, debug, lz4, gz);
+  }
+  else if (t == 's')
+  {
+    RunPartitioned(inputVTK, outputPng, v02, v03, tev, debug, lz4, gz);
+  }
+  else if (t == 'm')
+  {
+    RunMultiBlock(inputVTK, outputPng, v02, v03, tev, debug, lz4, gz);
+  }
+  else if (t == 'i' && mapped)
+  {
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::string> arrays;
+    if (v02)
+    {
+      arrays.push_back("v02");
+    }
+    if (v03)
+    {
+      arrays.push_back("v03");
+    }
+    if (tev)
+    {
+      arrays.push_back("tev");
+    }
+    vtkSmartPointer<vtkImageData> image = ReadMappedImage(inputVTK, arrays);
+    if (!image)
+    {
+      exit(EXIT_FAILURE);
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+              << "mapped-copied-bytes: " << GetMappedCopiedBytes() << std::endl;
+
+    Run0(image, outputPng, v02, v03, tev, debug, lz4, gz, fused, nullptr);
+  }
+  else if (t == 'i')
   {
     auto t0 = std::chrono::high_resolution_clock::now();
 
@@ -280,7 +577,7 @@ void Run(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool t
 
     std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl;
 
-    Run0(reader.Get(), outputPng, v02, v03, tev, debug, lz4, gz);
+    Run0(reader->GetOutput(), outputPng, v02, v03, tev, debug, lz4, gz, fused, nullptr);
   }
   else if (t == 'u')
   {
@@ -297,7 +594,34 @@ void Run(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool t
 
     std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl;
 
-    Run0(reader.Get(), outputPng, v02, v03, tev, debug, lz4, gz);
+    SpanIndex index;
+    if (span)
+    {
+      std::vector<std::string> arrays;
+      if (v02)
+      {
+        arrays.push_back("v02");
+      }
+      if (v03)
+      {
+        arrays.push_back("v03");
+      }
+      if (tev)
+      {
+        arrays.push_back("tev");
+      }
+      bool built;
+      if (!LoadSpanIndex(reader->GetOutput(), inputVTK, arrays, &index, &built))
+      {
+        exit(EXIT_FAILURE);
+      }
+      auto t2 = std::chrono::high_resolution_clock::now();
+      std::cout << "span-index: " << std::chrono::duration<double>(t2 - t1).count() << std::endl
+                << " - built: " << built << std::endl;
+    }
+
+    Run0(reader->GetOutput(), outputPng, v02, v03, tev, debug, lz4, gz, fused,
+      span ? &index : nullptr);
   }
   else
   {
@@ -309,8 +633,9 @@ void Run(const char* inputVTK, const char* outputPng, bool v02, bool v03, bool t
 int main(int argc, char* argv[])
 {
   bool v02 = false, v03 = false, tev = false, debug = false, lz4 = false, gz = false;
+  bool fused = false, mapped = false, span = false;
   int c;
-  while ((c = getopt(argc, argv, "23tdlgh")) != -1)
+  while ((c = getopt(argc, argv, "23tdlgfmxh")) != -1)
   {
     switch (c)
     {
@@ -332,9 +657,18 @@ int main(int argc, char* argv[])
       case 'g':
         gz = true;
         break;
+      case 'f': /* single-pass contouring of all fields */
+        fused = true;
+        break;
+      case 'm': /* map raw appended .vti files instead of parsing them */
+        mapped = true;
+        break;
+      case 'x': /* contour only the active cells of a .vtu, found with its span index */
+        span = true;
+        break;
       case 'h':
       default:
-        std::cerr << "Usage: " << argv[0] << " -23td <VTK filename>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " -23tdfmx <VTK filename>" << std::endl;
         exit(EXIT_FAILURE);
     }
   }
@@ -342,7 +676,7 @@ int main(int argc, char* argv[])
   argv += optind;
   if (!argc)
   {
-    std::cerr << "Lack target vti/vtu filename" << std::endl;
+    std::cerr << "Lack target vti/vtu/brk/parts filename" << std::endl;
     exit(EXIT_FAILURE);
   }
   std::string outputPng = std::filesystem::path(argv[0]).stem().string() + ".png";
@@ -354,6 +688,9 @@ int main(int argc, char* argv[])
   std::cout << "debug: " << debug << std::endl;
   std::cout << "lz4: " << lz4 << std::endl;
   std::cout << "gz: " << gz << std::endl;
-  Run(argv[0], outputPng.c_str(), v02, v03, tev, debug, lz4, gz);
+  std::cout << "fused: " << fused << std::endl;
+  std::cout << "mapped: " << mapped << std::endl;
+  std::cout << "span: " << span << std::endl;
+  Run(argv[0], outputPng.c_str(), v02, v03, tev, debug, lz4, gz, fused, mapped, span);
   return 0;
 }
@@ -32,66 +32,101 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "MeshIO.h"
+#include "MeshStream.h"
+#include "OffloadServer.h"
+#include "PushdownProtocol.h"
+
 #include <vtkActor.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkOutlineFilter.h>
 #include <vtkPNGWriter.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
 #include <vtkWindowToImageFilter.h>
-#include <vtkXMLPolyDataReader.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <filesystem>
-#include <fstream>
 #include <getopt.h>
 #include <iostream>
+#include <sstream>
 #include <stdlib.h>
 #include <string>
+#include <thread>
+#include <vector>
 
-void Run(const char* pushdown_command_dest, const char* result1, const char* result2,
-  const char* result3, const char* inputVtk, const char* outputPng, bool v02, bool v03, bool tev,
-  int compression)
+void Run(const char* pushdown_command_dest, PushdownTransport transport,
+  const std::string& requestId, const std::string& command, const char* result1,
+  const char* result2, const char* result3, const char* outputPng, bool v02, bool v03, bool tev,
+  MeshEncoding encoding)
 {
+  const bool streaming = encoding == MeshEncoding::Stream;
+  if (streaming)
+  {
+    // Streams are polled as they grow, so a stale one must not be mistaken for
+    // this query's result
+    std::error_code ec;
+    std::filesystem::remove(result1, ec);
+    std::filesystem::remove(result2, ec);
+    std::filesystem::remove(result3, ec);
+  }
+
   auto t0 = std::chrono::high_resolution_clock::now();
+  decltype(t0) ts, tf, t1;
+  vtkSmartPointer<vtkPolyData> mesh1, mesh2, mesh3;
+  const bool fields[3] = { v02, v03, tev };
+  const char* const results[3] = { result1, result2, result3 };
+  vtkSmartPointer<vtkPolyData>* const outputs[3] = { &mesh1, &mesh2, &mesh3 };
+  uintmax_t resultBytes = 0;
+  std::atomic<bool> failed(false);
 
-  {
-    std::ofstream cmd;
-    cmd.open(pushdown_command_dest, std::ios::out | std::ios::binary | std::ios::trunc);
-    cmd << inputVtk << v02 << v03 << tev << compression << std::endl;
-    cmd.close();
-    if (!cmd.good())
+  // The pushdown (submission and result reads) runs on its own thread while
+  // this one sets up the offscreen context and the static scene, keeping
+  // every GL call on the main thread. Streams are consumed on this thread
+  // instead, so that it can render them as they grow; the pushdown thread
+  // then only waits for the server to reply once every stream is closed.
+  // It reports errors through failed and leaves exiting to this thread,
+  // which joins it first
+  std::thread pushdown([&]() {
+    if (streaming)
     {
-      std::cerr << "Cannot write pushdown commands" << std::endl;
-      exit(EXIT_FAILURE);
+      failed = SubmitCommand(transport, pushdown_command_dest, requestId, command) != 0;
+      return;
+    }
+    if (SubmitCommand(transport, pushdown_command_dest, requestId, command) != 0)
+    {
+      std::cerr << "Cannot submit pushdown commands" << std::endl;
+      failed = true;
+      return;
     }
-  }
 
-  vtkNew<vtkXMLPolyDataReader> r1;
-  if (v02)
-  {
-    r1->SetFileName(result1);
-    r1->Update();
-  }
+    ts = std::chrono::high_resolution_clock::now();
 
-  vtkNew<vtkXMLPolyDataReader> r2;
-  if (v03)
-  {
-    r2->SetFileName(result2);
-    r2->Update();
-  }
+    std::error_code ec;
+    for (int i = 0; i < 3; i++)
+    {
+      if (fields[i])
+      {
+        *outputs[i] = ReadMesh(results[i], encoding);
+        resultBytes += std::filesystem::file_size(results[i], ec);
+      }
+    }
 
-  vtkNew<vtkXMLPolyDataReader> r3;
-  if (tev)
-  {
-    r3->SetFileName(result3);
-    r3->Update();
-  }
+    if ((v02 && !mesh1) || (v03 && !mesh2) || (tev && !mesh3))
+    {
+      std::cerr << "Cannot read pushdown results" << std::endl;
+      failed = true;
+      return;
+    }
 
-  auto t1 = std::chrono::high_resolution_clock::now();
+    t1 = std::chrono::high_resolution_clock::now();
+  });
 
   vtkNew<vtkRenderer> renderer;
   renderer->SetBackground(0.321, 0.341, 0.431);
@@ -114,46 +149,33 @@ void Run(const char* pushdown_command_dest, const char* result1, const char* res
   ac0->GetProperty()->SetColor(1, 1, 1);
   renderer->AddActor(ac0);
 
-  if (v02)
-  {
-    vtkNew<vtkPolyDataMapper> mp1;
-    mp1->SetInputConnection(r1->GetOutputPort());
-    mp1->ScalarVisibilityOff();
-
-    vtkNew<vtkActor> ac1;
-    ac1->SetMapper(mp1);
-    ac1->GetProperty()->LightingOff();
-    ac1->GetProperty()->SetColor(0.012, 0.686, 1);
-    ac1->GetProperty()->SetOpacity(0.3);
-    renderer->AddActor(ac1);
-  }
-
-  if (v03)
-  {
-    vtkNew<vtkPolyDataMapper> mp2;
-    mp2->SetInputConnection(r2->GetOutputPort());
-    mp2->ScalarVisibilityOff();
-
-    vtkNew<vtkActor> ac2;
-    ac2->SetMapper(mp2);
-    ac2->GetProperty()->LightingOff();
-    ac2->GetProperty()->SetColor(1, 0.333, 0);
-    ac2->GetProperty()->SetOpacity(0.8);
-    renderer->AddActor(ac2);
-  }
-
-  if (tev)
+  // Result actors exist up front; streamed meshes are shown from the first
+  // render on, the others once they have been read
+  const double colors[3][3] = { { 0.012, 0.686, 1 }, { 1, 0.333, 0 }, { 0.816, 0.816, 0 } };
+  const double opacities[3] = { 0.3, 0.8, 0.15 };
+  vtkSmartPointer<vtkPolyDataMapper> mappers[3];
+  vtkSmartPointer<vtkActor> actors[3];
+  for (int i = 0; i < 3; i++)
   {
-    vtkNew<vtkPolyDataMapper> mp3;
-    mp3->SetInputConnection(r3->GetOutputPort());
-    mp3->ScalarVisibilityOff();
+    if (!fields[i])
+    {
+      continue;
+    }
+    mappers[i] = vtkSmartPointer<vtkPolyDataMapper>::New();
+    mappers[i]->ScalarVisibilityOff();
 
-    vtkNew<vtkActor> ac3;
-    ac3->SetMapper(mp3);
-    ac3->GetProperty()->LightingOff();
-    ac3->GetProperty()->SetColor(0.816, 0.816, 0);
-    ac3->GetProperty()->SetOpacity(0.15);
-    renderer->AddActor(ac3);
+    actors[i] = vtkSmartPointer<vtkActor>::New();
+    actors[i]->SetMapper(mappers[i]);
+    actors[i]->GetProperty()->LightingOff();
+    actors[i]->GetProperty()->SetColor(colors[i][0], colors[i][1], colors[i][2]);
+    actors[i]->GetProperty()->SetOpacity(opacities[i]);
+    if (streaming)
+    {
+      *outputs[i] = vtkSmartPointer<vtkPolyData>::New();
+      InitializeStreamMesh(*outputs[i]);
+      mappers[i]->SetInputData(*outputs[i]);
+      renderer->AddActor(actors[i]);
+    }
   }
 
   vtkNew<vtkRenderWindow> window;
@@ -161,7 +183,63 @@ void Run(const char* pushdown_command_dest, const char* result1, const char* res
   window->SetOffScreenRendering(true);
   window->SetSize(1024, 768);
 
-  renderer->ResetCamera();
+  // The results lie within the known extents, so the camera does not need them
+  renderer->ResetCamera(img->GetBounds());
+  window->Render();
+
+  auto tr = std::chrono::high_resolution_clock::now();
+
+  int streamRenders = 0;
+  if (streaming)
+  {
+    std::vector<const char*> files;
+    std::vector<vtkPolyData*> meshes;
+    for (int i = 0; i < 3; i++)
+    {
+      if (fields[i])
+      {
+        files.push_back(results[i]);
+        meshes.push_back(*outputs[i]);
+      }
+    }
+    ts = std::chrono::high_resolution_clock::now();
+    tf = ts;
+    auto lastRender = ts;
+    uint64_t bytes = 0;
+    bool ok = ReceiveMeshStreams(files, meshes, failed, StreamIdleTimeout, &tf, &bytes, [&]() {
+      auto now = std::chrono::high_resolution_clock::now();
+      if (now - lastRender >= StreamRenderInterval)
+      {
+        window->Render();
+        lastRender = now;
+        streamRenders++;
+      }
+    });
+    pushdown.join();
+    if (!ok || failed)
+    {
+      std::cerr << "Cannot receive pushdown result streams" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    resultBytes = bytes;
+    t1 = std::chrono::high_resolution_clock::now();
+  }
+  else
+  {
+    pushdown.join();
+    if (failed)
+    {
+      exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+      if (fields[i])
+      {
+        mappers[i]->SetInputData(*outputs[i]);
+        renderer->AddActor(actors[i]);
+      }
+    }
+  }
 
   vtkNew<vtkWindowToImageFilter> w2i;
   w2i->SetInput(window);
@@ -178,41 +256,126 @@ void Run(const char* pushdown_command_dest, const char* result1, const char* res
   auto t3 = std::chrono::high_resolution_clock::now();
 
   std::cout << "io-contouring: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
-            << "rendering: " << std::chrono::duration<double>(t3 - t1).count() << std::endl
+            << " - decode: " << std::chrono::duration<double>(t1 - ts).count() << std::endl;
+  if (streaming)
+  {
+    std::cout << "first-chunk: " << std::chrono::duration<double>(tf - t0).count() << std::endl
+              << "stream-renders: " << streamRenders << std::endl;
+  }
+  std::cout << "rendering: " << std::chrono::duration<double>(t3 - t1).count() << std::endl
+            << " - setup: " << std::chrono::duration<double>(tr - t0).count() << std::endl
+            << " - hidden: " << std::chrono::duration<double>(std::min(tr, t1) - t0).count()
+            << std::endl
             << " - win2image: " << std::chrono::duration<double>(t2 - t1).count() << std::endl
             << " - png: " << std::chrono::duration<double>(t3 - t2).count() << std::endl;
 
+  std::cout << "result-bytes: " << resultBytes << std::endl;
   if (v02)
   {
-    std::cout << "v02-mesh: " << r1->GetOutput()->GetNumberOfCells() << ", "
-              << r1->GetOutput()->GetNumberOfPoints() << std::endl;
+    std::cout << "v02-mesh: " << mesh1->GetNumberOfCells() << ", "
+              << mesh1->GetNumberOfPoints() << std::endl;
   }
   if (v03)
   {
-    std::cout << "v03-mesh: " << r2->GetOutput()->GetNumberOfCells() << ", "
-              << r2->GetOutput()->GetNumberOfPoints() << std::endl;
+    std::cout << "v03-mesh: " << mesh2->GetNumberOfCells() << ", "
+              << mesh2->GetNumberOfPoints() << std::endl;
   }
   if (tev)
   {
-    std::cout << "tev-mesh: " << r3->GetOutput()->GetNumberOfCells() << ", "
-              << r3->GetOutput()->GetNumberOfPoints() << std::endl;
+    std::cout << "tev-mesh: " << mesh3->GetNumberOfCells() << ", "
+              << mesh3->GetNumberOfPoints() << std::endl;
+  }
+}
+
+/*
+ * Several inputs: a single version 2 command asks for all of them, one query
+ * per input and field at the field's isovalue (or one per input at every
+ * isovalue given). Results are read back but not rendered.
+ */
+int RunBatch(const char* pushdown_command_dest, PushdownTransport transport,
+  const char* result_prefix, int numInputs, char* inputs[], bool v02, bool v03, bool tev,
+  const std::string& isovalues, int compression, MeshEncoding encoding)
+{
+  const bool fields[3] = { v02, v03, tev };
+  std::vector<double> given;
+  std::istringstream list(isovalues);
+  std::string value;
+  while (std::getline(list, value, ','))
+  {
+    given.push_back(atof(value.c_str()));
+  }
+
+  std::vector<PushdownQuery> queries;
+  for (int f = 0; f < numInputs; f++)
+  {
+    PushdownQuery query;
+    query.InputFile = inputs[f];
+    query.Encoding = encoding;
+    query.Compression = compression;
+    for (int i = 0; i < 3; i++)
+    {
+      if (!fields[i])
+      {
+        continue;
+      }
+      if (given.empty())
+      {
+        query.Name = "q" + std::to_string(f) + "-" + FieldRequests[i].Array;
+        query.Arrays = { FieldRequests[i].Array };
+        query.Values = { FieldRequests[i].Value };
+        queries.push_back(query);
+      }
+      else
+      {
+        query.Arrays.push_back(FieldRequests[i].Array);
+      }
+    }
+    if (!given.empty() && !query.Arrays.empty())
+    {
+      query.Name = "q" + std::to_string(f);
+      query.Values = given;
+      queries.push_back(query);
+    }
   }
+  const std::filesystem::path prefix(result_prefix);
+  const std::string resultDir = prefix.has_parent_path() ? prefix.parent_path().string() : ".";
+  return SubmitBatch(transport, pushdown_command_dest, queries, resultDir);
 }
 
 int main(int argc, char* argv[])
 {
   const char* pushdown_command_dest = "/fuse/command";
   const char* result_prefix = "/fuse/result";
+  PushdownTransport transport = PushdownTransport::CommandFile;
   bool v02 = false, v03 = false, tev = false;
   int compression = 0;
+  MeshEncoding encoding = MeshEncoding::XML;
+  std::string isovalues;
   int c;
-  while ((c = getopt(argc, argv, "d:s:23tlgh")) != -1)
+  while ((c = getopt(argc, argv, "d:u:q:s:i:23tlgbch")) != -1)
   {
     switch (c)
     {
+      case 'i':
+        isovalues = optarg;
+        break;
+      case 'b':
+        encoding = MeshEncoding::Binary;
+        break;
+      case 'c':
+        encoding = MeshEncoding::Stream;
+        break;
       case 'd':
         pushdown_command_dest = optarg;
         break;
+      case 'u':
+        pushdown_command_dest = optarg;
+        transport = PushdownTransport::Socket;
+        break;
+      case 'q':
+        pushdown_command_dest = optarg;
+        transport = PushdownTransport::Spool;
+        break;
       case 's':
         result_prefix = optarg;
         break;
@@ -235,7 +398,11 @@ int main(int argc, char* argv[])
       default:
         std::cerr
           << "Use -23t to specify column combinations, -l or -g to specify compression, "
-          << "-d to specify pushdown command file, and -s to specify pushdown result file prefix"
+          << "-b to receive results as binary meshes instead of XML (or -c as chunked streams), "
+          << "-d to specify pushdown command file (or -u for a pushdown server socket, "
+          << "-q for its spool directory), "
+          << "and -s to specify pushdown result file prefix; "
+          << "with several vtk files, all are queried in one batch (-i to give its isovalues)"
           << std::endl;
         exit(EXIT_FAILURE);
     }
@@ -247,18 +414,85 @@ int main(int argc, char* argv[])
     std::cerr << "Lack target vtk filename" << std::endl;
     exit(EXIT_FAILURE);
   }
-  std::string r0 = std::string(result_prefix) + "0";
-  std::string r1 = std::string(result_prefix) + "1";
-  std::string r2 = std::string(result_prefix) + "2";
+  if (argc > 1)
+  {
+    std::cout << "pushdown analysis command " << GetTransportName(transport) << ": "
+              << pushdown_command_dest << std::endl
+              << "vtk files: " << argc << std::endl
+              << "encoding: " << GetMeshEncodingName(encoding) << std::endl;
+    return RunBatch(pushdown_command_dest, transport, result_prefix, argc, argv, v02, v03, tev,
+      isovalues, compression, encoding);
+  }
+  std::string results[3];
+  for (int i = 0; i < 3; i++)
+  {
+    results[i] = std::string(result_prefix) + std::to_string(i);
+  }
+  std::string requestId;
+  std::string command;
+  std::string requestDir;
+  if (transport == PushdownTransport::Spool)
+  {
+    // Other clients share the spool, so the fixed result files of a version 1
+    // command could be overwritten under us; ask for a request of our own
+    const bool fields[3] = { v02, v03, tev };
+    const std::filesystem::path prefix(result_prefix);
+    requestId = NewRequestId();
+    requestDir = GetRequestResultDir(
+      prefix.has_parent_path() ? prefix.parent_path().string() : ".", requestId);
+    std::vector<PushdownQuery> queries;
+    for (int i = 0; i < 3; i++)
+    {
+      if (!fields[i])
+      {
+        continue;
+      }
+      PushdownQuery query;
+      query.Name = FieldRequests[i].Array;
+      query.InputFile = argv[0];
+      query.Arrays = { FieldRequests[i].Array };
+      query.Values = { FieldRequests[i].Value };
+      query.Encoding = encoding;
+      query.Compression = compression;
+      std::vector<ContourRequest> requests;
+      std::vector<std::string> resultFiles;
+      GetQueryRequests(query, requestDir, &requests, &resultFiles);
+      results[i] = resultFiles[0];
+      queries.push_back(query);
+    }
+    command = FormatBatchCommand(queries, requestId);
+  }
+  else
+  {
+    std::ostringstream cmd;
+    cmd << argv[0] << " " << v02 << " " << v03 << " " << tev << " " << compression << " "
+        << static_cast<int>(encoding) << std::endl;
+    command = cmd.str();
+  }
   std::string outputPng = std::filesystem::path(argv[0]).stem().string() + ".png";
-  std::cout << "pushdown analysis command file: " << pushdown_command_dest << std::endl;
-  std::cout << "pushdown result file: " << result_prefix << "[0-2]" << std::endl;
+  std::cout << "pushdown analysis command " << GetTransportName(transport) << ": "
+            << pushdown_command_dest << std::endl;
+  if (requestDir.empty())
+  {
+    std::cout << "pushdown result file: " << result_prefix << "[0-2]" << std::endl;
+  }
+  else
+  {
+    std::cout << "request id: " << requestId << std::endl;
+    std::cout << "pushdown result dir: " << requestDir << std::endl;
+  }
   std::cout << "vtk file: " << argv[0] << std::endl;
   std::cout << "v02: " << v02 << std::endl;
   std::cout << "v03: " << v03 << std::endl;
   std::cout << "tev: " << tev << std::endl;
   std::cout << "compression (0=none, 1=gz, 2=lz4): " << compression << std::endl;
-  Run(pushdown_command_dest, r0.c_str(), r1.c_str(), r2.c_str(), argv[0], outputPng.c_str(), v02,
-    v03, tev, compression);
+  std::cout << "encoding: " << GetMeshEncodingName(encoding) << std::endl;
+  Run(pushdown_command_dest, transport, requestId, command, results[0].c_str(),
+    results[1].c_str(), results[2].c_str(), outputPng.c_str(), v02, v03, tev, encoding);
+  if (!requestDir.empty())
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(requestDir, ec);
+  }
   return 0;
 }
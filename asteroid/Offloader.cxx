@@ -32,152 +32,859 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "BrickedVolume.h"
+#include "EdgeMesh.h"
+#include "FusedContour.h"
+#include "MeshIO.h"
+#include "MeshStream.h"
+#include "MultiBlockContour.h"
+#include "OffloadServer.h"
+#include "PartitionedGrid.h"
+#include "PushdownProtocol.h"
+#include "ResultCache.h"
+#include "SpanIndex.h"
+#include "ThreadPool.h"
+
 #include <vtkContourFilter.h>
 #include <vtkDataArraySelection.h>
 #include <vtkDataObject.h>
+#include <vtkDataSet.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
-#include <vtkXMLPolyDataWriter.h>
 #include <vtkXMLUnstructuredGridReader.h>
 
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * The distinct arrays requests contour, in order of first use.
+ */
+std::vector<std::string> GetRequestArrays(const std::vector<ContourRequest>& requests)
+{
+  std::vector<std::string> arrays;
+  for (const ContourRequest& request : requests)
+  {
+    if (std::find(arrays.begin(), arrays.end(), request.Array) == arrays.end())
+    {
+      arrays.push_back(request.Array);
+    }
+  }
+  return arrays;
+}
+
+/*
+ * State that outlives a single query. In server mode one context answers
+ * every query, so the reader, its output and the contour filters stay warm
+ * and a repeated query on an unchanged file does not touch the disk again.
+ */
+class OffloadContext
+{
+public:
+  /*
+   * threads sizes the pool piece and block tasks run on (<= 0: one per core).
+   */
+  explicit OffloadContext(int threads)
+    : Pool(threads)
+  {
+  }
 
-void SetCompression(vtkXMLWriter* writer, int compression)
+  vtkUnstructuredGrid* Load(const char* inputFile, const std::vector<ContourRequest>& requests);
+  vtkContourFilter* GetFilter(const char* array, double value);
+  const BrickIndex* LoadBrickIndex(const char* inputFile);
+  ThreadPool* GetPool() { return &this->Pool; }
+  const SpanIndex* GetSpanIndex(const char* inputFile, const std::vector<ContourRequest>& requests);
+
+private:
+  vtkNew<vtkXMLUnstructuredGridReader> Reader;
+  std::string FileName;
+  std::filesystem::file_time_type FileTime;
+  vtkMTimeType DataTime = 0;
+  std::map<std::string, vtkSmartPointer<vtkContourFilter>> Filters;
+  SpanIndex Spans;
+  BrickIndex Bricks;
+  std::string BricksName;
+  std::filesystem::file_time_type BricksTime;
+  ThreadPool Pool;
+};
+
+vtkUnstructuredGrid* OffloadContext::Load(
+  const char* inputFile, const std::vector<ContourRequest>& requests)
 {
-  if (compression == 1)
+  std::error_code ec;
+  std::filesystem::file_time_type fileTime = std::filesystem::last_write_time(inputFile, ec);
+  vtkDataArraySelection* selection = this->Reader->GetPointDataArraySelection();
+  if (this->FileName != inputFile || this->FileTime != fileTime)
   {
-    writer->SetCompressorTypeToZLib();
+    this->FileName = inputFile;
+    this->FileTime = fileTime;
+    this->Reader->SetFileName(inputFile);
+    this->Reader->Modified(); // The file may have been rewritten under the same name
+    this->Reader->UpdateInformation();
+    selection->DisableAllArrays();
   }
-  else if (compression == 2)
+  // Arrays enabled by earlier queries stay enabled so they remain loaded
+  for (const ContourRequest& request : requests)
   {
-    writer->SetCompressorTypeToLZ4();
+    selection->EnableArray(request.Array.c_str());
   }
-  else
+  this->Reader->Update();
+
+  vtkUnstructuredGrid* const inputData = this->Reader->GetOutput();
+  if (inputData->GetMTime() != this->DataTime)
   {
-    writer->SetCompressorTypeToNone();
+    this->DataTime = inputData->GetMTime();
+    this->Filters.clear();
+    this->Spans.Arrays.clear();
   }
+  return inputData;
 }
 
-void EnableArrays(vtkDataArraySelection* selection, bool v02, bool v03, bool tev)
+vtkContourFilter* OffloadContext::GetFilter(const char* array, double value)
 {
-  if (v02)
+  vtkSmartPointer<vtkContourFilter>& cf = this->Filters[array];
+  if (!cf)
   {
-    selection->EnableArray("v02");
+    // Contour a shallow view holding only the target array, so that no other
+    // array gets interpolated and the reader output stays intact for later
+    // queries
+    vtkUnstructuredGrid* const inputData = this->Reader->GetOutput();
+    vtkNew<vtkUnstructuredGrid> view;
+    view->ShallowCopy(inputData);
+    vtkNew<vtkPointData> pd;
+    pd->AddArray(inputData->GetPointData()->GetAbstractArray(array));
+    view->GetPointData()->ShallowCopy(pd);
+    // Views are contoured concurrently, so fill the lazily computed caches
+    // before any worker thread gets to them
+    view->GetBounds();
+    view->GetDistinctCellTypesArray();
+    cf = vtkSmartPointer<vtkContourFilter>::New();
+    cf->SetInputData(view);
+    cf->ComputeScalarsOff();
+    cf->ComputeNormalsOff();
+    cf->SetInputArrayToProcess(
+      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, array);
   }
-  if (v03)
+  cf->SetValue(0, value);
+  return cf;
+}
+
+/*
+ * Returns the span index of the loaded grid covering the requested fields:
+ * from the sidecar on the first query, indexing (and saving) any field it
+ * lacks. Returns nullptr on failure.
+ */
+const SpanIndex* OffloadContext::GetSpanIndex(
+  const char* inputFile, const std::vector<ContourRequest>& requests)
+{
+  const std::vector<std::string> arrays = GetRequestArrays(requests);
+  bool complete = !this->Spans.Arrays.empty();
+  for (const std::string& array : arrays)
   {
-    selection->EnableArray("v03");
+    complete = complete && this->Spans.FindArray(array);
   }
-  if (tev)
+  if (!complete)
   {
-    selection->EnableArray("tev");
+    bool built;
+    if (!LoadSpanIndex(this->Reader->GetOutput(), inputFile, arrays, &this->Spans, &built))
+    {
+      this->Spans.Arrays.clear();
+      return nullptr;
+    }
+    std::cout << "span-index-built: " << built << std::endl;
   }
+  return &this->Spans;
 }
 
-int Run(const char* inputFile, const char* outputFile1, const char* outputFile2,
-  const char* outputFile3, bool v02, bool v03, bool tev, int compression)
+/*
+ * Returns the index of a bricked volume, re-read only when its sidecar
+ * changes, or nullptr.
+ */
+const BrickIndex* OffloadContext::LoadBrickIndex(const char* inputFile)
 {
-  vtkNew<vtkXMLUnstructuredGridReader> reader;
-  reader->SetFileName(inputFile);
-  reader->UpdateInformation();
-  reader->GetPointDataArraySelection()->DisableAllArrays();
-  EnableArrays(reader->GetPointDataArraySelection(), v02, v03, tev);
-  reader->Update();
+  std::error_code ec;
+  std::filesystem::file_time_type fileTime =
+    std::filesystem::last_write_time(std::string(inputFile) + ".idx", ec);
+  if (this->BricksName != inputFile || this->BricksTime != fileTime)
+  {
+    if (!ReadBrickIndex(inputFile, &this->Bricks))
+    {
+      this->BricksName.clear();
+      return nullptr;
+    }
+    this->BricksName = inputFile;
+    this->BricksTime = fileTime;
+  }
+  return &this->Bricks;
+}
 
-  vtkDataSet* const inputData = reader->GetOutput();
-  vtkNew<vtkPointData> inputPointData;
-  inputPointData->ShallowCopy(inputData->GetPointData());
+/*
+ * Writes a finished mesh; stream encoding sends it as a single chunk.
+ * Returns false on failure.
+ */
+bool WriteResult(vtkPolyData* mesh, const char* outputFile, MeshEncoding encoding, int compression)
+{
+  if (encoding == MeshEncoding::Stream)
+  {
+    MeshStreamWriter writer;
+    if (!writer.Open(outputFile))
+    {
+      return false;
+    }
+    const bool written = writer.Write(mesh);
+    return writer.Close() && written;
+  }
+  return WriteMesh(mesh, outputFile, encoding, compression);
+}
 
-  if (v02)
+/*
+ * Writes meshes[i] to outputFiles[i], one pool task per mesh. Returns false
+ * if any write failed.
+ */
+bool WriteResults(const std::vector<vtkSmartPointer<vtkPolyData>>& meshes,
+  const std::vector<const char*>& outputFiles, MeshEncoding encoding, int compression,
+  ThreadPool* pool)
+{
+  std::atomic<bool> ok(true);
+  for (size_t i = 0; i < meshes.size(); i++)
   {
-    vtkNew<vtkPointData> pd;
-    pd->AddArray(inputPointData->GetAbstractArray("v02"));
-    inputData->GetPointData()->ShallowCopy(pd);
-    vtkNew<vtkContourFilter> cf1;
-    cf1->SetInputData(inputData);
-    cf1->ComputeScalarsOff();
-    cf1->ComputeNormalsOff();
-    cf1->SetInputArrayToProcess(
-      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "v02");
-    cf1->SetValue(0, 0.8);
-    cf1->Update();
-
-    vtkNew<vtkXMLPolyDataWriter> w1;
-    w1->SetFileName(outputFile1);
-    w1->SetInputConnection(cf1->GetOutputPort());
-    SetCompression(w1, compression);
-    w1->EncodeAppendedDataOff();
-    w1->Write();
-  }
-
-  if (v03)
+    pool->Submit([&, i]() {
+      if (!WriteResult(meshes[i], outputFiles[i], encoding, compression))
+      {
+        ok = false;
+      }
+    });
+  }
+  pool->Wait();
+  return ok;
+}
+
+/*
+ * Runs as a per-field pool task: the write (and its compression) starts as
+ * soon as this field is contoured, independently of the other fields. Returns
+ * false if the write failed.
+ */
+bool ContourAndWrite(
+  vtkContourFilter* cf, const char* outputFile, MeshEncoding encoding, int compression)
+{
+  cf->Update();
+  return WriteMesh(cf->GetOutput(), outputFile, encoding, compression);
+}
+
+/*
+ * Contours all requested fields in a single pass over the grid, then writes
+ * the results concurrently on pool. Returns false if any write failed.
+ */
+bool FusedContourAndWrite(vtkUnstructuredGrid* grid, const std::vector<ContourRequest>& requests,
+  const std::vector<const char*>& outputFiles, MeshEncoding encoding, int compression,
+  ThreadPool* pool)
+{
+  return WriteResults(FusedContour(grid, requests), outputFiles, encoding, compression, pool);
+}
+
+/*
+ * Contours each requested field over only its active cells, as found by the
+ * span index, as one pool task per field (or over the union of them in one
+ * pass if fused), and writes the results concurrently on pool. Returns
+ * false if any write failed.
+ */
+bool ActiveContourAndWrite(vtkUnstructuredGrid* grid, const SpanIndex& span,
+  const std::vector<ContourRequest>& requests, const std::vector<const char*>& outputFiles,
+  MeshEncoding encoding, int compression, bool fused, ThreadPool* pool)
+{
+  std::vector<std::vector<vtkIdType>> cells(requests.size());
+  for (size_t i = 0; i < requests.size(); i++)
   {
-    vtkNew<vtkPointData> pd;
-    pd->AddArray(inputPointData->GetAbstractArray("v03"));
-    inputData->GetPointData()->ShallowCopy(pd);
-    vtkNew<vtkContourFilter> cf2;
-    cf2->SetInputData(inputData);
-    cf2->ComputeScalarsOff();
-    cf2->ComputeNormalsOff();
-    cf2->SetInputArrayToProcess(
-      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "v03");
-    cf2->SetValue(0, 0.5);
-    cf2->Update();
-
-    vtkNew<vtkXMLPolyDataWriter> w2;
-    w2->SetFileName(outputFile2);
-    w2->SetInputConnection(cf2->GetOutputPort());
-    SetCompression(w2, compression);
-    w2->EncodeAppendedDataOff();
-    w2->Write();
-  }
-
-  if (tev)
+    GetActiveCells(*span.FindArray(requests[i].Array), requests[i].Value, &cells[i]);
+    std::cout << requests[i].Array << "-active-cells: " << cells[i].size() << std::endl;
+  }
+  if (fused)
   {
-    vtkNew<vtkPointData> pd;
-    pd->AddArray(inputPointData->GetAbstractArray("tev"));
-    inputData->GetPointData()->ShallowCopy(pd);
-    vtkNew<vtkContourFilter> cf3;
-    cf3->SetInputData(inputData);
-    cf3->ComputeScalarsOff();
-    cf3->ComputeNormalsOff();
-    cf3->SetInputArrayToProcess(
-      0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "tev");
-    cf3->SetValue(0, 0.1);
-    cf3->Update();
+    std::vector<vtkIdType> all;
+    for (const std::vector<vtkIdType>& c : cells)
+    {
+      std::vector<vtkIdType> merged;
+      std::set_union(all.begin(), all.end(), c.begin(), c.end(), std::back_inserter(merged));
+      all.swap(merged);
+    }
+    return WriteResults(
+      FusedContour(grid, requests, all), outputFiles, encoding, compression, pool);
+  }
+  std::atomic<bool> ok(true);
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    pool->Submit([&, i]() {
+      vtkSmartPointer<vtkPolyData> mesh = FusedContour(grid, { requests[i] }, cells[i])[0];
+      if (!WriteMesh(mesh, outputFiles[i], encoding, compression))
+      {
+        ok = false;
+      }
+    });
+  }
+  pool->Wait();
+  return ok;
+}
+
+/*
+ * Contours the requested fields piece by piece over consecutive cell ranges
+ * (the grid's AMR order keeps them spatially coherent) and appends each
+ * piece to the field's result stream as soon as it is done. Returns false if
+ * any stream could not be written; the others are still closed.
+ */
+bool StreamContourAndWrite(vtkUnstructuredGrid* grid, const std::vector<ContourRequest>& requests,
+  const std::vector<const char*>& outputFiles)
+{
+  bool ok = true;
+  std::vector<MeshStreamWriter> writers(requests.size());
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    ok = writers[i].Open(outputFiles[i]) && ok;
+  }
+  const vtkIdType numCells = grid->GetNumberOfCells();
+  const vtkIdType chunkCells = std::max<vtkIdType>(numCells / 16, 1);
+  for (vtkIdType begin = 0; begin < numCells; begin += chunkCells)
+  {
+    std::vector<vtkSmartPointer<vtkPolyData>> meshes =
+      FusedContour(grid, requests, begin, std::min(begin + chunkCells, numCells));
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+      ok = writers[i].Write(meshes[i]) && ok;
+    }
+  }
+  for (MeshStreamWriter& writer : writers)
+  {
+    ok = writer.Close() && ok;
+  }
+  return ok;
+}
+
+/*
+ * Bricked volume: reads and contours only the bricks that cross each
+ * isovalue, then writes the stitched results concurrently on the context's
+ * pool. Edge encoding sends the lattice form of the surfaces; stream
+ * encoding sends each one as a single chunk.
+ */
+int RunBricked(OffloadContext* ctx, const char* inputFile,
+  const std::vector<ContourRequest>& requests, const std::vector<const char*>& outputFiles,
+  MeshEncoding encoding, int compression)
+{
+  const BrickIndex* const index = ctx->LoadBrickIndex(inputFile);
+  if (!index)
+  {
+    return EXIT_FAILURE;
+  }
+  std::vector<IsoSurface> surfaces(requests.size());
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    BrickSet bricks;
+    if (!ReadBricks(inputFile, *index, requests[i].Array, requests[i].Value, &bricks))
+    {
+      return EXIT_FAILURE;
+    }
+    std::cout << requests[i].Array << "-bricks: " << bricks.Bricks.size() << "/"
+              << index->Bricks.size() << std::endl;
+    ContourBricks(*index, bricks, requests[i].Value, &surfaces[i]);
+  }
+
+  std::atomic<bool> ok(true);
+  for (size_t i = 0; i < surfaces.size(); i++)
+  {
+    ctx->GetPool()->Submit([&, i]() {
+      bool written;
+      if (encoding == MeshEncoding::Edge)
+      {
+        written = WriteEdgeMesh(
+          surfaces[i], index->WholeDims, index->Origin, index->Spacing, outputFiles[i]);
+      }
+      else
+      {
+        vtkSmartPointer<vtkPolyData> mesh =
+          IsoSurfaceToPolyData(surfaces[i], index->WholeDims, index->Origin, index->Spacing);
+        written = WriteResult(mesh, outputFiles[i], encoding, compression);
+      }
+      if (!written)
+      {
+        ok = false;
+      }
+    });
+  }
+  ctx->GetPool()->Wait();
+  return ok ? 0 : EXIT_FAILURE;
+}
+
+/*
+ * Partitioned grid: loads and contours only the pieces whose range spans an
+ * isovalue, one pool task per piece. In stream mode every piece's meshes are
+ * appended to the result streams as soon as the piece is done.
+ */
+int RunPartitioned(OffloadContext* ctx, const char* inputFile,
+  const std::vector<ContourRequest>& requests, const std::vector<const char*>& outputFiles,
+  MeshEncoding encoding, int compression)
+{
+  PartitionManifest manifest;
+  if (!ReadPartitionManifest(inputFile, &manifest))
+  {
+    return EXIT_FAILURE;
+  }
+  if (encoding != MeshEncoding::Stream)
+  {
+    PartitionStats stats;
+    std::vector<vtkSmartPointer<vtkPolyData>> meshes =
+      ContourPartitions(manifest, requests, ctx->GetPool(), &stats);
+    std::cout << "pieces: " << stats.PiecesRead << "/" << manifest.Pieces.size() << std::endl
+              << "piece-bytes: " << stats.BytesRead << std::endl;
+    if (meshes.size() != requests.size())
+    {
+      return EXIT_FAILURE;
+    }
+    const bool ok = WriteResults(meshes, outputFiles, encoding, compression, ctx->GetPool());
+    return ok ? 0 : EXIT_FAILURE;
+  }
+
+  // A piece that cannot be read fails the query, whose streams still close
+  std::atomic<bool> ok(true);
+  std::vector<MeshStreamWriter> writers(requests.size());
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    if (!writers[i].Open(outputFiles[i]))
+    {
+      ok = false;
+    }
+  }
+  std::mutex mutex;
+  for (size_t p = 0; p < manifest.Pieces.size(); p++)
+  {
+    const bool active = std::any_of(requests.begin(), requests.end(),
+      [&](const ContourRequest& request) { return manifest.IsActive(p, request); });
+    if (!active)
+    {
+      continue;
+    }
+    ctx->GetPool()->Submit([&, p]() {
+      vtkSmartPointer<vtkUnstructuredGrid> grid = ReadPiece(manifest, p, requests);
+      if (!grid)
+      {
+        ok = false;
+        return;
+      }
+      std::vector<vtkSmartPointer<vtkPolyData>> meshes = ContourPiece(manifest, p, grid, requests);
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t i = 0; i < meshes.size(); i++)
+      {
+        if (meshes[i] && !writers[i].Write(meshes[i]))
+        {
+          ok = false;
+        }
+      }
+    });
+  }
+  ctx->GetPool()->Wait();
+  for (MeshStreamWriter& writer : writers)
+  {
+    if (!writer.Close())
+    {
+      ok = false;
+    }
+  }
+  return ok ? 0 : EXIT_FAILURE;
+}
 
-    vtkNew<vtkXMLPolyDataWriter> w3;
-    w3->SetFileName(outputFile3);
-    w3->SetInputConnection(cf3->GetOutputPort());
-    SetCompression(w3, compression);
-    w3->EncodeAppendedDataOff();
-    w3->Write();
+/*
+ * AMR multiblock: converts and contours the blocks as they are, one pool
+ * task per block, then writes the appended results concurrently. Stream
+ * encoding sends each one as a single chunk.
+ */
+int RunMultiBlock(OffloadContext* ctx, const char* inputFile,
+  const std::vector<ContourRequest>& requests, const std::vector<const char*>& outputFiles,
+  MeshEncoding encoding, int compression)
+{
+  const std::vector<std::string> arrays = GetRequestArrays(requests);
+  std::vector<vtkSmartPointer<vtkDataSet>> blocks = ReadMultiBlock(inputFile, arrays);
+  if (blocks.empty())
+  {
+    return EXIT_FAILURE;
   }
+  std::cout << "blocks: " << blocks.size() << std::endl;
+  blocks = BlockCellDataToPointData(blocks, arrays, ctx->GetPool());
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes =
+    ContourBlocks(blocks, requests, ctx->GetPool());
+  blocks.clear();
 
-  return 0;
+  const bool ok = WriteResults(meshes, outputFiles, encoding, compression, ctx->GetPool());
+  return ok ? 0 : EXIT_FAILURE;
 }
 
 /*
- * Usage: argc=5, argv1=command_file, argv2=result_file1, argv3=result_file2,
- *   argv4=result_file3
+ * Answers requests on inputFile, writing request i's isosurface to
+ * outputFiles[i]. Requests may repeat an array with different isovalues.
+ */
+int Run(OffloadContext* ctx, const char* inputFile, const std::vector<ContourRequest>& requests,
+  const std::vector<const char*>& outputFiles, MeshEncoding encoding, int compression, bool fused,
+  bool span)
+{
+  const std::string fileName(inputFile);
+  if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".brk") == 0)
+  {
+    return RunBricked(ctx, inputFile, requests, outputFiles, encoding, compression);
+  }
+  if (fileName.size() > 6 && fileName.compare(fileName.size() - 6, 6, ".parts") == 0)
+  {
+    return RunPartitioned(ctx, inputFile, requests, outputFiles, encoding, compression);
+  }
+  if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".vtm") == 0)
+  {
+    return RunMultiBlock(ctx, inputFile, requests, outputFiles, encoding, compression);
+  }
+
+  vtkUnstructuredGrid* const grid = ctx->Load(inputFile, requests);
+
+  if (encoding == MeshEncoding::Stream)
+  {
+    grid->GetBounds(); // Computed once here rather than racily by the streams
+    if (fused)
+    {
+      return StreamContourAndWrite(grid, requests, outputFiles) ? 0 : EXIT_FAILURE;
+    }
+    std::atomic<bool> ok(true);
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+      ctx->GetPool()->Submit([&, i]() {
+        if (!StreamContourAndWrite(grid, { requests[i] }, { outputFiles[i] }))
+        {
+          ok = false;
+        }
+      });
+    }
+    ctx->GetPool()->Wait();
+    return ok ? 0 : EXIT_FAILURE;
+  }
+
+  if (span)
+  {
+    grid->GetBounds(); // Computed once here rather than racily by the workers
+    const SpanIndex* const index = ctx->GetSpanIndex(inputFile, requests);
+    if (!index)
+    {
+      return EXIT_FAILURE;
+    }
+    const bool ok = ActiveContourAndWrite(
+      grid, *index, requests, outputFiles, encoding, compression, fused, ctx->GetPool());
+    return ok ? 0 : EXIT_FAILURE;
+  }
+
+  if (fused)
+  {
+    const bool ok =
+      FusedContourAndWrite(grid, requests, outputFiles, encoding, compression, ctx->GetPool());
+    return ok ? 0 : EXIT_FAILURE;
+  }
+
+  // Each field has its own view and filter, so the fields are contoured and
+  // written concurrently, one pool task per field; the isovalues of one field
+  // take turns on its filter
+  const std::vector<std::string> arrays = GetRequestArrays(requests);
+  std::vector<vtkContourFilter*> filters;
+  for (const std::string& array : arrays)
+  {
+    filters.push_back(ctx->GetFilter(array.c_str(), 0));
+  }
+  std::atomic<bool> ok(true);
+  for (size_t a = 0; a < arrays.size(); a++)
+  {
+    ctx->GetPool()->Submit([&, a]() {
+      for (size_t i = 0; i < requests.size(); i++)
+      {
+        if (requests[i].Array == arrays[a])
+        {
+          filters[a]->SetValue(0, requests[i].Value);
+          if (!ContourAndWrite(filters[a], outputFiles[i], encoding, compression))
+          {
+            ok = false;
+          }
+        }
+      }
+    });
+  }
+  ctx->GetPool()->Wait();
+
+  return ok ? 0 : EXIT_FAILURE;
+}
+
+/*
+ * The version 1 command's requests: the selected fields at their fixed
+ * isovalues, each to its fixed result file.
+ */
+void GetFieldRequests(const char* const resultFiles[3], bool v02, bool v03, bool tev,
+  std::vector<ContourRequest>* requests, std::vector<const char*>* outputFiles)
+{
+  const bool fields[3] = { v02, v03, tev };
+  for (int i = 0; i < 3; i++)
+  {
+    if (fields[i])
+    {
+      requests->push_back(FieldRequests[i]);
+      outputFiles->push_back(resultFiles[i]);
+    }
+  }
+}
+
+/*
+ * Runs requests through the result cache: those it holds are answered from
+ * it and dropped, the results of the others are cached once computed.
+ */
+int RunCached(OffloadContext* ctx, ResultCache* cache, const char* inputFile,
+  const std::vector<ContourRequest>& requests, const std::vector<const char*>& outputFiles,
+  MeshEncoding encoding, int compression, bool fused, bool span)
+{
+  const char* const engine = span ? "span" : fused ? "fused" : "filter";
+  std::vector<ContourRequest> missed;
+  std::vector<const char*> missedFiles;
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    std::string key = MakeResultKey(
+      inputFile, requests[i].Array, requests[i].Value, engine, encoding, compression);
+    if (!key.empty() && cache->Serve(key, outputFiles[i]))
+    {
+      std::cout << requests[i].Array << "-cache: hit" << std::endl;
+      continue;
+    }
+    missed.push_back(requests[i]);
+    missedFiles.push_back(outputFiles[i]);
+    keys.push_back(key);
+  }
+  std::vector<ResultStamp> stamps;
+  for (const char* missedFile : missedFiles)
+  {
+    stamps.push_back(GetResultStamp(missedFile));
+  }
+  int rc = 0;
+  if (!missed.empty() || requests.empty())
+  {
+    rc = Run(ctx, inputFile, missed, missedFiles, encoding, compression, fused, span);
+  }
+  for (size_t i = 0; i < missed.size() && rc == 0; i++)
+  {
+    cache->Store(keys[i], missedFiles[i], stamps[i]);
+  }
+  cache->Print(std::cout);
+  return rc;
+}
+
+/*
+ * Answers a version 2 command, query by query. A query's engine is fused,
+ * span (over the fused pass), filter, or default for the server's own flags.
+ * Returns nonzero if any query failed; the others are answered regardless.
+ */
+int RunBatch(OffloadContext* ctx, ResultCache* cache, const std::vector<PushdownQuery>& queries,
+  const std::string& resultDir, bool fused, bool span)
+{
+  int failed = 0;
+  for (const PushdownQuery& query : queries)
+  {
+    bool queryFused = fused, querySpan = span;
+    if (query.Engine == "fused" || query.Engine == "span")
+    {
+      queryFused = true;
+      querySpan = query.Engine == "span";
+    }
+    else if (query.Engine == "filter")
+    {
+      queryFused = querySpan = false;
+    }
+    else if (query.Engine != "default")
+    {
+      std::cerr << "Unknown engine in query " << query.Name << ": " << query.Engine << std::endl;
+      failed++;
+      continue;
+    }
+    std::vector<ContourRequest> requests;
+    std::vector<std::string> resultFiles;
+    GetQueryRequests(query, resultDir, &requests, &resultFiles);
+    std::vector<const char*> outputFiles;
+    for (const std::string& resultFile : resultFiles)
+    {
+      outputFiles.push_back(resultFile.c_str());
+    }
+    auto t0 = std::chrono::high_resolution_clock::now();
+    int rc = cache->IsEnabled()
+      ? RunCached(ctx, cache, query.InputFile.c_str(), requests, outputFiles, query.Encoding,
+          query.Compression, queryFused, querySpan)
+      : Run(ctx, query.InputFile.c_str(), requests, outputFiles, query.Encoding,
+          query.Compression, queryFused, querySpan);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "query-" << query.Name << ": " << std::chrono::duration<double>(t1 - t0).count()
+              << std::endl;
+    if (rc != 0)
+    {
+      std::cerr << "Query " << query.Name << " failed (" << rc << ")" << std::endl;
+      failed++;
+    }
+  }
+  std::cout << "batch-queries: " << queries.size() << std::endl;
+  return failed ? EXIT_FAILURE : 0;
+}
+
+/*
+ * Usage: [-w | -u | -q] [-p workers [-P fifo|sjf]] [-f] [-x] [-c cache-MiB]
+ *        command_file result_file1 result_file2 result_file3
+ *   -w: keep running and answer every rewrite of command_file
+ *   -u: keep running and accept commands on the unix socket command_file
+ *   -q: keep running and answer the commands clients spool into the
+ *       directory command_file (see ServeSpool())
+ *   -p: answer up to this many socket or spool requests concurrently, each
+ *       worker with its own warm reader
+ *   -P: which queued request a free worker takes: the oldest (fifo, the
+ *       default) or the one with the least input to contour (sjf)
+ *   -f: contour all requested fields in a single pass over the grid
+ *   -x: contour only the active cells, found with the grid's span index
+ *       (<input>.span, built and saved on first use if missing)
+ *   -c: keep up to this many MiB of results in memory and answer repeated
+ *       queries on unchanged inputs from them
+ * A version 1 command is "input_file v02 v03 tev compression [encoding]";
+ * version 2 batches are described in PushdownProtocol.h, their results are
+ * written next to result_file1. Only version 2 commands with a request id
+ * keep the results of concurrent requests apart.
  */
 int main(int argc, char* argv[])
 {
-  if (argc < 5)
+  bool watch = false, useSocket = false, spool = false, fused = false, span = false;
+  ResultCache cache;
+  ServePool pool;
+  pool.Workers = 0;
+  pool.EstimateCost = EstimateCommandCost;
+  pool.MatchRequestId = MatchesRequestId;
+  int c;
+  while ((c = getopt(argc, argv, "wuqp:P:fxc:")) != -1)
   {
-    exit(EXIT_FAILURE);
+    switch (c)
+    {
+      case 'q':
+        spool = true;
+        break;
+      case 'p':
+        pool.Workers = atoi(optarg);
+        break;
+      case 'P':
+        if (!ParseSchedulePolicy(optarg, &pool.Policy))
+        {
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'c':
+        cache.SetBudget(static_cast<size_t>(atol(optarg)) << 20);
+        break;
+      case 'f':
+        fused = true;
+        break;
+      case 'x':
+        span = true;
+        break;
+      case 'w':
+        watch = true;
+        break;
+      case 'u':
+        useSocket = true;
+        break;
+      default:
+        exit(EXIT_FAILURE);
+    }
   }
-  std::ifstream input(argv[1] /* command file */);
-  std::string fileName;
-  bool v02, v03, tev;
-  int compression;
-  input >> fileName >> v02 >> v03 >> tev >> compression;
-  if (!input.good())
+  argc -= optind;
+  argv += optind;
+  if (argc < 4)
   {
     exit(EXIT_FAILURE);
   }
-  return Run(
-    fileName.c_str(), argv[2], argv[3], argv[4] /* result files */, v02, v03, tev, compression);
+  const char* commandFile = argv[0];
+  const char* const resultFiles[3] = { argv[1], argv[2], argv[3] };
+
+  // One context per worker: readers and filters are not shared between
+  // concurrent requests. The cores are split between the workers' pools
+  std::vector<std::unique_ptr<OffloadContext>> contexts(std::max(pool.Workers, 1));
+  const int threads = contexts.size() > 1
+    ? std::max(1, static_cast<int>(std::thread::hardware_concurrency() / contexts.size()))
+    : 0;
+  for (std::unique_ptr<OffloadContext>& context : contexts)
+  {
+    context.reset(new OffloadContext(threads));
+  }
+  const std::filesystem::path resultPath(resultFiles[0]);
+  const std::string resultDir =
+    resultPath.has_parent_path() ? resultPath.parent_path().string() : ".";
+  PooledQueryHandler handler = [&](const std::string& command, int worker) {
+    OffloadContext& ctx = *contexts[worker];
+    if (IsBatchCommand(command))
+    {
+      std::vector<PushdownQuery> queries;
+      std::string requestId;
+      if (!ParseBatchCommand(command, &queries, &requestId))
+      {
+        return EXIT_FAILURE;
+      }
+      const std::string requestDir = GetRequestResultDir(resultDir, requestId);
+      std::error_code ec;
+      std::filesystem::create_directories(requestDir, ec);
+      return RunBatch(&ctx, &cache, queries, requestDir, fused, span);
+    }
+    std::istringstream input(command);
+    std::string fileName;
+    bool v02, v03, tev;
+    int compression;
+    input >> fileName >> v02 >> v03 >> tev >> compression;
+    if (input.fail())
+    {
+      return EXIT_FAILURE;
+    }
+    int value = 0; // Optional, older runners only send the fields above
+    input >> value;
+    MeshEncoding encoding;
+    if (!GetMeshEncoding(value, &encoding))
+    {
+      std::cerr << "Unknown encoding " << value << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::vector<ContourRequest> requests;
+    std::vector<const char*> outputFiles;
+    GetFieldRequests(resultFiles, v02, v03, tev, &requests, &outputFiles);
+    if (cache.IsEnabled())
+    {
+      return RunCached(
+        &ctx, &cache, fileName.c_str(), requests, outputFiles, encoding, compression, fused, span);
+    }
+    return Run(&ctx, fileName.c_str(), requests, outputFiles, encoding, compression, fused, span);
+  };
+  if (spool)
+  {
+    return ServeSpool(commandFile, handler, pool);
+  }
+  if (useSocket && pool.Workers > 0)
+  {
+    return ServeSocketPool(commandFile, handler, pool);
+  }
+  QueryHandler single = [&](const std::string& command) { return handler(command, 0); };
+  if (useSocket)
+  {
+    return ServeSocket(commandFile, single);
+  }
+  if (watch)
+  {
+    return ServeWatch(commandFile, single);
+  }
+  return ServeOnce(commandFile, single);
 }
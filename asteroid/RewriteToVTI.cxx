@@ -32,30 +32,53 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "BrickedVolume.h"
+#include "MultiBlockContour.h"
+#include "RawImageWriter.h"
+#include "SlabResampler.h"
+
 #include <vtkDataArraySelection.h>
+#include <vtkDataSet.h>
+#include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkResampleToImage.h>
 #include <vtkXMLImageDataWriter.h>
 #include <vtkXMLMultiBlockDataReader.h>
 
+#include <chrono>
 #include <filesystem>
 #include <getopt.h>
 #include <iostream>
+#include <stdio.h>
 #include <stdlib.h>
 
 int main(int argc, char* argv[])
 {
-  int size = 750;
+  int size[3] = { 750, 750, 750 };
+  int brickSize = 0;
+  int slabDepth = 0;
   int c;
-  while ((c = getopt(argc, argv, "s:")) != -1)
+  while ((c = getopt(argc, argv, "s:b:z:")) != -1)
   {
     switch (c)
     {
       case 's':
-        size = atoi(optarg);
+        if (!ParseDimensions(optarg, size))
+        {
+          std::cerr << "Bad image size " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'b': /* write bricks of this many cells per side instead of one image */
+        brickSize = atoi(optarg);
+        break;
+      case 'z': /* resample and write this many z-planes at a time */
+        slabDepth = atoi(optarg);
         break;
       default:
-        std::cerr << "Use -s to specify image size" << std::endl;
+        std::cerr << "Use -s to specify image size (N or NxMxK), -b to specify brick size and "
+                     "-z to resample in slabs of that many z-planes"
+                  << std::endl;
         exit(EXIT_FAILURE);
     }
   }
@@ -68,7 +91,36 @@ int main(int argc, char* argv[])
   }
   std::cout << "vtk file: " << argv[0] << std::endl;
   std::cout << "array: v02,v03,tev" << std::endl;
-  std::cout << "result image size: " << size << "x" << size << "x" << size << std::endl;
+  std::cout << "result image size: " << size[0] << "x" << size[1] << "x" << size[2] << std::endl;
+  std::filesystem::path stem = std::filesystem::path(argv[0]).stem();
+  char tmp[100];
+  if (slabDepth > 0)
+  {
+    if (brickSize > 0)
+    {
+      std::cerr << "Slabs (-z) only write a .vti, not bricks (-b)" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::cout << "slab depth: " << slabDepth << std::endl;
+    std::vector<vtkSmartPointer<vtkDataSet>> blocks =
+      ReadMultiBlock(argv[0], { "v02", "v03", "tev" });
+    snprintf(tmp, sizeof(tmp), "%s.vti", stem.c_str());
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (blocks.empty() ||
+      !ResampleToImageSlabs(blocks, { "v02", "v03", "tev" }, size, slabDepth, tmp))
+    {
+      exit(EXIT_FAILURE);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "resample: " << std::chrono::duration<double>(t1 - t0).count() << std::endl;
+    std::error_code ec;
+    std::cout << "output-bytes: " << std::filesystem::file_size(tmp, ec) << std::endl;
+    return 0;
+  }
+  if (brickSize > 0)
+  {
+    std::cout << "brick size: " << brickSize << std::endl;
+  }
   vtkNew<vtkXMLMultiBlockDataReader> mbr;
   mbr->SetFileName(argv[0]);
   mbr->UpdateInformation();
@@ -80,17 +132,34 @@ int main(int argc, char* argv[])
 
   vtkNew<vtkResampleToImage> r2i;
   r2i->SetInputConnection(mbr->GetOutputPort());
-  r2i->SetSamplingDimensions(size, size, size);
+  r2i->SetSamplingDimensions(size[0], size[1], size[2]);
+
+  // Timed separately so the cost of resampling can be set against contouring
+  // the blocks directly (BaselineRunner/Offloader on the .vtm)
+  auto t0 = std::chrono::high_resolution_clock::now();
+  r2i->Update();
+  auto t1 = std::chrono::high_resolution_clock::now();
+  std::cout << "resample: " << std::chrono::duration<double>(t1 - t0).count() << std::endl;
+
+  if (brickSize > 0)
+  {
+    snprintf(tmp, sizeof(tmp), "%s.brk", stem.c_str());
+    if (!WriteBrickedVolume(r2i->GetOutput(), { "v02", "v03", "tev" }, brickSize, tmp))
+    {
+      exit(EXIT_FAILURE);
+    }
+    return 0;
+  }
 
   vtkNew<vtkXMLImageDataWriter> writer;
   writer->SetInputConnection(r2i->GetOutputPort());
   writer->SetCompressorTypeToNone();
   writer->EncodeAppendedDataOff();
-  std::filesystem::path stem = std::filesystem::path(argv[0]).stem();
-  char tmp[100];
   snprintf(tmp, sizeof(tmp), "%s.vti", stem.c_str());
   writer->SetFileName(tmp);
   writer->Update();
+  std::error_code ec;
+  std::cout << "output-bytes: " << std::filesystem::file_size(tmp, ec) << std::endl;
 
   return 0;
 }
@@ -32,57 +32,493 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <vtkAppendDataSets.h>
+#include "BenchStats.h"
+#include "FusedContour.h"
+#include "PartitionedGrid.h"
+#include "SpanIndex.h"
+#include "SpatialOrder.h"
+#include "ThreadPool.h"
+
+#include <vtkCellArray.h>
 #include <vtkCellData.h>
 #include <vtkCellDataToPointData.h>
+#include <vtkDataArray.h>
 #include <vtkDataArraySelection.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
 #include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkXMLUnstructuredGridReader.h>
 #include <vtkXMLUnstructuredGridWriter.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <getopt.h>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
+#include <vector>
+
+const int NumberOfPieces = 512;
+const int NumberOfArrays = 3;
+const char* const Arrays[NumberOfArrays] = { "v02", "v03", "tev" };
 
-void Append(vtkAppendDataSets* dst, const std::string& path, int i)
+std::string GetPiecePath(const std::string& dir, const std::string& name, int i)
+{
+  char tmp[100];
+  snprintf(tmp, sizeof(tmp), "/%s_0_%d.vtu", name.c_str(), i);
+  return dir + tmp;
+}
+
+/*
+ * Reads one piece with only the converted cell arrays. Returns nullptr on
+ * failure.
+ */
+vtkSmartPointer<vtkUnstructuredGrid> LoadPiece(const std::string& path)
 {
   vtkNew<vtkXMLUnstructuredGridReader> reader;
   reader->SetFileName(path.c_str());
   reader->UpdateInformation();
   vtkDataArraySelection* sel = reader->GetCellDataArraySelection();
   sel->DisableAllArrays();
-  sel->EnableArray("v02");
-  sel->EnableArray("v03");
-  sel->EnableArray("tev");
+  for (const char* array : Arrays)
+  {
+    sel->EnableArray(array);
+  }
+  reader->GetPointDataArraySelection()->DisableAllArrays();
   reader->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> piece = reader->GetOutput();
+  if (!piece || piece->GetNumberOfCells() == 0)
+  {
+    std::cerr << "Cannot read piece " << path << std::endl;
+    return nullptr;
+  }
+  return piece;
+}
+
+/*
+ * Merges pieces into one grid as they arrive, so each piece can be released
+ * right after. Points shared by pieces are merged through a hash table on
+ * their exact coordinates, and cell data is converted to point data on the
+ * fly by accumulating, per output point, the values of every cell using it:
+ * the same average vtkCellDataToPointData takes, but across piece
+ * boundaries, and without the whole cell-data grid ever being in memory.
+ */
+class GridMerger
+{
+public:
+  bool Add(vtkUnstructuredGrid* piece);
+  vtkSmartPointer<vtkUnstructuredGrid> Finish();
+
+private:
+  vtkIdType FindOrInsertPoint(const double x[3]);
+  void Rehash(size_t size);
+  static size_t Hash(const double x[3]);
+
+  vtkNew<vtkDoubleArray> Coords; // Exact for float pieces too
+  int PointType = 0;              // Of the first piece, kept in the output
+  std::vector<vtkIdType> Table;   // Open addressing over point ids, -1 if empty
+  vtkIdType NumberOfPoints = 0;
+  vtkNew<vtkCellArray> Cells;
+  vtkNew<vtkUnsignedCharArray> Types;
+  std::vector<double> Sums[NumberOfArrays];
+  std::vector<uint32_t> Counts;
+  int ValueTypes[NumberOfArrays] = {};
+};
 
-  if (i == 0)
+size_t GridMerger::Hash(const double x[3])
+{
+  uint64_t h = 0;
+  for (int c = 0; c < 3; c++)
   {
-    dst->SetInputData(reader->GetOutput());
+    const double v = x[c] == 0 ? 0 : x[c]; // -0 and 0 are the same point
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    h ^= bits + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  }
+  h ^= h >> 31;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  return static_cast<size_t>(h ^ (h >> 29));
+}
+
+void GridMerger::Rehash(size_t size)
+{
+  this->Table.assign(size, -1);
+  const double* coords = this->Coords->GetPointer(0);
+  for (vtkIdType id = 0; id < this->NumberOfPoints; id++)
+  {
+    size_t slot = Hash(coords + 3 * id) & (size - 1);
+    while (this->Table[slot] >= 0)
+    {
+      slot = (slot + 1) & (size - 1);
+    }
+    this->Table[slot] = id;
+  }
+}
+
+vtkIdType GridMerger::FindOrInsertPoint(const double x[3])
+{
+  if (2 * static_cast<size_t>(this->NumberOfPoints + 1) > this->Table.size())
+  {
+    this->Rehash(std::max<size_t>(1 << 20, 2 * this->Table.size()));
+  }
+  const size_t mask = this->Table.size() - 1;
+  for (size_t slot = Hash(x) & mask;; slot = (slot + 1) & mask)
+  {
+    const vtkIdType id = this->Table[slot];
+    if (id < 0)
+    {
+      this->Table[slot] = this->NumberOfPoints;
+      this->Coords->InsertNextTypedTuple(x);
+      for (std::vector<double>& sums : this->Sums)
+      {
+        sums.push_back(0);
+      }
+      this->Counts.push_back(0);
+      return this->NumberOfPoints++;
+    }
+    const double* p = this->Coords->GetPointer(3 * id);
+    if (p[0] == x[0] && p[1] == x[1] && p[2] == x[2])
+    {
+      return id;
+    }
+  }
+}
+
+bool GridMerger::Add(vtkUnstructuredGrid* piece)
+{
+  vtkDataArray* values[NumberOfArrays];
+  for (int a = 0; a < NumberOfArrays; a++)
+  {
+    values[a] = piece->GetCellData()->GetArray(Arrays[a]);
+    if (!values[a])
+    {
+      std::cerr << "Piece lacks cell array " << Arrays[a] << std::endl;
+      return false;
+    }
+    if (!this->ValueTypes[a])
+    {
+      this->ValueTypes[a] = values[a]->GetDataType();
+    }
+  }
+  if (this->Coords->GetNumberOfComponents() != 3)
+  {
+    this->Coords->SetNumberOfComponents(3);
+  }
+  if (!this->PointType)
+  {
+    this->PointType = piece->GetPoints()->GetDataType();
+  }
+
+  const vtkIdType numPoints = piece->GetNumberOfPoints();
+  std::vector<vtkIdType> remap(numPoints);
+  double x[3];
+  for (vtkIdType i = 0; i < numPoints; i++)
+  {
+    piece->GetPoint(i, x);
+    remap[i] = this->FindOrInsertPoint(x);
+  }
+
+  vtkNew<vtkIdList> ptIds;
+  std::vector<vtkIdType> cell;
+  for (vtkIdType cellId = 0; cellId < piece->GetNumberOfCells(); cellId++)
+  {
+    const int type = piece->GetCellType(cellId);
+    if (type == VTK_POLYHEDRON)
+    {
+      std::cerr << "Polyhedral cells are not supported" << std::endl;
+      return false;
+    }
+    piece->GetCellPoints(cellId, ptIds);
+    const vtkIdType npts = ptIds->GetNumberOfIds();
+    cell.resize(npts);
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      cell[i] = remap[ptIds->GetId(i)];
+      this->Counts[cell[i]]++;
+    }
+    this->Cells->InsertNextCell(npts, cell.data());
+    this->Types->InsertNextValue(static_cast<unsigned char>(type));
+    for (int a = 0; a < NumberOfArrays; a++)
+    {
+      const double v = values[a]->GetComponent(cellId, 0);
+      for (vtkIdType id : cell)
+      {
+        this->Sums[a][id] += v;
+      }
+    }
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> GridMerger::Finish()
+{
+  // Like vtkAppendDataSets, keep the pieces' point precision, so float
+  // inputs are not rewritten with twice the bytes per point
+  vtkNew<vtkPoints> points;
+  if (this->PointType && this->PointType != VTK_DOUBLE)
+  {
+    points->SetDataType(this->PointType);
+    points->GetData()->DeepCopy(this->Coords);
+    this->Coords->Initialize();
   }
   else
   {
-    dst->AddInputData(reader->GetOutput());
+    points->SetData(this->Coords);
+  }
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->SetCells(this->Types, this->Cells);
+  std::vector<vtkIdType>().swap(this->Table);
+  for (int a = 0; a < NumberOfArrays; a++)
+  {
+    vtkSmartPointer<vtkDataArray> array =
+      vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(this->ValueTypes[a]));
+    array->SetName(Arrays[a]);
+    array->SetNumberOfTuples(this->NumberOfPoints);
+    for (vtkIdType id = 0; id < this->NumberOfPoints; id++)
+    {
+      const uint32_t count = this->Counts[id];
+      array->SetTuple1(id, count ? this->Sums[a][id] / count : 0);
+    }
+    std::vector<double>().swap(this->Sums[a]);
+    grid->GetPointData()->AddArray(array);
+  }
+  std::vector<uint32_t>().swap(this->Counts);
+  return grid;
+}
+
+void ConfigureWriter(vtkXMLUnstructuredGridWriter* writer, int gzip)
+{
+  if (gzip)
+  {
+    writer->SetCompressorTypeToZLib();
+    writer->SetHeaderTypeToUInt32(); // int32 is okay
+  }
+  else
+  {
+    writer->SetCompressorTypeToNone();
+    writer->SetHeaderTypeToUInt64();
+  }
+  writer->EncodeAppendedDataOff();
+}
+
+/*
+ * Partitioned output: converts every piece on its own, one pool task per
+ * piece, and writes it as <name>_parts/<name>_<i>.vtu, listed with its bounds
+ * and value ranges in the <name>.parts manifest.
+ */
+int WritePartitioned(
+  const std::string& dir, const std::string& name, int gzip, SpaceFillingCurve curve)
+{
+  const std::string partsDir = name + "_parts";
+  std::filesystem::create_directories(partsDir);
+  PartitionManifest manifest;
+  manifest.Arrays.assign(Arrays, Arrays + NumberOfArrays);
+  manifest.Pieces.resize(NumberOfPieces);
+  std::vector<char> failed(NumberOfPieces);
+  ThreadPool pool;
+  std::cout << "Converting " << NumberOfPieces << " pieces on " << pool.GetNumberOfThreads()
+            << " threads..." << std::endl;
+  for (int i = 0; i < NumberOfPieces; i++)
+  {
+    pool.Submit([&, i]() {
+      vtkSmartPointer<vtkUnstructuredGrid> input = LoadPiece(GetPiecePath(dir, name, i));
+      if (!input)
+      {
+        failed[i] = 1;
+        return;
+      }
+      vtkNew<vtkCellDataToPointData> c2p;
+      c2p->SetInputData(input);
+      c2p->Update();
+      vtkSmartPointer<vtkUnstructuredGrid> piece = c2p->GetUnstructuredGridOutput();
+      if (curve != SpaceFillingCurve::None)
+      {
+        piece = ReorderGrid(piece, curve);
+        if (!piece)
+        {
+          failed[i] = 1;
+          return;
+        }
+      }
+
+      PartitionManifest::Piece& entry = manifest.Pieces[i];
+      const std::string path = GetPiecePath(dir, name, i);
+      entry.File = partsDir + "/" + std::filesystem::path(path).filename().string();
+      piece->GetBounds(entry.Bounds);
+      for (const char* array : Arrays)
+      {
+        double range[2] = { 0, -1 }; // Empty, so never active, if the piece lacks it
+        if (vtkDataArray* values = piece->GetPointData()->GetArray(array))
+        {
+          values->GetRange(range, 0);
+        }
+        entry.Ranges.push_back(range[0]);
+        entry.Ranges.push_back(range[1]);
+      }
+
+      vtkNew<vtkXMLUnstructuredGridWriter> writer;
+      writer->SetInputData(piece);
+      writer->SetFileName(entry.File.c_str());
+      ConfigureWriter(writer, gzip);
+      if (!writer->Write())
+      {
+        failed[i] = 1;
+      }
+    });
+  }
+  pool.Wait();
+  if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+  {
+    return 1;
+  }
+  const std::string manifestFile = name + ".parts";
+  std::cout << "Writing manifest " << manifestFile << "..." << std::endl;
+  if (!WritePartitionManifest(manifest, manifestFile.c_str()))
+  {
+    return 1;
+  }
+  std::cout << "Done!" << std::endl;
+  return 0;
+}
+
+/*
+ * Merged output: pieces are read in parallel, a bounded number ahead, and
+ * merged in order as they arrive.
+ */
+vtkSmartPointer<vtkUnstructuredGrid> MergePieces(const std::string& dir, const std::string& name)
+{
+  ThreadPool pool;
+  const int window = 2 * pool.GetNumberOfThreads();
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid>> pieces(NumberOfPieces);
+  std::vector<char> loaded(NumberOfPieces);
+  std::mutex mutex;
+  std::condition_variable ready;
+  auto load = [&](int i) {
+    pool.Submit([&, i]() {
+      vtkSmartPointer<vtkUnstructuredGrid> piece = LoadPiece(GetPiecePath(dir, name, i));
+      std::lock_guard<std::mutex> lock(mutex);
+      pieces[i] = piece;
+      loaded[i] = 1;
+      ready.notify_all();
+    });
+  };
+  for (int i = 0; i < std::min(window, NumberOfPieces); i++)
+  {
+    load(i);
+  }
+
+  GridMerger merger;
+  bool ok = true;
+  for (int i = 0; i < NumberOfPieces && ok; i++)
+  {
+    vtkSmartPointer<vtkUnstructuredGrid> piece;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [&]() { return loaded[i] != 0; });
+      piece = pieces[i];
+      pieces[i] = nullptr;
+    }
+    if (i + window < NumberOfPieces)
+    {
+      load(i + window);
+    }
+    std::cout << "Merging piece " << i << " ..." << std::endl;
+    ok = piece && merger.Add(piece);
+  }
+  pool.Wait();
+  return ok ? merger.Finish() : nullptr;
+}
+
+/*
+ * Contours the three fields the runners use with one fused pass, the way
+ * asteroid/Offloader does, and reports "contour-<label>" time along with
+ * cache counters when the PMU is accessible.
+ */
+void BenchmarkContour(vtkUnstructuredGrid* grid, const char* label)
+{
+  const std::vector<ContourRequest> requests(std::begin(FieldRequests), std::end(FieldRequests));
+  FusedContour(grid, requests); // Warm up, so both orders start from the same cache state
+  CacheCounters counters;
+  counters.Start();
+  auto t0 = std::chrono::high_resolution_clock::now();
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes = FusedContour(grid, requests);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  counters.Stop();
+  vtkIdType triangles = 0;
+  for (vtkPolyData* mesh : meshes)
+  {
+    triangles += mesh->GetNumberOfCells();
+  }
+  std::cout << "contour-" << label << ": " << std::chrono::duration<double>(t1 - t0).count()
+            << std::endl;
+  std::cout << "triangles-" << label << ": " << triangles << std::endl;
+  if (counters.IsAvailable())
+  {
+    std::cout << "cache-references-" << label << ": " << counters.GetReferences() << std::endl;
+    std::cout << "cache-misses-" << label << ": " << counters.GetMisses() << std::endl;
+  }
+  else
+  {
+    std::cout << "cache-misses-" << label << ": n/a" << std::endl;
   }
 }
 
 int main(int argc, char* argv[])
 {
   int gzip = 1;
+  int span = 1;
+  bool partitioned = false;
+  bool benchmark = false;
+  SpaceFillingCurve curve = SpaceFillingCurve::None;
   int c;
-  while ((c = getopt(argc, argv, "z:h")) != -1)
+  while ((c = getopt(argc, argv, "z:x:o:pbh")) != -1)
   {
     switch (c)
     {
       case 'z':
         gzip = atoi(optarg);
         break;
+      case 'x':
+        span = atoi(optarg);
+        break;
+      case 'o':
+        if (!ParseSpaceFillingCurve(optarg, &curve))
+        {
+          std::cerr << "Unknown order " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'p':
+        partitioned = true;
+        break;
+      case 'b':
+        benchmark = true;
+        break;
       case 'h':
       default:
         std::cerr << "Use -z=0/1 to disable/enable gzip compression" << std::endl;
+        std::cerr << "Use -x=0/1 to disable/enable the span index sidecar" << std::endl;
+        std::cerr << "Use -p to keep the pieces as partitions instead of merging them"
+                  << std::endl;
+        std::cerr << "Use -o=none/morton/hilbert to sort points and cells along a curve"
+                  << std::endl;
+        std::cerr << "Use -b to only benchmark contouring before/after reordering (default "
+                     "hilbert) without writing anything"
+                  << std::endl;
         exit(EXIT_FAILURE);
     }
   }
@@ -96,41 +532,64 @@ int main(int argc, char* argv[])
   std::string dir = argv[0];
   std::cout << "Converting " << dir << "..." << std::endl;
   std::filesystem::path filename = std::filesystem::path(dir.c_str()).filename();
-  vtkNew<vtkAppendDataSets> dst;
-  char tmp[100];
-  for (int i = 0; i < 512; i++)
+  if (partitioned)
+  {
+    return WritePartitioned(dir, filename.string(), gzip, curve);
+  }
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MergePieces(dir, filename.string());
+  if (!grid)
   {
-    snprintf(tmp, sizeof(tmp), "/%s_0_%d.vtu", filename.c_str(), i);
-    std::string path = dir + tmp;
-    std::cout << "Loading " << tmp + 1 << " ..." << std::endl;
-    Append(dst.Get(), path, i);
+    return 1;
   }
-  std::cout << "Processing (gz=" << gzip << ")..." << std::endl;
-  dst->Update();
-  vtkUnstructuredGrid* const grid = dst->GetUnstructuredGridOutput();
   std::cout << "Num of points: " << grid->GetNumberOfPoints() << std::endl;
   std::cout << "Num of cells: " << grid->GetNumberOfCells() << std::endl;
-  std::cout << "Applying filters..." << std::endl;
-  vtkNew<vtkCellDataToPointData> c2p;
-  c2p->SetInputData(grid);
-  c2p->Update();
-  snprintf(tmp, sizeof(tmp), "%s.vtu", filename.c_str());
-  std::cout << "Dumping data to " << tmp << "..." << std::endl;
-  vtkNew<vtkXMLUnstructuredGridWriter> writer;
-  writer->SetInputConnection(c2p->GetOutputPort());
-  writer->SetFileName(tmp);
-  if (gzip)
+  if (benchmark && curve == SpaceFillingCurve::None)
   {
-    writer->SetCompressorTypeToZLib();
-    writer->SetHeaderTypeToUInt32(); // int32 is okay
+    curve = SpaceFillingCurve::Hilbert;
   }
-  else
+  if (curve != SpaceFillingCurve::None)
   {
-    writer->SetCompressorTypeToNone();
-    writer->SetHeaderTypeToUInt64();
+    std::cout << "Reordering along " << GetSpaceFillingCurveName(curve) << " curve..."
+              << std::endl;
+    vtkSmartPointer<vtkUnstructuredGrid> reordered = ReorderGrid(grid, curve);
+    if (!reordered)
+    {
+      return 1;
+    }
+    if (benchmark)
+    {
+      BenchmarkContour(grid, "original");
+      BenchmarkContour(reordered, GetSpaceFillingCurveName(curve));
+      std::cout << "peak-rss-kb: " << GetPeakRSS() << std::endl;
+      return 0;
+    }
+    grid = reordered;
   }
-  writer->EncodeAppendedDataOff();
+  char tmp[100];
+  snprintf(tmp, sizeof(tmp), "%s.vtu", filename.c_str());
+  std::cout << "Dumping data to " << tmp << " (gz=" << gzip << ")..." << std::endl;
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetInputData(grid);
+  writer->SetFileName(tmp);
+  ConfigureWriter(writer, gzip);
   writer->Update();
+  if (span)
+  {
+    std::string spanFile = std::string(tmp) + ".span";
+    std::cout << "Indexing to " << spanFile << "..." << std::endl;
+    SpanIndex index;
+    for (const char* array : Arrays)
+    {
+      if (!AddSpanIndexArray(grid, array, &index))
+      {
+        return 1;
+      }
+    }
+    if (!WriteSpanIndex(index, spanFile.c_str()))
+    {
+      return 1;
+    }
+  }
   std::cout << "Done!" << std::endl;
   return 0;
 }
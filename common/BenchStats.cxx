@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BenchStats.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+int OpenCacheCounter(unsigned long long config)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+long long ReadCounter(int fd)
+{
+  long long value;
+  if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value))
+  {
+    return -1;
+  }
+  return value;
+}
+}
+
+void LatencyStats::Add(double seconds)
+{
+  this->Samples.push_back(seconds);
+}
+
+void LatencyStats::Print(std::ostream& os, const char* prefix) const
+{
+  os << prefix << "-count: " << this->Samples.size() << std::endl;
+  if (this->Samples.empty())
+  {
+    return;
+  }
+  std::vector<double> sorted = this->Samples;
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0;
+  for (double s : sorted)
+  {
+    sum += s;
+  }
+  const size_t n = sorted.size();
+  os << prefix << "-mean: " << sum / n << std::endl
+     << prefix << "-min: " << sorted.front() << std::endl
+     << prefix << "-p50: " << sorted[(n - 1) / 2] << std::endl
+     << prefix << "-p95: " << sorted[(n - 1) * 95 / 100] << std::endl
+     << prefix << "-max: " << sorted.back() << std::endl;
+}
+
+double LatencyStats::GetPercentile(double percent) const
+{
+  if (this->Samples.empty())
+  {
+    return 0;
+  }
+  std::vector<double> sorted = this->Samples;
+  const size_t n = sorted.size();
+  const size_t k = std::min(static_cast<size_t>((n - 1) * percent / 100), n - 1);
+  std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+  return sorted[k];
+}
+
+long GetPeakRSS()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return -1;
+  }
+  return usage.ru_maxrss;
+}
+
+bool GetIOCounters(IOCounters* counters)
+{
+  std::ifstream input("/proc/self/io");
+  std::string key;
+  long long value;
+  bool found = false;
+  while (input >> key >> value)
+  {
+    if (key == "rchar:")
+    {
+      counters->ReadChars = value;
+      found = true;
+    }
+    else if (key == "read_bytes:")
+    {
+      counters->StorageBytes = value;
+    }
+  }
+  return found;
+}
+
+CacheCounters::CacheCounters()
+{
+  this->References = OpenCacheCounter(PERF_COUNT_HW_CACHE_REFERENCES);
+  this->Misses = OpenCacheCounter(PERF_COUNT_HW_CACHE_MISSES);
+}
+
+CacheCounters::~CacheCounters()
+{
+  for (int fd : { this->References, this->Misses })
+  {
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+  }
+}
+
+void CacheCounters::Start()
+{
+  for (int fd : { this->References, this->Misses })
+  {
+    if (fd >= 0)
+    {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void CacheCounters::Stop()
+{
+  for (int fd : { this->References, this->Misses })
+  {
+    if (fd >= 0)
+    {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+}
+
+long long CacheCounters::GetReferences() const
+{
+  return ReadCounter(this->References);
+}
+
+long long CacheCounters::GetMisses() const
+{
+  return ReadCounter(this->Misses);
+}
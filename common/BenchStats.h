@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BenchStats_h
+#define BenchStats_h
+
+#include <ostream>
+#include <vector>
+
+/*
+ * Collects per-query latencies of a long-running process so they can be
+ * reported separately from one-shot timings.
+ */
+class LatencyStats
+{
+public:
+  void Add(double seconds);
+  size_t GetCount() const { return this->Samples.size(); }
+
+  /*
+   * Prints "<prefix>-count", "<prefix>-mean", "<prefix>-min", "<prefix>-p50",
+   * "<prefix>-p95" and "<prefix>-max" lines.
+   */
+  void Print(std::ostream& os, const char* prefix) const;
+
+  /*
+   * The sample at the given percentile (0 is the minimum, 100 the maximum),
+   * picked as Print() does. 0 if there are no samples.
+   */
+  double GetPercentile(double percent) const;
+
+private:
+  std::vector<double> Samples;
+};
+
+/*
+ * Peak resident set size of this process so far, in KiB (getrusage).
+ */
+long GetPeakRSS();
+
+/*
+ * I/O of this process so far, from /proc/self/io: bytes requested through
+ * read-like system calls (rchar, page cache hits included) and bytes fetched
+ * from storage (read_bytes). Pages faulted in through mmap count in neither.
+ */
+struct IOCounters
+{
+  long long ReadChars = 0;
+  long long StorageBytes = 0;
+};
+
+/*
+ * Returns false if /proc/self/io cannot be read.
+ */
+bool GetIOCounters(IOCounters* counters);
+
+/*
+ * Hardware cache reference and miss counters (perf_event_open) of the
+ * calling thread and of the threads it starts while counting. Used to compare
+ * the memory behavior of two runs of the same work. Counters are unavailable
+ * (and read as -1) without PMU access, e.g. in most containers or with a
+ * restrictive kernel.perf_event_paranoid.
+ */
+class CacheCounters
+{
+public:
+  CacheCounters();
+  ~CacheCounters();
+
+  bool IsAvailable() const { return this->References >= 0 && this->Misses >= 0; }
+
+  /*
+   * Resets and starts both counters.
+   */
+  void Start();
+  void Stop();
+
+  long long GetReferences() const;
+  long long GetMisses() const;
+
+private:
+  CacheCounters(const CacheCounters&) = delete;
+  void operator=(const CacheCounters&) = delete;
+
+  int References = -1; // perf event fds
+  int Misses = -1;
+};
+
+#endif
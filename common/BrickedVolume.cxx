@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BrickedVolume.h"
+
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace
+{
+struct BrickIndexHeader
+{
+  char Magic[4];
+  uint32_t HeaderSize;
+  int32_t WholeDims[3];
+  int32_t BrickSize;
+  double Origin[3];
+  double Spacing[3];
+  uint32_t NumberOfArrays;
+  uint32_t Reserved;
+  uint64_t NumberOfBricks;
+};
+static_assert(sizeof(BrickIndexHeader) == 88, "Unexpected brick index header layout");
+
+struct BrickRecord
+{
+  int32_t Extent[6];
+  uint64_t Offset;
+};
+static_assert(sizeof(BrickRecord) == 32, "Unexpected brick record layout");
+
+const char BrickIndexMagic[4] = { 'C', 'B', 'I', '1' };
+const size_t ArrayNameSize = 64;
+
+vtkIdType GetNumberOfBrickPoints(const int extent[6])
+{
+  return static_cast<vtkIdType>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1) *
+    (extent[5] - extent[4] + 1);
+}
+
+bool ReadAt(int fd, char* buf, size_t size, uint64_t offset)
+{
+  while (size)
+  {
+    ssize_t n = pread(fd, buf, size, offset);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    buf += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+}
+
+int BrickIndex::FindArray(const std::string& name) const
+{
+  auto it = std::find(this->Arrays.begin(), this->Arrays.end(), name);
+  return it == this->Arrays.end() ? -1 : static_cast<int>(it - this->Arrays.begin());
+}
+
+bool WriteBrickedVolume(vtkImageData* image, const std::vector<std::string>& arrays,
+  int brickSize, const char* fileName)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  std::vector<vtkSmartPointer<vtkFloatArray>> values;
+  for (const std::string& name : arrays)
+  {
+    vtkDataArray* array = image->GetPointData()->GetArray(name.c_str());
+    if (!array || array->GetNumberOfComponents() != 1 || name.size() >= ArrayNameSize)
+    {
+      std::cerr << "Cannot brick point array " << name << std::endl;
+      return false;
+    }
+    vtkSmartPointer<vtkFloatArray> fa = vtkArrayDownCast<vtkFloatArray>(array);
+    if (!fa)
+    {
+      fa = vtkSmartPointer<vtkFloatArray>::New();
+      fa->DeepCopy(array);
+    }
+    values.push_back(fa);
+  }
+
+  int numBricks[3];
+  for (int c = 0; c < 3; c++)
+  {
+    numBricks[c] = std::max((dims[c] - 2) / brickSize + 1, 1);
+  }
+  const std::string indexName = std::string(fileName) + ".idx";
+  std::ofstream data(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  std::ofstream index(indexName, std::ios::out | std::ios::binary | std::ios::trunc);
+
+  BrickIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, BrickIndexMagic, sizeof(header.Magic));
+  header.HeaderSize = sizeof(header);
+  image->GetOrigin(header.Origin);
+  image->GetSpacing(header.Spacing);
+  int extent[6];
+  image->GetExtent(extent);
+  for (int c = 0; c < 3; c++)
+  {
+    header.WholeDims[c] = dims[c];
+    header.Origin[c] += extent[2 * c] * header.Spacing[c];
+  }
+  header.BrickSize = brickSize;
+  header.NumberOfArrays = static_cast<uint32_t>(arrays.size());
+  header.NumberOfBricks = static_cast<uint64_t>(numBricks[0]) * numBricks[1] * numBricks[2];
+  index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const std::string& name : arrays)
+  {
+    char buf[ArrayNameSize] = {};
+    memcpy(buf, name.data(), name.size());
+    index.write(buf, sizeof(buf));
+  }
+
+  uint64_t offset = 0;
+  std::vector<float> brick;
+  std::vector<float> ranges(2 * arrays.size());
+  for (int bz = 0; bz < numBricks[2]; bz++)
+  {
+    for (int by = 0; by < numBricks[1]; by++)
+    {
+      for (int bx = 0; bx < numBricks[0]; bx++)
+      {
+        BrickRecord record;
+        const int b[3] = { bx, by, bz };
+        for (int c = 0; c < 3; c++)
+        {
+          record.Extent[2 * c] = b[c] * brickSize;
+          record.Extent[2 * c + 1] = std::min((b[c] + 1) * brickSize, dims[c] - 1);
+        }
+        record.Offset = offset;
+        brick.resize(GetNumberOfBrickPoints(record.Extent));
+        for (size_t a = 0; a < values.size(); a++)
+        {
+          const float* src = values[a]->GetPointer(0);
+          float* dst = brick.data();
+          for (vtkIdType k = record.Extent[4]; k <= record.Extent[5]; k++)
+          {
+            for (vtkIdType j = record.Extent[2]; j <= record.Extent[3]; j++)
+            {
+              const float* row = src + (k * dims[1] + j) * dims[0];
+              dst = std::copy(row + record.Extent[0], row + record.Extent[1] + 1, dst);
+            }
+          }
+          auto minmax = std::minmax_element(brick.begin(), brick.end());
+          ranges[2 * a] = *minmax.first;
+          ranges[2 * a + 1] = *minmax.second;
+          data.write(reinterpret_cast<const char*>(brick.data()), sizeof(float) * brick.size());
+          offset += sizeof(float) * brick.size();
+        }
+        index.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        index.write(reinterpret_cast<const char*>(ranges.data()), sizeof(float) * ranges.size());
+      }
+    }
+  }
+  data.close();
+  index.close();
+  if (!data.good() || !index.good())
+  {
+    std::cerr << "Cannot write bricked volume: " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ReadBrickIndex(const char* fileName, BrickIndex* index)
+{
+  const std::string indexName = std::string(fileName) + ".idx";
+  std::ifstream input(indexName, std::ios::in | std::ios::binary);
+  BrickIndexHeader header;
+  if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+    memcmp(header.Magic, BrickIndexMagic, 4) != 0 || header.HeaderSize < sizeof(header))
+  {
+    std::cerr << "Not a brick index: " << indexName << std::endl;
+    return false;
+  }
+  input.seekg(header.HeaderSize);
+  for (int c = 0; c < 3; c++)
+  {
+    index->WholeDims[c] = header.WholeDims[c];
+    index->Origin[c] = header.Origin[c];
+    index->Spacing[c] = header.Spacing[c];
+  }
+  index->BrickSize = header.BrickSize;
+  index->Arrays.clear();
+  for (uint32_t a = 0; a < header.NumberOfArrays; a++)
+  {
+    char buf[ArrayNameSize + 1] = {};
+    input.read(buf, ArrayNameSize);
+    index->Arrays.push_back(buf);
+  }
+  index->Bricks.resize(header.NumberOfBricks);
+  for (BrickIndex::Brick& brick : index->Bricks)
+  {
+    BrickRecord record;
+    input.read(reinterpret_cast<char*>(&record), sizeof(record));
+    std::copy(record.Extent, record.Extent + 6, brick.Extent);
+    brick.Offset = record.Offset;
+    brick.Ranges.resize(2 * header.NumberOfArrays);
+    input.read(reinterpret_cast<char*>(brick.Ranges.data()), sizeof(float) * brick.Ranges.size());
+  }
+  if (!input)
+  {
+    std::cerr << "Truncated brick index: " << indexName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ReadBricks(const char* fileName, const BrickIndex& index, const std::string& array,
+  double value, BrickSet* bricks)
+{
+  bricks->Array = index.FindArray(array);
+  bricks->Bricks.clear();
+  bricks->Values.clear();
+  bricks->BytesRead = 0;
+  if (bricks->Array < 0)
+  {
+    std::cerr << "No array " << array << " in bricked volume " << fileName << std::endl;
+    return false;
+  }
+  const size_t a = bricks->Array;
+  for (size_t b = 0; b < index.Bricks.size(); b++)
+  {
+    // Same test as the kernel: an edge crosses if one end is below value and one is not
+    const std::vector<float>& ranges = index.Bricks[b].Ranges;
+    if (ranges[2 * a] < value && ranges[2 * a + 1] >= value)
+    {
+      bricks->Bricks.push_back(b);
+    }
+  }
+
+  int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    perror(fileName);
+    return false;
+  }
+  bricks->Values.resize(bricks->Bricks.size());
+  std::atomic<bool> failed(false);
+  std::atomic<uint64_t> bytes(0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(bricks->Bricks.size()),
+    [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType n = begin; n < end; n++)
+      {
+        const BrickIndex::Brick& brick = index.Bricks[bricks->Bricks[n]];
+        const vtkIdType numPoints = GetNumberOfBrickPoints(brick.Extent);
+        const size_t size = sizeof(float) * numPoints;
+        std::vector<float>& values = bricks->Values[n];
+        values.resize(numPoints);
+        if (!ReadAt(fd, reinterpret_cast<char*>(values.data()), size, brick.Offset + a * size))
+        {
+          failed = true;
+          return;
+        }
+        bytes += size;
+      }
+    });
+  close(fd);
+  bricks->BytesRead = bytes;
+  if (failed)
+  {
+    std::cerr << "Truncated bricked volume: " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void ContourBricks(
+  const BrickIndex& index, const BrickSet& bricks, double value, IsoSurface* surface)
+{
+  std::vector<IsoSurface> parts(bricks.Bricks.size());
+  // Parallel over bricks; the kernel's own loops run serially inside
+  vtkSMPTools::For(0, static_cast<vtkIdType>(parts.size()), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType n = begin; n < end; n++)
+    {
+      const BrickIndex::Brick& brick = index.Bricks[bricks.Bricks[n]];
+      int dims[3], offset[3];
+      for (int c = 0; c < 3; c++)
+      {
+        dims[c] = brick.Extent[2 * c + 1] - brick.Extent[2 * c] + 1;
+        offset[c] = brick.Extent[2 * c];
+      }
+      StructuredContour(bricks.Values[n].data(), dims, offset, index.WholeDims, value, &parts[n]);
+    }
+  });
+  MergeIsoSurfaces(parts, surface);
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BrickedVolume_h
+#define BrickedVolume_h
+
+#include "StructuredContour.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class vtkImageData;
+
+/*
+ * A volume stored as fixed-size bricks so that a contour query only reads the
+ * bricks whose value range spans its isovalue.
+ *
+ * Bricks cover brickSize^3 cells each (fewer at the upper faces of the
+ * volume) and so hold (brickSize + 1)^3 points: neighbors share one plane of
+ * points, and every cube of the volume lies in exactly one brick. The data
+ * file (.brk) holds the bricks back to back (x fastest, then y, then z), each
+ * as one contiguous float32 block per array. The sidecar index (.brk.idx)
+ * holds the lattice, the array names and, per brick, its extent, its data
+ * offset and the min/max of every array:
+ *   char     magic[4] = "CBI1"
+ *   uint32_t header size (88)
+ *   int32_t  whole lattice dimensions[3]
+ *   int32_t  brick size in cells
+ *   double   origin[3]
+ *   double   spacing[3]
+ *   uint32_t number of arrays
+ *   uint32_t reserved
+ *   uint64_t number of bricks
+ *   char     array names[number of arrays][64]
+ *   per brick: int32_t point extent[6], uint64_t data offset,
+ *              float min/max[number of arrays][2]
+ */
+struct BrickIndex
+{
+  struct Brick
+  {
+    int Extent[6]; // Inclusive point index ranges in the whole lattice
+    uint64_t Offset;
+    std::vector<float> Ranges; // min, max of every array
+  };
+
+  int WholeDims[3];
+  int BrickSize;
+  double Origin[3];
+  double Spacing[3];
+  std::vector<std::string> Arrays;
+  std::vector<Brick> Bricks;
+
+  /*
+   * Index of the named array, or -1.
+   */
+  int FindArray(const std::string& name) const;
+};
+
+/*
+ * Bricks of one array that a query reads, with their values.
+ */
+struct BrickSet
+{
+  int Array = -1;
+  std::vector<size_t> Bricks;
+  std::vector<std::vector<float>> Values;
+  uint64_t BytesRead = 0;
+};
+
+/*
+ * Writes the named point arrays of image as fileName and its index as
+ * fileName + ".idx". Returns false on failure.
+ */
+bool WriteBrickedVolume(vtkImageData* image, const std::vector<std::string>& arrays,
+  int brickSize, const char* fileName);
+
+/*
+ * Reads the index of the bricked volume fileName (fileName + ".idx").
+ */
+bool ReadBrickIndex(const char* fileName, BrickIndex* index);
+
+/*
+ * Reads, in parallel, the values of array in every brick of fileName that
+ * crosses value; bricks entirely below or entirely at or above it cannot
+ * contain a piece of that isosurface and are skipped.
+ */
+bool ReadBricks(const char* fileName, const BrickIndex& index, const std::string& array,
+  double value, BrickSet* bricks);
+
+/*
+ * Contours every brick of bricks in parallel with the structured kernel and
+ * stitches the pieces by edge id into a surface of the whole lattice.
+ */
+void ContourBricks(
+  const BrickIndex& index, const BrickSet& bricks, double value, IsoSurface* surface);
+
+#endif
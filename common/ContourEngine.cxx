@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ContourEngine.h"
+#include "StructuredContour.h"
+
+#include <vtkContourFilter.h>
+#include <vtkDataObject.h>
+#include <vtkFlyingEdges3D.h>
+#include <vtkSMPTools.h>
+#include <vtkSynchronizedTemplates3D.h>
+
+#include <string.h>
+
+namespace
+{
+const char* const EngineNames[] = { "generic", "flying-edges", "synchronized-templates",
+  "structured" };
+}
+
+bool ParseContourEngine(const char* name, ContourEngine* engine)
+{
+  for (int i = 0; i < 4; i++)
+  {
+    if (strcmp(name, EngineNames[i]) == 0)
+    {
+      *engine = static_cast<ContourEngine>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* GetContourEngineName(ContourEngine engine)
+{
+  return EngineNames[static_cast<int>(engine)];
+}
+
+vtkSmartPointer<vtkPolyDataAlgorithm> NewContourFilter(
+  ContourEngine engine, const char* array, double value)
+{
+  vtkSmartPointer<vtkPolyDataAlgorithm> filter;
+  switch (engine)
+  {
+    case ContourEngine::Generic:
+    {
+      vtkSmartPointer<vtkContourFilter> cf = vtkSmartPointer<vtkContourFilter>::New();
+      cf->ComputeScalarsOff();
+      cf->ComputeNormalsOff();
+      cf->SetValue(0, value);
+      filter = cf;
+      break;
+    }
+    case ContourEngine::FlyingEdges:
+    {
+      vtkSmartPointer<vtkFlyingEdges3D> fe = vtkSmartPointer<vtkFlyingEdges3D>::New();
+      fe->ComputeScalarsOff();
+      fe->ComputeNormalsOff();
+      fe->ComputeGradientsOff();
+      fe->SetValue(0, value);
+      filter = fe;
+      break;
+    }
+    case ContourEngine::SynchronizedTemplates:
+    {
+      vtkSmartPointer<vtkSynchronizedTemplates3D> st =
+        vtkSmartPointer<vtkSynchronizedTemplates3D>::New();
+      st->ComputeScalarsOff();
+      st->ComputeNormalsOff();
+      st->ComputeGradientsOff();
+      st->SetValue(0, value);
+      filter = st;
+      break;
+    }
+    case ContourEngine::Structured:
+    {
+      vtkSmartPointer<StructuredContourFilter> sc = vtkSmartPointer<StructuredContourFilter>::New();
+      sc->SetValue(value);
+      filter = sc;
+      break;
+    }
+  }
+  filter->SetInputArrayToProcess(
+    0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, array);
+  return filter;
+}
+
+int InitializeContourThreads(int numThreads, ContourEngine engine)
+{
+  vtkSMPTools::Initialize(numThreads);
+  if (engine == ContourEngine::Generic || engine == ContourEngine::SynchronizedTemplates)
+  {
+    return 1;
+  }
+  return vtkSMPTools::GetEstimatedNumberOfThreads();
+}
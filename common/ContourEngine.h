@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ContourEngine_h
+#define ContourEngine_h
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+/*
+ * Isosurface engines for vtkImageData inputs.
+ *   generic:                vtkContourFilter (the original path)
+ *   flying-edges:           vtkFlyingEdges3D
+ *   synchronized-templates: vtkSynchronizedTemplates3D
+ *   structured:             StructuredContourFilter (in-house marching cubes)
+ * Flying edges and the structured engine run in parallel through vtkSMPTools;
+ * the generic engine and synchronized templates run on a single thread.
+ */
+enum class ContourEngine
+{
+  Generic,
+  FlyingEdges,
+  SynchronizedTemplates,
+  Structured
+};
+
+/*
+ * Returns false if name is not one of the engine names above.
+ */
+bool ParseContourEngine(const char* name, ContourEngine* engine);
+
+const char* GetContourEngineName(ContourEngine engine);
+
+/*
+ * Creates a filter contouring the point array at a single isovalue, producing
+ * points and triangles only (no scalars, normals or gradients).
+ */
+vtkSmartPointer<vtkPolyDataAlgorithm> NewContourFilter(
+  ContourEngine engine, const char* array, double value);
+
+/*
+ * Sets the number of vtkSMPTools threads (0 for all cores) and returns the
+ * number engine actually contours with: 1 for the serial engines.
+ */
+int InitializeContourThreads(int numThreads, ContourEngine engine);
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "EdgeMesh.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+struct EdgeMeshHeader
+{
+  char Magic[4];
+  uint32_t HeaderSize;
+  int32_t Dims[3];
+  uint32_t Reserved;
+  double Origin[3];
+  double Spacing[3];
+  uint64_t NumberOfVertices;
+  uint64_t NumberOfTriangles;
+  uint64_t EdgeBytes;
+};
+static_assert(sizeof(EdgeMeshHeader) == 96, "Unexpected edge mesh header layout");
+
+const char EdgeMeshMagic[4] = { 'C', 'B', 'E', '2' };
+}
+
+bool WriteEdgeMesh(const IsoSurface& surface, const int wholeDims[3], const double origin[3],
+  const double spacing[3], const char* fileName)
+{
+  const size_t numVerts = surface.EdgeIds.size();
+  std::vector<uint8_t> edges;
+  edges.reserve(2 * numVerts);
+  uint64_t last = 0;
+  for (uint64_t id : surface.EdgeIds)
+  {
+    uint64_t delta = id - last;
+    last = id;
+    while (delta >= 0x80)
+    {
+      edges.push_back(static_cast<uint8_t>(delta | 0x80));
+      delta >>= 7;
+    }
+    edges.push_back(static_cast<uint8_t>(delta));
+  }
+  std::vector<uint16_t> weights(numVerts);
+  for (size_t v = 0; v < numVerts; v++)
+  {
+    weights[v] = static_cast<uint16_t>(std::lround(surface.Weights[v] * 65535.0f));
+  }
+  std::vector<uint32_t> triangles(surface.Triangles.begin(), surface.Triangles.end());
+
+  EdgeMeshHeader header;
+  memcpy(header.Magic, EdgeMeshMagic, sizeof(header.Magic));
+  header.HeaderSize = sizeof(header);
+  for (int c = 0; c < 3; c++)
+  {
+    header.Dims[c] = wholeDims[c];
+    header.Origin[c] = origin[c];
+    header.Spacing[c] = spacing[c];
+  }
+  header.Reserved = 0;
+  header.NumberOfVertices = numVerts;
+  header.NumberOfTriangles = triangles.size() / 3;
+  header.EdgeBytes = edges.size();
+
+  std::ofstream output(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(edges.data()), edges.size());
+  output.write(reinterpret_cast<const char*>(weights.data()), sizeof(uint16_t) * weights.size());
+  output.write(
+    reinterpret_cast<const char*>(triangles.data()), sizeof(uint32_t) * triangles.size());
+  output.close();
+  if (!output.good())
+  {
+    std::cerr << "Cannot write edge mesh: " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ReadEdgeMesh(const char* fileName, IsoSurface* surface, int wholeDims[3], double origin[3],
+  double spacing[3])
+{
+  std::ifstream input(fileName, std::ios::in | std::ios::binary);
+  EdgeMeshHeader header;
+  if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+    memcmp(header.Magic, EdgeMeshMagic, 4) != 0 || header.HeaderSize < sizeof(header))
+  {
+    std::cerr << "Not an edge mesh: " << fileName << std::endl;
+    return false;
+  }
+  const size_t numVerts = header.NumberOfVertices;
+  const size_t numTris = header.NumberOfTriangles;
+  std::vector<uint8_t> edges(header.EdgeBytes);
+  std::vector<uint16_t> weights(numVerts);
+  std::vector<uint32_t> triangles(3 * numTris);
+  input.seekg(header.HeaderSize);
+  input.read(reinterpret_cast<char*>(edges.data()), edges.size());
+  input.read(reinterpret_cast<char*>(weights.data()), sizeof(uint16_t) * numVerts);
+  input.read(reinterpret_cast<char*>(triangles.data()), sizeof(uint32_t) * triangles.size());
+  if (!input)
+  {
+    std::cerr << "Truncated edge mesh: " << fileName << std::endl;
+    return false;
+  }
+
+  surface->EdgeIds.resize(numVerts);
+  surface->Weights.resize(numVerts);
+  uint64_t id = 0;
+  size_t pos = 0;
+  for (size_t v = 0; v < numVerts; v++)
+  {
+    uint64_t delta = 0;
+    int shift = 0;
+    uint8_t byte;
+    do
+    {
+      if (pos == edges.size() || shift >= 64)
+      {
+        std::cerr << "Corrupt edge mesh: " << fileName << std::endl;
+        return false;
+      }
+      byte = edges[pos++];
+      delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    id += delta;
+    surface->EdgeIds[v] = id;
+    surface->Weights[v] = weights[v] * (1.0f / 65535.0f);
+  }
+  for (uint32_t index : triangles)
+  {
+    if (index >= numVerts)
+    {
+      std::cerr << "Corrupt edge mesh: " << fileName << std::endl;
+      return false;
+    }
+  }
+  surface->Triangles.assign(triangles.begin(), triangles.end());
+  for (int c = 0; c < 3; c++)
+  {
+    wholeDims[c] = header.Dims[c];
+    origin[c] = header.Origin[c];
+    spacing[c] = header.Spacing[c];
+  }
+  return true;
+}
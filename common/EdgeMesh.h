@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EdgeMesh_h
+#define EdgeMesh_h
+
+#include "StructuredContour.h"
+
+/*
+ * Edge-encoded isosurface of a structured volume. Every vertex lies on a
+ * lattice edge, so it is sent as that edge's id plus a 16-bit weight along
+ * it; the receiver rebuilds coordinates from the origin and spacing sent
+ * along, which place lattice point (0, 0, 0) and the distance between points.
+ *   char     magic[4] = "CBE2"
+ *   uint32_t header size (96)
+ *   int32_t  lattice dimensions[3]
+ *   uint32_t reserved
+ *   double   origin[3]
+ *   double   spacing[3]
+ *   uint64_t number of vertices
+ *   uint64_t number of triangles
+ *   uint64_t edge id stream size in bytes
+ *   uint8_t  edge ids: ascending, delta coded, LEB128 varints
+ *   uint16_t weights[number of vertices]: weight * 65535, rounded
+ *   uint32_t triangles[3 * number of triangles]
+ */
+bool WriteEdgeMesh(const IsoSurface& surface, const int wholeDims[3], const double origin[3],
+  const double spacing[3], const char* fileName);
+
+/*
+ * Reads a mesh written by WriteEdgeMesh(). Returns false on failure.
+ */
+bool ReadEdgeMesh(const char* fileName, IsoSurface* surface, int wholeDims[3], double origin[3],
+  double spacing[3]);
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FusedContour.h"
+
+#include <vtkCellArray.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkMergePoints.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkType.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+/*
+ * Per-request state of the fused pass.
+ */
+struct ContourOutput
+{
+  vtkDataArray* Scalars = nullptr;
+  const float* FloatValues = nullptr;
+  const double* DoubleValues = nullptr;
+  double Value = 0;
+  vtkNew<vtkDoubleArray> CellScalars;
+  vtkNew<vtkPoints> Points;
+  vtkNew<vtkMergePoints> Locator;
+  vtkNew<vtkCellArray> Polys;
+
+  double GetScalar(vtkIdType ptId) const
+  {
+    if (this->FloatValues)
+    {
+      return this->FloatValues[ptId];
+    }
+    if (this->DoubleValues)
+    {
+      return this->DoubleValues[ptId];
+    }
+    return this->Scalars->GetComponent(ptId, 0);
+  }
+};
+
+/*
+ * The fused pass over numCells cells; cellAt(n) gives the id of the n-th.
+ */
+template <typename CellAt>
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContourCells(vtkDataSet* input,
+  const std::vector<ContourRequest>& requests, vtkIdType numCells, CellAt cellAt)
+{
+  // Same estimate as vtkContourFilter
+  vtkIdType estimatedSize = static_cast<vtkIdType>(std::pow(static_cast<double>(numCells), .75));
+  estimatedSize = std::max<vtkIdType>(estimatedSize / 1024 * 1024, 1024);
+  double bounds[6];
+  input->GetBounds(bounds);
+
+  std::vector<ContourOutput> outputs(requests.size());
+  for (size_t k = 0; k < requests.size(); k++)
+  {
+    ContourOutput& out = outputs[k];
+    out.Scalars = input->GetPointData()->GetArray(requests[k].Array.c_str());
+    if (!out.Scalars)
+    {
+      std::cerr << "No point array " << requests[k].Array << " to contour" << std::endl;
+      continue;
+    }
+    if (out.Scalars->GetNumberOfComponents() == 1)
+    {
+      if (vtkFloatArray* fa = vtkArrayDownCast<vtkFloatArray>(out.Scalars))
+      {
+        out.FloatValues = fa->GetPointer(0);
+      }
+      else if (vtkDoubleArray* da = vtkArrayDownCast<vtkDoubleArray>(out.Scalars))
+      {
+        out.DoubleValues = da->GetPointer(0);
+      }
+    }
+    out.Value = requests[k].Value;
+    out.Points->Allocate(estimatedSize);
+    out.Locator->InitPointInsertion(out.Points, bounds, estimatedSize);
+    out.Polys->AllocateEstimate(estimatedSize, 3);
+  }
+
+  vtkNew<vtkIdList> ptIds;
+  vtkNew<vtkGenericCell> cell;
+  // 3D cells only emit polygons; these catch anything else and are dropped
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  std::vector<char> active(outputs.size());
+  for (vtkIdType n = 0; n < numCells; n++)
+  {
+    const vtkIdType cellId = cellAt(n);
+    input->GetCellPoints(cellId, ptIds);
+    const vtkIdType npts = ptIds->GetNumberOfIds();
+    bool any = false;
+    for (size_t k = 0; k < outputs.size(); k++)
+    {
+      ContourOutput& out = outputs[k];
+      active[k] = 0;
+      if (!out.Scalars)
+      {
+        continue;
+      }
+      out.CellScalars->SetNumberOfTuples(npts);
+      double lo = VTK_DOUBLE_MAX, hi = VTK_DOUBLE_MIN;
+      for (vtkIdType i = 0; i < npts; i++)
+      {
+        double s = out.GetScalar(ptIds->GetId(i));
+        out.CellScalars->SetValue(i, s);
+        lo = std::min(lo, s);
+        hi = std::max(hi, s);
+      }
+      if (lo <= out.Value && out.Value <= hi)
+      {
+        active[k] = 1;
+        any = true;
+      }
+    }
+    if (!any)
+    {
+      // Point coordinates are never loaded for cells no request crosses
+      continue;
+    }
+    input->GetCell(cellId, cell);
+    for (size_t k = 0; k < outputs.size(); k++)
+    {
+      if (active[k])
+      {
+        ContourOutput& out = outputs[k];
+        cell->Contour(out.Value, out.CellScalars, out.Locator, verts, lines, out.Polys, nullptr,
+          nullptr, nullptr, cellId, nullptr);
+      }
+    }
+  }
+
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+  for (ContourOutput& out : outputs)
+  {
+    out.Points->Squeeze();
+    out.Polys->Squeeze();
+    vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+    mesh->SetPoints(out.Points);
+    mesh->SetPolys(out.Polys);
+    meshes.push_back(mesh);
+  }
+  return meshes;
+}
+}
+
+const ContourRequest FieldRequests[3] = { { "v02", 0.8 }, { "v03", 0.5 }, { "tev", 0.1 } };
+
+std::vector<ContourRequest> SelectFieldRequests(bool v02, bool v03, bool tev)
+{
+  const bool fields[3] = { v02, v03, tev };
+  std::vector<ContourRequest> requests;
+  for (int i = 0; i < 3; i++)
+  {
+    if (fields[i])
+    {
+      requests.push_back(FieldRequests[i]);
+    }
+  }
+  return requests;
+}
+
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContour(
+  vtkDataSet* input, const std::vector<ContourRequest>& requests)
+{
+  return FusedContour(input, requests, 0, input->GetNumberOfCells());
+}
+
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContour(vtkDataSet* input,
+  const std::vector<ContourRequest>& requests, vtkIdType beginCell, vtkIdType endCell)
+{
+  return FusedContourCells(
+    input, requests, endCell - beginCell, [beginCell](vtkIdType n) { return beginCell + n; });
+}
+
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContour(vtkDataSet* input,
+  const std::vector<ContourRequest>& requests, const std::vector<vtkIdType>& cells)
+{
+  return FusedContourCells(input, requests, static_cast<vtkIdType>(cells.size()),
+    [&cells](vtkIdType n) { return cells[n]; });
+}
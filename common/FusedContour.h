@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FusedContour_h
+#define FusedContour_h
+
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <string>
+#include <vector>
+
+class vtkDataSet;
+class vtkPolyData;
+
+/*
+ * One isosurface of a fused contour pass: a point data array and an isovalue.
+ */
+struct ContourRequest
+{
+  std::string Array;
+  double Value;
+};
+
+/*
+ * The asteroid fields the runners and the Offloader contour, each at its
+ * fixed isovalue, in result file order: v02, v03, tev.
+ */
+extern const ContourRequest FieldRequests[3];
+
+/*
+ * The FieldRequests the flags select, in the same order.
+ */
+std::vector<ContourRequest> SelectFieldRequests(bool v02, bool v03, bool tev);
+
+/*
+ * Contours every request in a single pass over the cells of input. Each cell's
+ * connectivity, scalars and point coordinates are fetched once and shared by
+ * all requests, instead of once per vtkContourFilter run. Returns one
+ * triangle mesh per request, in request order. Only points are generated (no
+ * scalars or normals), matching how the runners configure vtkContourFilter.
+ */
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContour(
+  vtkDataSet* input, const std::vector<ContourRequest>& requests);
+
+/*
+ * Same, restricted to cells [beginCell, endCell). Used to contour a grid
+ * piece by piece.
+ */
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContour(vtkDataSet* input,
+  const std::vector<ContourRequest>& requests, vtkIdType beginCell, vtkIdType endCell);
+
+/*
+ * Same, restricted to the listed cells (ascending ids keep the pass cache
+ * friendly). Used to contour only the active cells a span index finds.
+ */
+std::vector<vtkSmartPointer<vtkPolyData>> FusedContour(vtkDataSet* input,
+  const std::vector<ContourRequest>& requests, const std::vector<vtkIdType>& cells);
+
+#endif
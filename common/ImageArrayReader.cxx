@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ImageArrayReader.h"
+#include "ThreadPool.h"
+
+#include <vtkDataArraySelection.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkXMLImageDataReader.h>
+
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkImageData> ReadArray(const char* fileName, const std::string& array)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(fileName);
+  reader->UpdateInformation();
+  vtkDataArraySelection* selection = reader->GetPointDataArraySelection();
+  if (!selection->ArrayExists(array.c_str()))
+  {
+    std::cerr << "No point array " << array << " in " << fileName << std::endl;
+    return nullptr;
+  }
+  selection->DisableAllArrays();
+  selection->EnableArray(array.c_str());
+  reader->GetCellDataArraySelection()->DisableAllArrays();
+  reader->Update();
+  if (reader->GetErrorCode() != 0)
+  {
+    std::cerr << "Cannot read " << array << " from " << fileName << std::endl;
+    return nullptr;
+  }
+  return reader->GetOutput();
+}
+}
+
+vtkSmartPointer<vtkImageData> ReadImageArrays(
+  const char* fileName, const std::vector<std::string>& arrays)
+{
+  if (arrays.size() == 1)
+  {
+    return ReadArray(fileName, arrays[0]);
+  }
+
+  std::vector<vtkSmartPointer<vtkImageData>> parts(arrays.size());
+  {
+    ThreadPool pool(static_cast<int>(arrays.size()));
+    for (size_t i = 0; i < arrays.size(); i++)
+    {
+      pool.Submit([&, i]() { parts[i] = ReadArray(fileName, arrays[i]); });
+    }
+  }
+  for (const vtkSmartPointer<vtkImageData>& part : parts)
+  {
+    if (!part)
+    {
+      return nullptr;
+    }
+  }
+  vtkSmartPointer<vtkImageData> image = parts[0];
+  for (size_t i = 1; i < parts.size(); i++)
+  {
+    image->GetPointData()->AddArray(parts[i]->GetPointData()->GetArray(arrays[i].c_str()));
+  }
+  return image;
+}
@@ -0,0 +1,501 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MappedImageReader.h"
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkType.h>
+
+#include <algorithm>
+#include <atomic>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+/*
+ * One mapped file. Shared by every array wrapping part of it.
+ */
+struct Mapping
+{
+  void* Base = MAP_FAILED;
+  size_t Length = 0;
+
+  ~Mapping()
+  {
+    if (this->Base != MAP_FAILED)
+    {
+      munmap(this->Base, this->Length);
+    }
+  }
+};
+
+/*
+ * VTK calls a user-defined free function with the array pointer only, so the
+ * arrays wrapping a mapping are tracked here.
+ */
+std::mutex MappedArraysMutex;
+std::map<void*, std::shared_ptr<Mapping>> MappedArrays;
+
+std::atomic<uint64_t> CopiedBytes(0);
+
+void ReleaseMappedArray(void* ptr)
+{
+  std::shared_ptr<Mapping> mapping;
+  std::lock_guard<std::mutex> lock(MappedArraysMutex);
+  auto it = MappedArrays.find(ptr);
+  if (it != MappedArrays.end())
+  {
+    mapping = std::move(it->second); // Unmapped here if this was the last array
+    MappedArrays.erase(it);
+  }
+}
+
+/*
+ * Value of attribute name in the XML start tag tag, or an empty string.
+ */
+std::string GetAttribute(const std::string& tag, const char* name)
+{
+  const std::string key = std::string(" ") + name + "=\"";
+  size_t pos = tag.find(key);
+  if (pos == std::string::npos)
+  {
+    return std::string();
+  }
+  pos += key.size();
+  size_t end = tag.find('"', pos);
+  return end == std::string::npos ? std::string() : tag.substr(pos, end - pos);
+}
+
+/*
+ * Parses the decimal attribute value text. Returns false if it is empty or
+ * not a whole non-negative number, so a malformed header is rejected rather
+ * than thrown out of std::stoull().
+ */
+bool ParseUnsigned(const std::string& text, uint64_t* value)
+{
+  if (text.empty() || !isdigit(static_cast<unsigned char>(text[0])))
+  {
+    return false;
+  }
+  char* end;
+  errno = 0;
+  const unsigned long long parsed = strtoull(text.c_str(), &end, 10);
+  if (errno != 0 || *end != '\0')
+  {
+    return false;
+  }
+  *value = parsed;
+  return true;
+}
+
+/*
+ * Parses the NumberOfComponents and offset attributes of a DataArray tag;
+ * the number of components defaults to 1. Returns false if either is
+ * malformed.
+ */
+bool ParseArrayLayout(const std::string& tag, int* numComponents, uint64_t* offset)
+{
+  const std::string components = GetAttribute(tag, "NumberOfComponents");
+  uint64_t count = 1;
+  if ((!components.empty() && !ParseUnsigned(components, &count)) || count == 0 ||
+    count > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+    !ParseUnsigned(GetAttribute(tag, "offset"), offset))
+  {
+    return false;
+  }
+  *numComponents = static_cast<int>(count);
+  return true;
+}
+
+/*
+ * Start tag beginning at or after pos whose name is element, or an empty
+ * string; pos is moved past it.
+ */
+std::string NextTag(const std::string& header, const char* element, size_t* pos)
+{
+  const std::string open = std::string("<") + element;
+  for (size_t start = header.find(open, *pos); start != std::string::npos;
+       start = header.find(open, start + 1))
+  {
+    const char next = header[start + open.size()];
+    if (next == ' ' || next == '>' || next == '/')
+    {
+      size_t end = header.find('>', start);
+      if (end == std::string::npos)
+      {
+        return std::string();
+      }
+      *pos = end + 1;
+      return header.substr(start, end + 1 - start);
+    }
+  }
+  return std::string();
+}
+
+int GetVTKType(const std::string& type)
+{
+  static const std::map<std::string, int> types = { { "Int8", VTK_TYPE_INT8 },
+    { "UInt8", VTK_TYPE_UINT8 }, { "Int16", VTK_TYPE_INT16 }, { "UInt16", VTK_TYPE_UINT16 },
+    { "Int32", VTK_TYPE_INT32 }, { "UInt32", VTK_TYPE_UINT32 }, { "Int64", VTK_TYPE_INT64 },
+    { "UInt64", VTK_TYPE_UINT64 }, { "Float32", VTK_TYPE_FLOAT32 },
+    { "Float64", VTK_TYPE_FLOAT64 } };
+  auto it = types.find(type);
+  return it == types.end() ? -1 : it->second;
+}
+
+bool ParseInts(const std::string& value, int* out, int n)
+{
+  std::istringstream input(value);
+  for (int i = 0; i < n; i++)
+  {
+    input >> out[i];
+  }
+  return !input.fail();
+}
+
+bool ParseDoubles(const std::string& value, double* out, int n)
+{
+  std::istringstream input(value);
+  for (int i = 0; i < n; i++)
+  {
+    input >> out[i];
+  }
+  return !input.fail();
+}
+
+/*
+ * The parts of the XML header both readers need.
+ */
+struct ImageHeader
+{
+  int Extent[6];
+  double Origin[3];
+  double Spacing[3];
+  size_t HeaderSize; // Of the size prefix of every appended array
+  size_t PieceBegin;
+  size_t PieceEnd;
+};
+
+/*
+ * Parses the XML before the '_' that starts the raw appended data.
+ */
+bool ParseImageHeader(const std::string& header, const char* fileName, ImageHeader* image)
+{
+  size_t pos = 0;
+  const std::string file = NextTag(header, "VTKFile", &pos);
+  const std::string appendedTag = NextTag(header, "AppendedData", &pos);
+  pos = 0;
+  const std::string imageTag = NextTag(header, "ImageData", &pos);
+  const std::string pieceTag = NextTag(header, "Piece", &pos);
+  image->PieceBegin = pos;
+  size_t extra = pos;
+  if (GetAttribute(file, "type") != "ImageData" ||
+    GetAttribute(file, "byte_order") != "LittleEndian" ||
+    !GetAttribute(file, "compressor").empty() || GetAttribute(appendedTag, "encoding") != "raw" ||
+    pieceTag.empty() || !NextTag(header, "Piece", &extra).empty())
+  {
+    std::cerr << "Not a single-piece raw appended image: " << fileName << std::endl;
+    return false;
+  }
+  image->HeaderSize = GetAttribute(file, "header_type") == "UInt64" ? 8 : 4;
+  image->PieceEnd = header.find("</Piece>", image->PieceBegin);
+  if (!ParseInts(GetAttribute(pieceTag, "Extent"), image->Extent, 6) ||
+    !ParseDoubles(GetAttribute(imageTag, "Origin"), image->Origin, 3) ||
+    !ParseDoubles(GetAttribute(imageTag, "Spacing"), image->Spacing, 3))
+  {
+    std::cerr << "Malformed image header: " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Wraps (or copies, if misaligned) the arrays of one <PointData> or
+ * <CellData> section.
+ */
+bool ReadArrays(const std::string& header, size_t begin, size_t end, const char* data,
+  const char* dataEnd, size_t headerSize, vtkIdType numTuples,
+  const std::vector<std::string>& arrays, const std::shared_ptr<Mapping>& mapping,
+  vtkDataSetAttributes* attributes)
+{
+  size_t pos = begin;
+  for (;;)
+  {
+    std::string tag = NextTag(header, "DataArray", &pos);
+    if (tag.empty() || pos > end)
+    {
+      return true;
+    }
+    const std::string name = GetAttribute(tag, "Name");
+    if (!arrays.empty() && std::find(arrays.begin(), arrays.end(), name) == arrays.end())
+    {
+      continue;
+    }
+    const int type = GetVTKType(GetAttribute(tag, "type"));
+    if (type < 0 || GetAttribute(tag, "format") != "appended")
+    {
+      std::cerr << "Unsupported data array " << name << std::endl;
+      return false;
+    }
+    int numComponents;
+    uint64_t offset;
+    if (!ParseArrayLayout(tag, &numComponents, &offset))
+    {
+      std::cerr << "Malformed data array " << name << std::endl;
+      return false;
+    }
+    if (offset > static_cast<uint64_t>(dataEnd - data) || data + offset + headerSize > dataEnd)
+    {
+      std::cerr << "Truncated data array " << name << std::endl;
+      return false;
+    }
+    const char* block = data + offset;
+    uint64_t size = 0;
+    memcpy(&size, block, headerSize); // Little-endian, so a UInt32 header fits too
+
+    vtkSmartPointer<vtkDataArray> array =
+      vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(type));
+    const vtkIdType numValues = numTuples * numComponents;
+    if (size != static_cast<uint64_t>(numValues) * array->GetDataTypeSize() ||
+      block + headerSize + size > dataEnd)
+    {
+      std::cerr << "Unexpected size of data array " << name << std::endl;
+      return false;
+    }
+    array->SetName(name.c_str());
+    array->SetNumberOfComponents(numComponents);
+    char* values = const_cast<char*>(block + headerSize);
+    if (reinterpret_cast<uintptr_t>(values) % array->GetDataTypeSize() == 0)
+    {
+      {
+        std::lock_guard<std::mutex> lock(MappedArraysMutex);
+        MappedArrays[values] = mapping;
+      }
+      array->SetVoidArray(values, numValues, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+      array->SetArrayFreeFunction(ReleaseMappedArray);
+    }
+    else
+    {
+      std::cerr << "Copying misaligned data array " << name << std::endl;
+      array->SetNumberOfTuples(numTuples);
+      memcpy(array->GetVoidPointer(0), values, size);
+      CopiedBytes += size;
+    }
+    attributes->AddArray(array);
+  }
+}
+}
+
+uint64_t GetMappedCopiedBytes()
+{
+  return CopiedBytes;
+}
+
+vtkSmartPointer<vtkImageData> ReadMappedImage(
+  const char* fileName, const std::vector<std::string>& arrays)
+{
+  int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    perror(fileName);
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    perror(fileName);
+    close(fd);
+    return nullptr;
+  }
+  std::shared_ptr<Mapping> mapping = std::make_shared<Mapping>();
+  mapping->Length = st.st_size;
+  // Private and writable so that a filter modifying its input cannot reach the file
+  mapping->Base = mmap(nullptr, mapping->Length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping->Base == MAP_FAILED)
+  {
+    perror(fileName);
+    return nullptr;
+  }
+  const char* const base = static_cast<const char*>(mapping->Base);
+  const char* const fileEnd = base + mapping->Length;
+
+  // Everything up to the '_' that starts the raw appended data is XML
+  const char* appended = static_cast<const char*>(
+    memmem(base, mapping->Length, "<AppendedData", strlen("<AppendedData")));
+  const char* data = appended ? static_cast<const char*>(memchr(appended, '_', fileEnd - appended))
+                              : nullptr;
+  if (!data)
+  {
+    std::cerr << "No appended data in " << fileName << std::endl;
+    return nullptr;
+  }
+  const std::string header(base, data - base);
+  data++;
+
+  ImageHeader info;
+  if (!ParseImageHeader(header, fileName, &info))
+  {
+    return nullptr;
+  }
+  const size_t headerSize = info.HeaderSize;
+  const size_t pieceEnd = info.PieceEnd;
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(info.Extent);
+  image->SetOrigin(info.Origin);
+  image->SetSpacing(info.Spacing);
+
+  size_t pointData = info.PieceBegin, cellData = info.PieceBegin;
+  const bool hasPointData = !NextTag(header, "PointData", &pointData).empty();
+  const bool hasCellData = !NextTag(header, "CellData", &cellData).empty();
+  if ((hasPointData &&
+        !ReadArrays(header, pointData, std::min(header.find("</PointData>", pointData), pieceEnd),
+          data, fileEnd, headerSize, image->GetNumberOfPoints(), arrays, mapping,
+          image->GetPointData())) ||
+    (hasCellData &&
+      !ReadArrays(header, cellData, std::min(header.find("</CellData>", cellData), pieceEnd),
+        data, fileEnd, headerSize, image->GetNumberOfCells(), arrays, mapping,
+        image->GetCellData())))
+  {
+    return nullptr;
+  }
+  return image;
+}
+
+bool LocateRawImageArray(const char* fileName, const std::string& array, RawImageArray* location)
+{
+  // The header is small; read until the '_' that follows <AppendedData
+  int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    perror(fileName);
+    return false;
+  }
+  std::string header;
+  size_t dataStart = std::string::npos;
+  char buf[65536];
+  for (;;)
+  {
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0)
+    {
+      break;
+    }
+    header.append(buf, n);
+    size_t appended = header.find("<AppendedData");
+    if (appended != std::string::npos)
+    {
+      dataStart = header.find('_', appended);
+      if (dataStart != std::string::npos)
+      {
+        break;
+      }
+    }
+  }
+  struct stat st;
+  const bool statted = fstat(fd, &st) == 0;
+  close(fd);
+  if (dataStart == std::string::npos || !statted)
+  {
+    std::cerr << "No appended data in " << fileName << std::endl;
+    return false;
+  }
+  header.resize(dataStart);
+
+  ImageHeader info;
+  if (!ParseImageHeader(header, fileName, &info))
+  {
+    return false;
+  }
+  size_t pos = info.PieceBegin;
+  if (NextTag(header, "PointData", &pos).empty())
+  {
+    pos = info.PieceEnd;
+  }
+  const size_t end = std::min(header.find("</PointData>", pos), info.PieceEnd);
+  for (std::string tag = NextTag(header, "DataArray", &pos); !tag.empty() && pos <= end;
+       tag = NextTag(header, "DataArray", &pos))
+  {
+    if (GetAttribute(tag, "Name") != array)
+    {
+      continue;
+    }
+    const int type = GetVTKType(GetAttribute(tag, "type"));
+    if (type < 0 || GetAttribute(tag, "format") != "appended")
+    {
+      std::cerr << "Unsupported data array " << array << std::endl;
+      return false;
+    }
+    int numComponents;
+    uint64_t offset;
+    if (!ParseArrayLayout(tag, &numComponents, &offset))
+    {
+      std::cerr << "Malformed data array " << array << std::endl;
+      return false;
+    }
+    memcpy(location->Extent, info.Extent, sizeof(info.Extent));
+    memcpy(location->Origin, info.Origin, sizeof(info.Origin));
+    memcpy(location->Spacing, info.Spacing, sizeof(info.Spacing));
+    location->Type = type;
+    location->NumberOfComponents = numComponents;
+    location->Offset = dataStart + 1 + offset + info.HeaderSize;
+    if (offset > static_cast<uint64_t>(st.st_size) ||
+      location->Offset > static_cast<uint64_t>(st.st_size))
+    {
+      std::cerr << "Truncated data array " << array << std::endl;
+      return false;
+    }
+    return true;
+  }
+  std::cerr << "No point array " << array << " in " << fileName << std::endl;
+  return false;
+}
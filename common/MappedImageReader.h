@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MappedImageReader_h
+#define MappedImageReader_h
+
+#include <vtkSmartPointer.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class vtkImageData;
+
+/*
+ * Reads a .vti file written with raw (uncompressed, unencoded) appended data,
+ * as RewriteToVTI and the Nyx conversions write them, by mapping it into
+ * memory. Suitably aligned point and cell arrays are wrapped in place rather
+ * than copied, so the read itself touches only the XML header and pages are
+ * faulted in as the data is used; the mapping is released with the last
+ * array referencing it. Misaligned arrays are copied.
+ *
+ * Only the named arrays are loaded (all of them if arrays is empty). Returns
+ * nullptr, after printing why, for files this reader does not handle
+ * (compressed, encoded, big-endian, multi-piece); use vtkXMLImageDataReader
+ * for those.
+ */
+vtkSmartPointer<vtkImageData> ReadMappedImage(
+  const char* fileName, const std::vector<std::string>& arrays = std::vector<std::string>());
+
+/*
+ * Bytes ReadMappedImage() copied rather than wrapped, because their arrays
+ * were misaligned, since the process started. Reported next to mapped read
+ * times so that a copying read is not taken for a mapped one.
+ */
+uint64_t GetMappedCopiedBytes();
+
+/*
+ * Where one point array of such a file (or of a headerless raw volume) lives,
+ * for readers that fetch it in pieces, e.g. z-slabs with pread, instead of
+ * mapping it whole.
+ */
+struct RawImageArray
+{
+  int Extent[6];
+  double Origin[3];
+  double Spacing[3];
+  int Type; // VTK type of the values
+  int NumberOfComponents;
+  uint64_t Offset; // Of the first value in the file
+};
+
+/*
+ * Parses only the XML header of fileName to locate point array array.
+ * Returns false, after printing why, for the files ReadMappedImage() rejects
+ * or if there is no such array.
+ */
+bool LocateRawImageArray(const char* fileName, const std::string& array, RawImageArray* location);
+
+#endif
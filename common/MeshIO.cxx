@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MeshIO.h"
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLPolyDataWriter.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+struct BinaryMeshHeader
+{
+  char Magic[4];
+  uint32_t HeaderSize;
+  uint64_t NumberOfPoints;
+  uint64_t NumberOfTriangles;
+};
+static_assert(sizeof(BinaryMeshHeader) == 24, "Unexpected binary mesh header layout");
+
+const char BinaryMeshMagic[4] = { 'C', 'B', 'M', '1' };
+
+bool WriteFully(int fd, const void* data, size_t size)
+{
+  const char* p = static_cast<const char*>(data);
+  while (size)
+  {
+    ssize_t n = write(fd, p, size);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+/*
+ * preadv() until every buffer is filled; fails on a short file.
+ */
+bool ReadFully(int fd, struct iovec* iov, int iovcnt, off_t offset)
+{
+  while (iovcnt > 0)
+  {
+    ssize_t n = preadv(fd, iov, iovcnt, offset);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0)
+    {
+      return false;
+    }
+    offset += n;
+    while (iovcnt > 0 && static_cast<size_t>(n) >= iov->iov_len)
+    {
+      n -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0)
+    {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+      iov->iov_len -= n;
+    }
+  }
+  return true;
+}
+
+/*
+ * Flattens the polygons of mesh into uint32 triangle indices, fanning any
+ * polygon with more than three points.
+ */
+void GetTriangles(vtkPolyData* mesh, std::vector<uint32_t>* triangles)
+{
+  vtkCellArray* polys = mesh->GetPolys();
+  const vtkIdType numCells = polys->GetNumberOfCells();
+  if (polys->IsHomogeneous() == 3)
+  {
+    triangles->resize(3 * numCells);
+    if (polys->IsStorage64Bit())
+    {
+      const int64_t* conn = polys->GetConnectivityArray64()->GetPointer(0);
+      std::copy(conn, conn + 3 * numCells, triangles->begin());
+    }
+    else
+    {
+      const int32_t* conn = polys->GetConnectivityArray32()->GetPointer(0);
+      std::copy(conn, conn + 3 * numCells, triangles->begin());
+    }
+    return;
+  }
+  triangles->clear();
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    polys->GetCellAtId(cellId, npts, pts);
+    for (vtkIdType i = 1; i + 1 < npts; i++)
+    {
+      triangles->push_back(static_cast<uint32_t>(pts[0]));
+      triangles->push_back(static_cast<uint32_t>(pts[i]));
+      triangles->push_back(static_cast<uint32_t>(pts[i + 1]));
+    }
+  }
+}
+
+bool WriteBinaryMesh(vtkPolyData* mesh, const char* fileName)
+{
+  const vtkIdType numPoints = mesh->GetNumberOfPoints();
+  if (numPoints > VTK_INT_MAX)
+  {
+    std::cerr << "Too many points for a binary mesh: " << numPoints << std::endl;
+    return false;
+  }
+  vtkSmartPointer<vtkFloatArray> points;
+  if (numPoints)
+  {
+    points = vtkArrayDownCast<vtkFloatArray>(mesh->GetPoints()->GetData());
+    if (!points)
+    {
+      points = vtkSmartPointer<vtkFloatArray>::New();
+      points->DeepCopy(mesh->GetPoints()->GetData());
+    }
+  }
+  std::vector<uint32_t> triangles;
+  if (mesh->GetPolys())
+  {
+    GetTriangles(mesh, &triangles);
+  }
+
+  BinaryMeshHeader header;
+  memcpy(header.Magic, BinaryMeshMagic, sizeof(header.Magic));
+  header.HeaderSize = sizeof(header);
+  header.NumberOfPoints = numPoints;
+  header.NumberOfTriangles = triangles.size() / 3;
+
+  int fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    perror(fileName);
+    return false;
+  }
+  bool ok = WriteFully(fd, &header, sizeof(header)) &&
+    WriteFully(fd, numPoints ? points->GetPointer(0) : nullptr, 3 * sizeof(float) * numPoints) &&
+    WriteFully(fd, triangles.data(), sizeof(uint32_t) * triangles.size());
+  if (close(fd) != 0 || !ok)
+  {
+    perror(fileName);
+    return false;
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkPolyData> ReadBinaryMesh(const char* fileName)
+{
+  int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    perror(fileName);
+    return nullptr;
+  }
+  BinaryMeshHeader header;
+  struct iovec hiov = { &header, sizeof(header) };
+  if (!ReadFully(fd, &hiov, 1, 0) || memcmp(header.Magic, BinaryMeshMagic, 4) != 0 ||
+    header.HeaderSize < sizeof(header))
+  {
+    std::cerr << "Not a binary mesh: " << fileName << std::endl;
+    close(fd);
+    return nullptr;
+  }
+
+  // The counts size the allocations below, so check them against the file
+  // before trusting them
+  struct stat st;
+  const uint64_t tupleBytes = 3 * sizeof(float);
+  if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < header.HeaderSize)
+  {
+    std::cerr << "Truncated binary mesh: " << fileName << std::endl;
+    close(fd);
+    return nullptr;
+  }
+  const uint64_t payload = static_cast<uint64_t>(st.st_size) - header.HeaderSize;
+  if (header.NumberOfPoints > payload / tupleBytes ||
+    header.NumberOfTriangles > payload / tupleBytes ||
+    (header.NumberOfPoints + header.NumberOfTriangles) * tupleBytes > payload)
+  {
+    std::cerr << "Truncated binary mesh: " << fileName << std::endl;
+    close(fd);
+    return nullptr;
+  }
+
+  const vtkIdType numPoints = static_cast<vtkIdType>(header.NumberOfPoints);
+  const vtkIdType numTris = static_cast<vtkIdType>(header.NumberOfTriangles);
+  vtkNew<vtkFloatArray> coords;
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(numPoints);
+  // The uint32 indices are stored as-is in a 32-bit cell array
+  vtkNew<vtkTypeInt32Array> connectivity;
+  connectivity->SetNumberOfValues(3 * numTris);
+  struct iovec iov[2] = { { coords->GetPointer(0), 3 * sizeof(float) * header.NumberOfPoints },
+    { connectivity->GetPointer(0), 3 * sizeof(uint32_t) * header.NumberOfTriangles } };
+  bool ok = ReadFully(fd, iov, 2, header.HeaderSize);
+  close(fd);
+  if (!ok)
+  {
+    std::cerr << "Truncated binary mesh: " << fileName << std::endl;
+    return nullptr;
+  }
+  const uint32_t* const indices = reinterpret_cast<const uint32_t*>(connectivity->GetPointer(0));
+  for (vtkIdType i = 0; i < 3 * numTris; i++)
+  {
+    if (indices[i] >= header.NumberOfPoints)
+    {
+      std::cerr << "Corrupt binary mesh: " << fileName << std::endl;
+      return nullptr;
+    }
+  }
+
+  vtkNew<vtkTypeInt32Array> offsets;
+  offsets->SetNumberOfValues(numTris + 1);
+  int32_t* o = offsets->GetPointer(0);
+  for (vtkIdType t = 0; t <= numTris; t++)
+  {
+    o[t] = static_cast<int32_t>(3 * t);
+  }
+  vtkNew<vtkPoints> points;
+  points->SetData(coords);
+  vtkNew<vtkCellArray> polys;
+  polys->SetData(offsets, connectivity);
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+  return mesh;
+}
+}
+
+const char* GetMeshEncodingName(MeshEncoding encoding)
+{
+  switch (encoding)
+  {
+    case MeshEncoding::XML:
+      return "xml";
+    case MeshEncoding::Binary:
+      return "binary";
+    case MeshEncoding::Edge:
+      return "edge";
+    case MeshEncoding::Stream:
+      return "stream";
+  }
+  return "unknown";
+}
+
+bool ParseMeshEncoding(const char* name, MeshEncoding* encoding)
+{
+  for (int i = 0; i < 4; i++)
+  {
+    if (strcmp(name, GetMeshEncodingName(static_cast<MeshEncoding>(i))) == 0)
+    {
+      *encoding = static_cast<MeshEncoding>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GetMeshEncoding(int value, MeshEncoding* encoding)
+{
+  if (value < static_cast<int>(MeshEncoding::XML) || value > static_cast<int>(MeshEncoding::Stream))
+  {
+    return false;
+  }
+  *encoding = static_cast<MeshEncoding>(value);
+  return true;
+}
+
+bool WriteMesh(vtkPolyData* mesh, const char* fileName, MeshEncoding encoding, int compression)
+{
+  if (encoding == MeshEncoding::Binary)
+  {
+    return WriteBinaryMesh(mesh, fileName);
+  }
+  if (encoding == MeshEncoding::Edge || encoding == MeshEncoding::Stream)
+  {
+    std::cerr << GetMeshEncodingName(encoding) << " meshes are not written whole" << std::endl;
+    return false;
+  }
+  vtkNew<vtkXMLPolyDataWriter> w;
+  w->SetFileName(fileName);
+  w->SetInputData(mesh);
+  if (compression == 1)
+  {
+    w->SetCompressorTypeToZLib();
+  }
+  else if (compression == 2)
+  {
+    w->SetCompressorTypeToLZ4();
+  }
+  else
+  {
+    w->SetCompressorTypeToNone();
+  }
+  w->EncodeAppendedDataOff();
+  return w->Write() != 0;
+}
+
+vtkSmartPointer<vtkPolyData> ReadMesh(const char* fileName, MeshEncoding encoding)
+{
+  if (encoding == MeshEncoding::Binary)
+  {
+    return ReadBinaryMesh(fileName);
+  }
+  if (encoding == MeshEncoding::Edge || encoding == MeshEncoding::Stream)
+  {
+    std::cerr << GetMeshEncodingName(encoding) << " meshes are not read whole" << std::endl;
+    return nullptr;
+  }
+  // The reader returns an empty mesh rather than failing on a missing or
+  // malformed file, which would pass for a query that found no surface
+  struct stat st;
+  if (stat(fileName, &st) != 0)
+  {
+    perror(fileName);
+    return nullptr;
+  }
+  vtkNew<vtkXMLPolyDataReader> r;
+  r->SetFileName(fileName);
+  r->Update();
+  if (r->GetErrorCode() != 0)
+  {
+    std::cerr << "Cannot read mesh: " << fileName << std::endl;
+    return nullptr;
+  }
+  return r->GetOutput();
+}
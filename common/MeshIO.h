@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MeshIO_h
+#define MeshIO_h
+
+#include <vtkSmartPointer.h>
+
+class vtkPolyData;
+
+/*
+ * How an Offloader returns an isosurface to its OffloadRunner.
+ *   xml:    vtkXMLPolyDataWriter output (the original path)
+ *   binary: a fixed 24-byte header followed by float32 points and uint32
+ *           triangle indices:
+ *             char     magic[4] = "CBM1"
+ *             uint32_t header size (24)
+ *             uint64_t number of points
+ *             uint64_t number of triangles
+ *             float    points[3 * number of points]
+ *             uint32_t triangles[3 * number of triangles]
+ *   edge:   lattice-edge encoding of a structured-volume isosurface, see
+ *           EdgeMesh.h; WriteMesh() and ReadMesh() do not handle it
+ *   stream: chunks written while contouring is still running, see
+ *           MeshStream.h; WriteMesh() and ReadMesh() do not handle it
+ * The numeric value of each encoding is what the pushdown command carries.
+ */
+enum class MeshEncoding
+{
+  XML = 0,
+  Binary = 1,
+  Edge = 2,
+  Stream = 3
+};
+
+const char* GetMeshEncodingName(MeshEncoding encoding);
+
+/*
+ * Returns false if name is not one of the encoding names above.
+ */
+bool ParseMeshEncoding(const char* name, MeshEncoding* encoding);
+
+/*
+ * Returns false if value is not the numeric value of an encoding, as a
+ * version 1 pushdown command carries it.
+ */
+bool GetMeshEncoding(int value, MeshEncoding* encoding);
+
+/*
+ * Writes mesh to fileName in the given encoding. compression applies to the
+ * XML encoding only (0=none, 1=zlib, 2=lz4). Returns false on failure.
+ */
+bool WriteMesh(vtkPolyData* mesh, const char* fileName, MeshEncoding encoding, int compression);
+
+/*
+ * Reads a mesh written by WriteMesh(). A binary mesh is read with one
+ * header read and one vectored read landing directly in the vtkPoints and
+ * vtkCellArray buffers. Returns nullptr on failure.
+ */
+vtkSmartPointer<vtkPolyData> ReadMesh(const char* fileName, MeshEncoding encoding);
+
+#endif
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MeshStream.h"
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+struct ChunkHeader
+{
+  char Magic[4];
+  uint32_t Flags;
+  uint64_t NumberOfPoints;
+  uint64_t NumberOfTriangles;
+};
+static_assert(sizeof(ChunkHeader) == 24, "Unexpected stream chunk header layout");
+
+const char ChunkMagic[4] = { 'C', 'B', 'S', '1' };
+const uint32_t LastChunk = 1;
+
+bool PreadFully(int fd, void* data, size_t size, off_t offset)
+{
+  char* p = static_cast<char*>(data);
+  while (size)
+  {
+    ssize_t n = pread(fd, p, size, offset);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    p += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+}
+
+MeshStreamWriter::~MeshStreamWriter()
+{
+  if (this->FD >= 0)
+  {
+    close(this->FD);
+  }
+}
+
+bool MeshStreamWriter::Open(const char* fileName)
+{
+  this->FileName = fileName;
+  this->FD = open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (this->FD < 0)
+  {
+    perror(fileName);
+    return false;
+  }
+  return true;
+}
+
+bool MeshStreamWriter::Write(vtkPolyData* mesh)
+{
+  return this->WriteChunk(mesh, 0);
+}
+
+bool MeshStreamWriter::Close()
+{
+  bool ok = this->WriteChunk(nullptr, LastChunk);
+  if (close(this->FD) != 0)
+  {
+    ok = false;
+  }
+  this->FD = -1;
+  return ok;
+}
+
+bool MeshStreamWriter::WriteChunk(vtkPolyData* mesh, uint32_t flags)
+{
+  if (this->FD < 0)
+  {
+    return false;
+  }
+  ChunkHeader header;
+  memcpy(header.Magic, ChunkMagic, sizeof(header.Magic));
+  header.Flags = flags;
+  header.NumberOfPoints = 0;
+  header.NumberOfTriangles = 0;
+
+  vtkSmartPointer<vtkFloatArray> points;
+  std::vector<uint32_t> triangles;
+  if (mesh && mesh->GetNumberOfPoints())
+  {
+    points = vtkArrayDownCast<vtkFloatArray>(mesh->GetPoints()->GetData());
+    if (!points)
+    {
+      points = vtkSmartPointer<vtkFloatArray>::New();
+      points->DeepCopy(mesh->GetPoints()->GetData());
+    }
+    header.NumberOfPoints = mesh->GetNumberOfPoints();
+    vtkCellArray* polys = mesh->GetPolys();
+    const vtkIdType numCells = polys ? polys->GetNumberOfCells() : 0;
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+      vtkIdType npts;
+      const vtkIdType* pts;
+      polys->GetCellAtId(cellId, npts, pts);
+      for (vtkIdType i = 1; i + 1 < npts; i++)
+      {
+        triangles.push_back(static_cast<uint32_t>(pts[0]));
+        triangles.push_back(static_cast<uint32_t>(pts[i]));
+        triangles.push_back(static_cast<uint32_t>(pts[i + 1]));
+      }
+    }
+    header.NumberOfTriangles = triangles.size() / 3;
+  }
+
+  // One writev per chunk, so a reader mostly sees whole chunks
+  struct iovec iov[3] = { { &header, sizeof(header) },
+    { points ? points->GetPointer(0) : nullptr, 3 * sizeof(float) * header.NumberOfPoints },
+    { triangles.data(), sizeof(uint32_t) * triangles.size() } };
+  struct iovec* next = iov;
+  int left = 3;
+  while (left > 0)
+  {
+    ssize_t n = writev(this->FD, next, left);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      perror(this->FileName.c_str());
+      return false;
+    }
+    while (left > 0 && static_cast<size_t>(n) >= next->iov_len)
+    {
+      n -= next->iov_len;
+      next++;
+      left--;
+    }
+    if (left > 0)
+    {
+      next->iov_base = static_cast<char*>(next->iov_base) + n;
+      next->iov_len -= n;
+    }
+  }
+  return true;
+}
+
+MeshStreamReader::MeshStreamReader(const char* fileName)
+  : FileName(fileName)
+{
+}
+
+MeshStreamReader::~MeshStreamReader()
+{
+  if (this->FD >= 0)
+  {
+    close(this->FD);
+  }
+}
+
+bool MeshStreamReader::Poll(vtkPolyData* mesh)
+{
+  if (this->Finished)
+  {
+    return true;
+  }
+  if (this->FD < 0)
+  {
+    this->FD = open(this->FileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (this->FD < 0)
+    {
+      return true;
+    }
+  }
+  struct stat st;
+  if (fstat(this->FD, &st) != 0)
+  {
+    perror(this->FileName.c_str());
+    return false;
+  }
+
+  vtkFloatArray* coords = vtkArrayDownCast<vtkFloatArray>(mesh->GetPoints()->GetData());
+  vtkCellArray* polys = mesh->GetPolys();
+  std::vector<uint32_t> triangles;
+  const uint64_t numChunks = this->NumberOfChunks;
+  while (!this->Finished && this->Offset + static_cast<int64_t>(sizeof(ChunkHeader)) <= st.st_size)
+  {
+    ChunkHeader header;
+    if (!PreadFully(this->FD, &header, sizeof(header), this->Offset) ||
+      memcmp(header.Magic, ChunkMagic, 4) != 0)
+    {
+      std::cerr << "Malformed mesh stream: " << this->FileName << std::endl;
+      return false;
+    }
+    const uint64_t pointBytes = 3 * sizeof(float) * header.NumberOfPoints;
+    const uint64_t triangleBytes = 3 * sizeof(uint32_t) * header.NumberOfTriangles;
+    const int64_t end = this->Offset + sizeof(header) + pointBytes + triangleBytes;
+    if (end > st.st_size)
+    {
+      break; // Rest of the chunk is still being written
+    }
+
+    const vtkIdType base = coords->GetNumberOfTuples();
+    coords->SetNumberOfTuples(base + header.NumberOfPoints);
+    triangles.resize(3 * header.NumberOfTriangles);
+    if (!PreadFully(this->FD, coords->GetPointer(3 * base), pointBytes,
+          this->Offset + sizeof(header)) ||
+      !PreadFully(this->FD, triangles.data(), triangleBytes,
+        this->Offset + sizeof(header) + pointBytes))
+    {
+      std::cerr << "Malformed mesh stream: " << this->FileName << std::endl;
+      return false;
+    }
+    for (size_t t = 0; t < triangles.size(); t += 3)
+    {
+      const vtkIdType pts[3] = { base + triangles[t], base + triangles[t + 1],
+        base + triangles[t + 2] };
+      polys->InsertNextCell(3, pts);
+    }
+    this->Offset = end;
+    this->NumberOfChunks++;
+    this->Finished = (header.Flags & LastChunk) != 0;
+  }
+  if (this->NumberOfChunks != numChunks)
+  {
+    mesh->GetPoints()->Modified();
+    polys->Modified();
+    mesh->Modified();
+  }
+  return true;
+}
+
+void InitializeStreamMesh(vtkPolyData* mesh)
+{
+  vtkNew<vtkFloatArray> coords;
+  coords->SetNumberOfComponents(3);
+  vtkNew<vtkPoints> points;
+  points->SetData(coords);
+  vtkNew<vtkCellArray> polys;
+  mesh->Initialize();
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+}
+
+bool ReceiveMeshStreams(const std::vector<const char*>& fileNames,
+  const std::vector<vtkPolyData*>& meshes, const std::atomic<bool>& failed,
+  std::chrono::seconds idleTimeout, std::chrono::high_resolution_clock::time_point* firstChunk,
+  uint64_t* bytes, const std::function<void()>& progress)
+{
+  std::vector<MeshStreamReader> readers(fileNames.begin(), fileNames.end());
+  bool started = false;
+  auto lastProgress = std::chrono::steady_clock::now();
+  for (;;)
+  {
+    bool finished = true;
+    bool progressed = false;
+    for (size_t i = 0; i < readers.size(); i++)
+    {
+      const uint64_t numChunks = readers[i].GetNumberOfChunks();
+      if (!readers[i].Poll(meshes[i]))
+      {
+        return false;
+      }
+      if (readers[i].GetNumberOfChunks() != numChunks)
+      {
+        progressed = true;
+      }
+      finished = finished && readers[i].IsFinished();
+    }
+    if (progressed && !started)
+    {
+      started = true;
+      *firstChunk = std::chrono::high_resolution_clock::now();
+    }
+    if (progressed && progress)
+    {
+      progress();
+    }
+    if (finished)
+    {
+      break;
+    }
+    if (failed)
+    {
+      return false;
+    }
+    if (progressed)
+    {
+      lastProgress = std::chrono::steady_clock::now();
+    }
+    else if (std::chrono::steady_clock::now() - lastProgress > idleTimeout)
+    {
+      std::cerr << "No result stream grew for " << idleTimeout.count() << " s" << std::endl;
+      return false;
+    }
+    else
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  *bytes = 0;
+  for (const MeshStreamReader& reader : readers)
+  {
+    *bytes += reader.GetBytesRead();
+  }
+  return true;
+}
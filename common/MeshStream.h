@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MeshStream_h
+#define MeshStream_h
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class vtkPolyData;
+
+/*
+ * Chunked isosurface stream: a result file that grows by one self-contained
+ * chunk at a time while the Offloader is still contouring, so the runner can
+ * fetch and decode early chunks in parallel. Each chunk is
+ *   char     magic[4] = "CBS1"
+ *   uint32_t flags (1 = last chunk of the stream)
+ *   uint64_t number of points
+ *   uint64_t number of triangles
+ *   float    points[3 * number of points]
+ *   uint32_t triangles[3 * number of triangles], indices local to the chunk
+ * Points on the boundary between two chunks appear in both.
+ */
+class MeshStreamWriter
+{
+public:
+  MeshStreamWriter() = default;
+  ~MeshStreamWriter();
+  MeshStreamWriter(const MeshStreamWriter&) = delete;
+  void operator=(const MeshStreamWriter&) = delete;
+
+  /*
+   * Creates (or truncates) the result file.
+   */
+  bool Open(const char* fileName);
+
+  /*
+   * Appends mesh as one chunk. Only its triangles are kept.
+   */
+  bool Write(vtkPolyData* mesh);
+
+  /*
+   * Appends the closing chunk and closes the file.
+   */
+  bool Close();
+
+private:
+  bool WriteChunk(vtkPolyData* mesh, uint32_t flags);
+
+  int FD = -1;
+  std::string FileName;
+};
+
+class MeshStreamReader
+{
+public:
+  explicit MeshStreamReader(const char* fileName);
+  ~MeshStreamReader();
+  MeshStreamReader(const MeshStreamReader&) = delete;
+  void operator=(const MeshStreamReader&) = delete;
+
+  /*
+   * Appends every chunk that is completely on disk to mesh, without
+   * blocking. A missing file is not an error: the Offloader may not have
+   * created it yet. Returns false on a malformed stream.
+   */
+  bool Poll(vtkPolyData* mesh);
+
+  /*
+   * True once the closing chunk has been read.
+   */
+  bool IsFinished() const { return this->Finished; }
+
+  uint64_t GetNumberOfChunks() const { return this->NumberOfChunks; }
+  uint64_t GetBytesRead() const { return static_cast<uint64_t>(this->Offset); }
+
+private:
+  std::string FileName;
+  int FD = -1;
+  int64_t Offset = 0;
+  uint64_t NumberOfChunks = 0;
+  bool Finished = false;
+};
+
+/*
+ * Empties mesh and gives it float points and polygons to append chunks to.
+ */
+void InitializeStreamMesh(vtkPolyData* mesh);
+
+/*
+ * How long a runner waits for its result streams to grow. The command-file
+ * transport has no reply, so an Offloader that died or cannot write its
+ * results is only noticed by its streams stalling.
+ */
+const std::chrono::seconds StreamIdleTimeout(600);
+
+/*
+ * How often a runner re-renders its result streams while chunks land. Every
+ * render uploads the meshes again, so rendering each chunk would slow the
+ * receive loop down.
+ */
+const std::chrono::milliseconds StreamRenderInterval(100);
+
+/*
+ * Polls the stream fileNames[i] into meshes[i] until every stream is
+ * finished. firstChunk is set to the time the first chunk of any stream was
+ * appended and bytes to the total stream size. progress, if set, is called
+ * on this thread after every poll that appended chunks, so that a caller
+ * rendering the meshes sees them grow without racing the appends. Gives up,
+ * returning false, once failed becomes true (e.g. the pushdown server
+ * reported an error) or no stream grew for idleTimeout.
+ */
+bool ReceiveMeshStreams(const std::vector<const char*>& fileNames,
+  const std::vector<vtkPolyData*>& meshes, const std::atomic<bool>& failed,
+  std::chrono::seconds idleTimeout, std::chrono::high_resolution_clock::time_point* firstChunk,
+  uint64_t* bytes, const std::function<void()>& progress);
+
+#endif
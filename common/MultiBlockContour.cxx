@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MultiBlockContour.h"
+#include "PartitionedGrid.h"
+#include "ThreadPool.h"
+
+#include <vtkCellData.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDataArraySelection.h>
+#include <vtkDataObjectTreeIterator.h>
+#include <vtkDataSet.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkXMLMultiBlockDataReader.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+
+namespace
+{
+/*
+ * Whether every block file a .vtm references exists. vtkXMLMultiBlockDataReader
+ * reads a missing block as an empty node, which would silently leave it out
+ * of the surface.
+ */
+bool HasBlockFiles(const char* fileName)
+{
+  std::vector<std::string> files;
+  if (!GetBlockFiles(fileName, &files))
+  {
+    return false;
+  }
+  for (const std::string& block : files)
+  {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(block, ec))
+    {
+      std::cerr << "Missing block " << block << " of " << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Per-point sums and counts of the values of the cells using each point.
+ */
+struct BlockAccumulator
+{
+  std::vector<std::vector<double>> Sums; // One per array
+  std::vector<uint32_t> Counts;
+  std::vector<vtkIdType> BoundaryPoints;
+  std::vector<int> ValueTypes;
+};
+
+struct PointKey
+{
+  double X[3];
+
+  bool operator==(const PointKey& other) const
+  {
+    return this->X[0] == other.X[0] && this->X[1] == other.X[1] && this->X[2] == other.X[2];
+  }
+};
+
+struct PointKeyHash
+{
+  size_t operator()(const PointKey& key) const
+  {
+    uint64_t h = 0;
+    for (double v : key.X)
+    {
+      v = v == 0 ? 0 : v; // -0 and 0 are the same point
+      uint64_t bits;
+      memcpy(&bits, &v, sizeof(bits));
+      h ^= bits + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+struct SharedPoint
+{
+  std::vector<double> Sums;
+  uint32_t Count = 0;
+};
+
+void Accumulate(
+  vtkDataSet* block, const std::vector<std::string>& arrays, BlockAccumulator* accumulator)
+{
+  const vtkIdType numPoints = block->GetNumberOfPoints();
+  std::vector<vtkDataArray*> values;
+  for (const std::string& array : arrays)
+  {
+    vtkDataArray* cellValues = block->GetCellData()->GetArray(array.c_str());
+    values.push_back(cellValues);
+    accumulator->Sums.emplace_back(cellValues ? numPoints : 0, 0.0);
+    accumulator->ValueTypes.push_back(cellValues ? cellValues->GetDataType() : VTK_FLOAT);
+  }
+  accumulator->Counts.assign(numPoints, 0);
+
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < block->GetNumberOfCells(); cellId++)
+  {
+    block->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); i++)
+    {
+      accumulator->Counts[ptIds->GetId(i)]++;
+    }
+    for (size_t a = 0; a < values.size(); a++)
+    {
+      if (!values[a])
+      {
+        continue;
+      }
+      const double v = values[a]->GetComponent(cellId, 0);
+      for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); i++)
+      {
+        accumulator->Sums[a][ptIds->GetId(i)] += v;
+      }
+    }
+  }
+
+  double bounds[6];
+  block->GetBounds(bounds);
+  double x[3];
+  for (vtkIdType ptId = 0; ptId < numPoints; ptId++)
+  {
+    block->GetPoint(ptId, x);
+    if (x[0] == bounds[0] || x[0] == bounds[1] || x[1] == bounds[2] || x[1] == bounds[3] ||
+      x[2] == bounds[4] || x[2] == bounds[5])
+    {
+      accumulator->BoundaryPoints.push_back(ptId);
+    }
+  }
+}
+
+/*
+ * Sums the contributions of all blocks sharing each boundary point, then
+ * hands the totals back to every one of them.
+ */
+void ShareBoundaryPoints(const std::vector<vtkSmartPointer<vtkDataSet>>& blocks,
+  std::vector<BlockAccumulator>& accumulators, size_t numArrays)
+{
+  std::unordered_map<PointKey, SharedPoint, PointKeyHash> shared;
+  PointKey key;
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    BlockAccumulator& acc = accumulators[b];
+    for (vtkIdType ptId : acc.BoundaryPoints)
+    {
+      blocks[b]->GetPoint(ptId, key.X);
+      SharedPoint& point = shared[key];
+      point.Sums.resize(numArrays, 0.0);
+      point.Count += acc.Counts[ptId];
+      for (size_t a = 0; a < numArrays; a++)
+      {
+        if (!acc.Sums[a].empty())
+        {
+          point.Sums[a] += acc.Sums[a][ptId];
+        }
+      }
+    }
+  }
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    BlockAccumulator& acc = accumulators[b];
+    for (vtkIdType ptId : acc.BoundaryPoints)
+    {
+      blocks[b]->GetPoint(ptId, key.X);
+      const SharedPoint& point = shared[key];
+      acc.Counts[ptId] = point.Count;
+      for (size_t a = 0; a < numArrays; a++)
+      {
+        if (!acc.Sums[a].empty())
+        {
+          acc.Sums[a][ptId] = point.Sums[a];
+        }
+      }
+    }
+  }
+}
+
+vtkSmartPointer<vtkDataSet> MakePointData(vtkDataSet* block,
+  const std::vector<std::string>& arrays, BlockAccumulator* accumulator)
+{
+  vtkSmartPointer<vtkDataSet> output = vtkSmartPointer<vtkDataSet>::Take(block->NewInstance());
+  output->ShallowCopy(block);
+  const vtkIdType numPoints = block->GetNumberOfPoints();
+  for (size_t a = 0; a < arrays.size(); a++)
+  {
+    std::vector<double>& sums = accumulator->Sums[a];
+    if (sums.empty())
+    {
+      continue;
+    }
+    vtkSmartPointer<vtkDataArray> values = vtkSmartPointer<vtkDataArray>::Take(
+      vtkDataArray::CreateDataArray(accumulator->ValueTypes[a]));
+    values->SetName(arrays[a].c_str());
+    values->SetNumberOfTuples(numPoints);
+    for (vtkIdType ptId = 0; ptId < numPoints; ptId++)
+    {
+      const uint32_t count = accumulator->Counts[ptId];
+      values->SetTuple1(ptId, count ? sums[ptId] / count : 0);
+    }
+    std::vector<double>().swap(sums);
+    output->GetPointData()->AddArray(values);
+  }
+  return output;
+}
+}
+
+bool GetBlockFiles(const char* fileName, std::vector<std::string>* files)
+{
+  std::ifstream input(fileName);
+  if (!input)
+  {
+    std::cerr << "Cannot open " << fileName << std::endl;
+    return false;
+  }
+  std::ostringstream text;
+  text << input.rdbuf();
+  const std::string xml = text.str();
+  const std::filesystem::path path(fileName);
+  const std::filesystem::path dir = path.has_parent_path() ? path.parent_path() : ".";
+  const std::string attribute = "file=\"";
+  files->clear();
+  for (size_t pos = xml.find(attribute); pos != std::string::npos; pos = xml.find(attribute, pos))
+  {
+    pos += attribute.size();
+    const size_t end = xml.find('"', pos);
+    if (end == std::string::npos)
+    {
+      break;
+    }
+    files->push_back((dir / xml.substr(pos, end - pos)).string());
+    pos = end;
+  }
+  return true;
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> ReadMultiBlock(
+  const char* fileName, const std::vector<std::string>& arrays)
+{
+  if (!HasBlockFiles(fileName))
+  {
+    return std::vector<vtkSmartPointer<vtkDataSet>>();
+  }
+  vtkNew<vtkXMLMultiBlockDataReader> reader;
+  reader->SetFileName(fileName);
+  reader->UpdateInformation();
+  vtkDataArraySelection* sel = reader->GetCellDataArraySelection();
+  sel->DisableAllArrays();
+  for (const std::string& array : arrays)
+  {
+    sel->EnableArray(array.c_str());
+  }
+  reader->GetPointDataArraySelection()->DisableAllArrays();
+  reader->Update();
+  if (reader->GetErrorCode() != 0)
+  {
+    std::cerr << "Cannot read " << fileName << std::endl;
+    return std::vector<vtkSmartPointer<vtkDataSet>>();
+  }
+  std::vector<vtkSmartPointer<vtkDataSet>> blocks = GetLeafBlocks(reader->GetOutputDataObject(0));
+  if (blocks.empty())
+  {
+    std::cerr << "No blocks in " << fileName << std::endl;
+  }
+  return blocks;
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> GetLeafBlocks(vtkDataObject* input)
+{
+  std::vector<vtkSmartPointer<vtkDataSet>> blocks;
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(input))
+  {
+    if (ds->GetNumberOfCells() > 0)
+    {
+      blocks.push_back(ds);
+    }
+    return blocks;
+  }
+  vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(input);
+  if (!composite)
+  {
+    return blocks;
+  }
+  vtkNew<vtkDataObjectTreeIterator> it;
+  it->SetDataSet(composite);
+  it->VisitOnlyLeavesOn();
+  it->TraverseSubTreeOn();
+  it->SetSkipEmptyNodes(1);
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+  {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(it->GetCurrentDataObject());
+    if (ds && ds->GetNumberOfCells() > 0)
+    {
+      blocks.push_back(ds);
+    }
+  }
+  return blocks;
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> BlockCellDataToPointData(
+  const std::vector<vtkSmartPointer<vtkDataSet>>& blocks, const std::vector<std::string>& arrays,
+  ThreadPool* pool)
+{
+  std::vector<BlockAccumulator> accumulators(blocks.size());
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    pool->Submit([&, b]() { Accumulate(blocks[b], arrays, &accumulators[b]); });
+  }
+  pool->Wait();
+  ShareBoundaryPoints(blocks, accumulators, arrays.size());
+  std::vector<vtkSmartPointer<vtkDataSet>> outputs(blocks.size());
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    pool->Submit([&, b]() { outputs[b] = MakePointData(blocks[b], arrays, &accumulators[b]); });
+  }
+  pool->Wait();
+  return outputs;
+}
+
+std::vector<vtkSmartPointer<vtkPolyData>> ContourBlocks(
+  const std::vector<vtkSmartPointer<vtkDataSet>>& blocks,
+  const std::vector<ContourRequest>& requests, ThreadPool* pool)
+{
+  std::vector<std::vector<vtkSmartPointer<vtkPolyData>>> blockMeshes(blocks.size());
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    pool->Submit([&, b]() { blockMeshes[b] = FusedContour(blocks[b], requests); });
+  }
+  pool->Wait();
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    std::vector<vtkSmartPointer<vtkPolyData>> parts;
+    for (const std::vector<vtkSmartPointer<vtkPolyData>>& block : blockMeshes)
+    {
+      parts.push_back(block[i]);
+    }
+    meshes.push_back(AppendMeshes(parts));
+  }
+  return meshes;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MultiBlockContour_h
+#define MultiBlockContour_h
+
+#include "FusedContour.h"
+
+#include <vtkSmartPointer.h>
+
+#include <string>
+#include <vector>
+
+class ThreadPool;
+class vtkDataObject;
+class vtkDataSet;
+class vtkPolyData;
+
+/*
+ * Paths of the block files a multiblock (.vtm) references, relative to the
+ * working directory, in the order they appear. Returns false if the .vtm
+ * cannot be read.
+ */
+bool GetBlockFiles(const char* fileName, std::vector<std::string>* files);
+
+/*
+ * Reads a multiblock (.vtm) with only the given cell arrays and returns its
+ * non-empty leaf datasets, in traversal order. Returns an empty list on
+ * failure, including when a block file it references is missing.
+ */
+std::vector<vtkSmartPointer<vtkDataSet>> ReadMultiBlock(
+  const char* fileName, const std::vector<std::string>& arrays);
+
+/*
+ * Non-empty leaf datasets of input (input itself if it is a dataset).
+ */
+std::vector<vtkSmartPointer<vtkDataSet>> GetLeafBlocks(vtkDataObject* input);
+
+/*
+ * Converts the given cell arrays of every block to point arrays, one pool
+ * task per block, and returns shallow copies of the blocks carrying them.
+ * Like vtkCellDataToPointData, a point takes the average of the cells using
+ * it; points on a block's bounding box also take the cells of the other
+ * blocks sharing that exact point, so fields agree across block faces and
+ * contours do not crack there. AMR hanging nodes (fine points on a coarse
+ * face) have no coarse counterpart and only see their own block.
+ */
+std::vector<vtkSmartPointer<vtkDataSet>> BlockCellDataToPointData(
+  const std::vector<vtkSmartPointer<vtkDataSet>>& blocks, const std::vector<std::string>& arrays,
+  ThreadPool* pool);
+
+/*
+ * Contours every block with one fused pass, one pool task per block, and
+ * appends the blocks' meshes into one mesh per request.
+ */
+std::vector<vtkSmartPointer<vtkPolyData>> ContourBlocks(
+  const std::vector<vtkSmartPointer<vtkDataSet>>& blocks,
+  const std::vector<ContourRequest>& requests, ThreadPool* pool);
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NyxHDF5Reader.h"
+
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+
+#include <iostream>
+#include <stdio.h>
+
+#ifdef CONTOUR_BENCH_HAS_HDF5
+#include <hdf5.h>
+#endif
+
+const char* const NyxDensityDataset = "native_fields/baryon_density";
+
+#ifdef CONTOUR_BENCH_HAS_HDF5
+namespace
+{
+/*
+ * Closes an HDF5 handle when leaving scope.
+ */
+class Handle
+{
+public:
+  Handle(hid_t id, herr_t (*close)(hid_t))
+    : Id(id)
+    , Close(close)
+  {
+  }
+  ~Handle()
+  {
+    if (this->Id >= 0)
+    {
+      this->Close(this->Id);
+    }
+  }
+  operator hid_t() const { return this->Id; }
+  bool IsValid() const { return this->Id >= 0; }
+
+private:
+  Handle(const Handle&) = delete;
+  void operator=(const Handle&) = delete;
+
+  hid_t Id;
+  herr_t (*Close)(hid_t);
+};
+
+/*
+ * Reads a 3-value attribute of the "domain" group, if there is one.
+ */
+bool ReadDomainAttribute(hid_t file, const char* name, double values[3])
+{
+  if (H5Lexists(file, "domain", H5P_DEFAULT) <= 0 ||
+    H5Aexists_by_name(file, "domain", name, H5P_DEFAULT) <= 0)
+  {
+    return false;
+  }
+  Handle attribute(H5Aopen_by_name(file, "domain", name, H5P_DEFAULT, H5P_DEFAULT), H5Aclose);
+  Handle space(attribute.IsValid() ? H5Aget_space(attribute) : -1, H5Sclose);
+  return space.IsValid() && H5Sget_simple_extent_npoints(space) == 3 &&
+    H5Aread(attribute, H5T_NATIVE_DOUBLE, values) >= 0;
+}
+}
+#endif
+
+vtkSmartPointer<vtkImageData> ReadNyxHDF5(
+  const char* fileName, const std::string& dataset, const char* arrayName, const int* extent)
+{
+#ifdef CONTOUR_BENCH_HAS_HDF5
+  H5Eset_auto(H5E_DEFAULT, nullptr, nullptr); // Failures are reported below instead
+  Handle file(H5Fopen(fileName, H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose);
+  if (!file.IsValid())
+  {
+    std::cerr << "Cannot open HDF5 file " << fileName << std::endl;
+    return nullptr;
+  }
+  Handle data(H5Dopen(file, dataset.c_str(), H5P_DEFAULT), H5Dclose);
+  if (!data.IsValid())
+  {
+    std::cerr << "No dataset " << dataset << " in " << fileName << std::endl;
+    return nullptr;
+  }
+  Handle fileSpace(H5Dget_space(data), H5Sclose);
+  Handle type(H5Dget_type(data), H5Tclose);
+  hsize_t shape[3];
+  if (H5Sget_simple_extent_ndims(fileSpace) != 3 || H5Tget_class(type) != H5T_FLOAT)
+  {
+    std::cerr << "Dataset " << dataset << " is not a 3D float volume" << std::endl;
+    return nullptr;
+  }
+  H5Sget_simple_extent_dims(fileSpace, shape, nullptr);
+
+  // HDF5 dimension 2 is x
+  int whole[6] = { 0, static_cast<int>(shape[2]) - 1, 0, static_cast<int>(shape[1]) - 1, 0,
+    static_cast<int>(shape[0]) - 1 };
+  int ext[6];
+  for (int i = 0; i < 6; i++)
+  {
+    ext[i] = extent ? extent[i] : whole[i];
+  }
+  hsize_t start[3], count[3];
+  for (int c = 0; c < 3; c++)
+  {
+    if (ext[2 * c] < 0 || ext[2 * c] > ext[2 * c + 1] || ext[2 * c + 1] > whole[2 * c + 1])
+    {
+      std::cerr << "Extent outside of dataset " << dataset << std::endl;
+      return nullptr;
+    }
+    start[2 - c] = ext[2 * c];
+    count[2 - c] = ext[2 * c + 1] - ext[2 * c] + 1;
+  }
+  if (H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, count, nullptr) < 0)
+  {
+    std::cerr << "Cannot select hyperslab of " << dataset << std::endl;
+    return nullptr;
+  }
+  Handle memSpace(H5Screate_simple(3, count, nullptr), H5Sclose);
+
+  const bool isDouble = H5Tget_size(type) > sizeof(float);
+  vtkSmartPointer<vtkDataArray> values;
+  if (isDouble)
+  {
+    values = vtkSmartPointer<vtkDoubleArray>::New();
+  }
+  else
+  {
+    values = vtkSmartPointer<vtkFloatArray>::New();
+  }
+  values->SetName(arrayName);
+  values->SetNumberOfTuples(static_cast<vtkIdType>(count[0] * count[1] * count[2]));
+  if (H5Dread(data, isDouble ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT, memSpace, fileSpace,
+        H5P_DEFAULT, values->GetVoidPointer(0)) < 0)
+  {
+    std::cerr << "Cannot read dataset " << dataset << " of " << fileName << std::endl;
+    return nullptr;
+  }
+
+  double spacing[3] = { 1, 1, 1 };
+  double size[3], domainShape[3];
+  if (ReadDomainAttribute(file, "size", size) && ReadDomainAttribute(file, "shape", domainShape))
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      spacing[c] = domainShape[c] > 0 ? size[c] / domainShape[c] : 1;
+    }
+  }
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(ext);
+  image->SetOrigin(0, 0, 0);
+  image->SetSpacing(spacing);
+  image->GetPointData()->AddArray(values);
+  image->GetPointData()->SetActiveScalars(arrayName);
+  return image;
+#else
+  std::cerr << "Cannot read " << fileName << ": built without HDF5 (CONTOUR_BENCH_USE_HDF5)"
+            << std::endl;
+  return nullptr;
+#endif
+}
+
+bool IsHDF5File(const std::string& fileName)
+{
+  auto endsWith = [&](const char* suffix) {
+    const std::string s(suffix);
+    return fileName.size() > s.size() &&
+      fileName.compare(fileName.size() - s.size(), s.size(), s) == 0;
+  };
+  return endsWith(".h5") || endsWith(".hdf5");
+}
+
+bool ParseExtent(const char* text, int extent[6])
+{
+  return sscanf(text, "%d,%d,%d,%d,%d,%d", &extent[0], &extent[1], &extent[2], &extent[3],
+           &extent[4], &extent[5]) == 6;
+}
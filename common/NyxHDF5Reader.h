@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NyxHDF5Reader_h
+#define NyxHDF5Reader_h
+
+#include <vtkSmartPointer.h>
+
+#include <string>
+
+class vtkImageData;
+
+/*
+ * Default location of the density in Nyx HDF5 output.
+ */
+extern const char* const NyxDensityDataset;
+
+/*
+ * Reads one 3D float or double dataset of a Nyx HDF5 file (C order, so the
+ * last dimension is x) straight into the point array arrayName of an image;
+ * the dataset is read directly into the array's buffer, with no staging
+ * copy, and nothing else in the file is touched. If extent is given (xmin,
+ * xmax, ymin, ymax, zmin, zmax in sample indices, inclusive) only that
+ * hyperslab is read and the image keeps that extent. Spacing comes from the
+ * "domain" group's "size" and "shape" attributes when present (1 otherwise),
+ * with the origin at 0. Returns nullptr, after printing why, on failure or
+ * when built without HDF5 (CONTOUR_BENCH_USE_HDF5).
+ */
+vtkSmartPointer<vtkImageData> ReadNyxHDF5(const char* fileName, const std::string& dataset,
+  const char* arrayName, const int* extent = nullptr);
+
+/*
+ * Whether fileName looks like HDF5 output (.h5 or .hdf5).
+ */
+bool IsHDF5File(const std::string& fileName);
+
+/*
+ * Parses "xmin,xmax,ymin,ymax,zmin,zmax". Returns false on anything else.
+ */
+bool ParseExtent(const char* text, int extent[6]);
+
+#endif
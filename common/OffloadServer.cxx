@@ -0,0 +1,790 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "OffloadServer.h"
+#include "BenchStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <errno.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <poll.h>
+#include <signal.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+volatile sig_atomic_t StopRequested = 0;
+
+void OnStopSignal(int)
+{
+  StopRequested = 1;
+}
+
+void InstallStopHandlers()
+{
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = OnStopSignal; // No SA_RESTART so that blocking calls return EINTR
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+}
+
+bool ReadFile(const char* path, std::string* content)
+{
+  std::ifstream input(path, std::ios::in | std::ios::binary);
+  if (!input)
+  {
+    return false;
+  }
+  std::ostringstream ss;
+  ss << input.rdbuf();
+  *content = ss.str();
+  return true;
+}
+
+bool ReadAll(int fd, std::string* content)
+{
+  char buf[4096];
+  for (;;)
+  {
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0)
+    {
+      if (errno == EINTR && !StopRequested)
+      {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0)
+    {
+      return true;
+    }
+    content->append(buf, n);
+  }
+}
+
+bool WriteAll(int fd, const std::string& content)
+{
+  const char* p = content.data();
+  size_t left = content.size();
+  while (left)
+  {
+    ssize_t n = write(fd, p, left);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    left -= n;
+  }
+  return true;
+}
+
+bool GetSocketAddress(const char* socketPath, struct sockaddr_un* addr)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (strlen(socketPath) >= sizeof(addr->sun_path))
+  {
+    std::cerr << "Socket path too long: " << socketPath << std::endl;
+    return false;
+  }
+  strncpy(addr->sun_path, socketPath, sizeof(addr->sun_path) - 1);
+  return true;
+}
+
+/*
+ * Listens on socketPath, replacing a socket a previous server left behind.
+ * Returns the listening socket, or -1 on failure.
+ */
+int ListenOnSocket(const char* socketPath, int backlog)
+{
+  struct sockaddr_un addr;
+  if (!GetSocketAddress(socketPath, &addr))
+  {
+    return -1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+  {
+    perror("socket");
+    return -1;
+  }
+  unlink(socketPath);
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+    listen(fd, backlog) != 0)
+  {
+    perror(socketPath);
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int Answer(const QueryHandler& handler, const std::string& command, LatencyStats* stats)
+{
+  auto t0 = std::chrono::high_resolution_clock::now();
+  int rc = handler(command);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  double latency = std::chrono::duration<double>(t1 - t0).count();
+  stats->Add(latency);
+  std::cout << "query: " << latency << std::endl;
+  if (rc != 0)
+  {
+    std::cerr << "Query failed (" << rc << "): " << command << std::endl;
+  }
+  return rc;
+}
+
+bool SameFileState(const struct stat& a, const struct stat& b)
+{
+  return a.st_ino == b.st_ino && a.st_size == b.st_size && a.st_mtim.tv_sec == b.st_mtim.tv_sec &&
+    a.st_mtim.tv_nsec == b.st_mtim.tv_nsec;
+}
+
+/*
+ * Fallback for file systems without inotify support (e.g. some FUSE mounts).
+ */
+int PollCommandFile(const char* commandFile, const QueryHandler& handler, LatencyStats* stats)
+{
+  struct stat last;
+  bool exists = stat(commandFile, &last) == 0;
+  const struct timespec interval = { 0, 5 * 1000 * 1000 };
+  std::cout << "polling: " << commandFile << std::endl;
+  while (!StopRequested)
+  {
+    nanosleep(&interval, nullptr);
+    struct stat st;
+    if (stat(commandFile, &st) != 0)
+    {
+      exists = false;
+      continue;
+    }
+    if (exists && SameFileState(st, last))
+    {
+      continue;
+    }
+    exists = true;
+    last = st;
+    std::string command;
+    if (ReadFile(commandFile, &command) && !command.empty())
+    {
+      Answer(handler, command, stats);
+    }
+  }
+  return 0;
+}
+
+/*
+ * Queue of pending requests in front of a fixed pool of workers, recording
+ * how long each request waited and how long it took to answer.
+ */
+class RequestScheduler
+{
+public:
+  RequestScheduler(const PooledQueryHandler& handler, const ServePool& pool);
+
+  /*
+   * Answers the requests still queued, then reports the wait, service and
+   * total latencies.
+   */
+  ~RequestScheduler();
+
+  /*
+   * Queues command; done receives the handler's result on the worker.
+   */
+  void Submit(const std::string& label, const std::string& command,
+    std::function<void(int rc)> done);
+
+private:
+  struct Request
+  {
+    uint64_t Sequence;
+    std::string Label;
+    std::string Command;
+    double Cost;
+    std::chrono::high_resolution_clock::time_point Queued;
+    std::function<void(int rc)> Done;
+  };
+
+  void Work(int worker);
+
+  PooledQueryHandler Handler;
+  ServePool Pool;
+  std::vector<std::thread> Workers;
+  std::deque<Request> Queue;
+  std::mutex Mutex;
+  std::condition_variable Ready;
+  bool Stopping = false;
+  uint64_t Sequence = 0;
+  LatencyStats Wait;
+  LatencyStats Service;
+  LatencyStats Total;
+};
+
+RequestScheduler::RequestScheduler(const PooledQueryHandler& handler, const ServePool& pool)
+  : Handler(handler)
+  , Pool(pool)
+{
+  const int workers = std::max(pool.Workers, 1);
+  std::cout << "workers: " << workers << std::endl
+            << "schedule: "
+            << (pool.Policy == SchedulePolicy::ShortestJobFirst ? "sjf" : "fifo") << std::endl;
+  for (int i = 0; i < workers; i++)
+  {
+    this->Workers.emplace_back(&RequestScheduler::Work, this, i);
+  }
+}
+
+RequestScheduler::~RequestScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Stopping = true;
+  }
+  this->Ready.notify_all();
+  for (std::thread& worker : this->Workers)
+  {
+    worker.join();
+  }
+  this->Wait.Print(std::cout, "wait");
+  this->Service.Print(std::cout, "service");
+  this->Total.Print(std::cout, "query");
+}
+
+void RequestScheduler::Submit(
+  const std::string& label, const std::string& command, std::function<void(int rc)> done)
+{
+  Request request;
+  request.Label = label;
+  request.Command = command;
+  request.Cost = this->Pool.Policy == SchedulePolicy::ShortestJobFirst && this->Pool.EstimateCost
+    ? this->Pool.EstimateCost(command)
+    : 0;
+  request.Queued = std::chrono::high_resolution_clock::now();
+  request.Done = std::move(done);
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    request.Sequence = this->Sequence++;
+    this->Queue.push_back(std::move(request));
+  }
+  this->Ready.notify_one();
+}
+
+void RequestScheduler::Work(int worker)
+{
+  for (;;)
+  {
+    Request request;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Ready.wait(lock, [this]() { return this->Stopping || !this->Queue.empty(); });
+      if (this->Queue.empty())
+      {
+        return;
+      }
+      auto next = this->Queue.begin();
+      if (this->Pool.Policy == SchedulePolicy::ShortestJobFirst)
+      {
+        next = std::min_element(this->Queue.begin(), this->Queue.end(),
+          [](const Request& a, const Request& b) {
+            return a.Cost < b.Cost || (a.Cost == b.Cost && a.Sequence < b.Sequence);
+          });
+      }
+      request = std::move(*next);
+      this->Queue.erase(next);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    int rc = this->Handler(request.Command, worker);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    request.Done(rc);
+    double wait = std::chrono::duration<double>(t1 - request.Queued).count();
+    double service = std::chrono::duration<double>(t2 - t1).count();
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Wait.Add(wait);
+    this->Service.Add(service);
+    this->Total.Add(wait + service);
+    std::cout << "request-" << request.Label << "-wait: " << wait << std::endl
+              << "request-" << request.Label << "-service: " << service << std::endl;
+    if (rc != 0)
+    {
+      std::cerr << "Request " << request.Label << " failed (" << rc << ")" << std::endl;
+    }
+  }
+}
+
+void WriteSpoolStatus(const std::string& spoolDir, const std::string& requestId, int rc)
+{
+  const std::string path = spoolDir + "/" + requestId + ".done";
+  const std::string temp = spoolDir + "/." + requestId + ".done.tmp";
+  std::ofstream status(temp, std::ios::out | std::ios::trunc);
+  status << (rc == 0 ? std::string("ok") : "error " + std::to_string(rc)) << std::endl;
+  status.close();
+  if (!status || rename(temp.c_str(), path.c_str()) != 0)
+  {
+    perror(path.c_str());
+  }
+}
+
+/*
+ * Claims every complete command in the spool (oldest first) by removing it,
+ * and queues it. Files being written carry a leading '.' until renamed.
+ */
+void ClaimSpooled(const std::string& spoolDir, const ServePool& pool, RequestScheduler* scheduler)
+{
+  std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> spooled;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(spoolDir, ec))
+  {
+    const std::filesystem::path& path = entry.path();
+    if (path.extension() == ".cmd" && path.filename().string()[0] != '.')
+    {
+      spooled.emplace_back(entry.last_write_time(ec), path);
+    }
+  }
+  std::sort(spooled.begin(), spooled.end());
+  for (const auto& file : spooled)
+  {
+    std::string command;
+    if (!ReadFile(file.second.c_str(), &command) || !std::filesystem::remove(file.second, ec))
+    {
+      continue;
+    }
+    const std::string requestId = file.second.stem().string();
+    if (pool.MatchRequestId && !pool.MatchRequestId(command, requestId))
+    {
+      // Its results would go where another request expects its own
+      std::cerr << "Request id of " << file.second.string() << " does not match its command"
+                << std::endl;
+      WriteSpoolStatus(spoolDir, requestId, EXIT_FAILURE);
+      continue;
+    }
+    scheduler->Submit(requestId, command,
+      [spoolDir, requestId](int rc) { WriteSpoolStatus(spoolDir, requestId, rc); });
+  }
+}
+}
+
+int ServeOnce(const char* commandFile, const QueryHandler& handler)
+{
+  std::string command;
+  if (!ReadFile(commandFile, &command))
+  {
+    return EXIT_FAILURE;
+  }
+  return handler(command);
+}
+
+int ServeWatch(const char* commandFile, const QueryHandler& handler)
+{
+  InstallStopHandlers();
+  LatencyStats stats;
+  std::filesystem::path path(commandFile);
+  std::string dir = path.has_parent_path() ? path.parent_path().string() : ".";
+  std::string name = path.filename().string();
+
+  int fd = inotify_init1(IN_CLOEXEC);
+  int wd = fd < 0 ? -1 : inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (wd < 0)
+  {
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+    PollCommandFile(commandFile, handler, &stats);
+    stats.Print(std::cout, "query");
+    return 0;
+  }
+
+  std::cout << "watching: " << commandFile << std::endl;
+  alignas(struct inotify_event) char buf[4096];
+  while (!StopRequested)
+  {
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      perror("inotify");
+      break;
+    }
+    bool triggered = false;
+    for (char* p = buf; p < buf + n;)
+    {
+      const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(p);
+      if (ev->len && name == ev->name)
+      {
+        triggered = true;
+      }
+      p += sizeof(struct inotify_event) + ev->len;
+    }
+    std::string command;
+    if (triggered && ReadFile(commandFile, &command) && !command.empty())
+    {
+      Answer(handler, command, &stats);
+    }
+  }
+  close(fd);
+  stats.Print(std::cout, "query");
+  return 0;
+}
+
+int ServeSocket(const char* socketPath, const QueryHandler& handler)
+{
+  int fd = ListenOnSocket(socketPath, 16);
+  if (fd < 0)
+  {
+    return EXIT_FAILURE;
+  }
+
+  InstallStopHandlers();
+  LatencyStats stats;
+  std::cout << "listening: " << socketPath << std::endl;
+  while (!StopRequested)
+  {
+    int conn = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (conn < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      perror("accept");
+      break;
+    }
+    std::string command;
+    if (ReadAll(conn, &command) && !command.empty())
+    {
+      int rc = Answer(handler, command, &stats);
+      WriteAll(conn, rc == 0 ? std::string("ok\n") : "error " + std::to_string(rc) + "\n");
+    }
+    close(conn);
+  }
+  close(fd);
+  unlink(socketPath);
+  stats.Print(std::cout, "query");
+  return 0;
+}
+
+int ServeSocketPool(const char* socketPath, const PooledQueryHandler& handler,
+  const ServePool& pool)
+{
+  int fd = ListenOnSocket(socketPath, 64);
+  if (fd < 0)
+  {
+    return EXIT_FAILURE;
+  }
+
+  InstallStopHandlers();
+  std::cout << "listening: " << socketPath << std::endl;
+  // Commands are read as their bytes arrive, polled together with new
+  // connections, so a slow or stuck client cannot hold up everyone else's
+  struct Connection
+  {
+    int FD;
+    std::string Command;
+  };
+  std::vector<Connection> reading;
+  std::vector<struct pollfd> fds;
+  {
+    RequestScheduler scheduler(handler, pool);
+    uint64_t connections = 0;
+    while (!StopRequested)
+    {
+      fds.assign(1, { fd, POLLIN, 0 });
+      for (const Connection& conn : reading)
+      {
+        fds.push_back({ conn.FD, POLLIN, 0 });
+      }
+      if (poll(fds.data(), fds.size(), -1) < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        perror("poll");
+        break;
+      }
+      // Backwards, so that dropping a connection keeps fds[c + 1] matching
+      for (size_t c = reading.size(); c-- > 0;)
+      {
+        if (!fds[c + 1].revents)
+        {
+          continue;
+        }
+        char buf[4096];
+        ssize_t n = read(reading[c].FD, buf, sizeof(buf));
+        if (n > 0)
+        {
+          reading[c].Command.append(buf, n);
+          continue;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        const int connFD = reading[c].FD;
+        const std::string command = std::move(reading[c].Command);
+        reading.erase(reading.begin() + c);
+        if (n < 0 || command.empty())
+        {
+          close(connFD);
+          continue;
+        }
+        scheduler.Submit(std::to_string(connections++), command, [connFD](int rc) {
+          WriteAll(connFD, rc == 0 ? std::string("ok\n") : "error " + std::to_string(rc) + "\n");
+          close(connFD);
+        });
+      }
+      if (fds[0].revents)
+      {
+        int conn = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conn >= 0)
+        {
+          reading.push_back({ conn, std::string() });
+        }
+        else if (errno != EINTR && errno != ECONNABORTED)
+        {
+          perror("accept");
+          break;
+        }
+      }
+    }
+  }
+  for (const Connection& conn : reading)
+  {
+    close(conn.FD);
+  }
+  close(fd);
+  unlink(socketPath);
+  return 0;
+}
+
+int ServeSpool(const char* spoolDir, const PooledQueryHandler& handler, const ServePool& pool)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(spoolDir, ec);
+  InstallStopHandlers();
+  int fd = inotify_init1(IN_CLOEXEC);
+  if (fd >= 0 && inotify_add_watch(fd, spoolDir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+  {
+    close(fd);
+    fd = -1; // Polled instead, as in ServeWatch()
+  }
+  std::cout << (fd >= 0 ? "watching: " : "polling: ") << spoolDir << std::endl;
+
+  RequestScheduler scheduler(handler, pool);
+  ClaimSpooled(spoolDir, pool, &scheduler);
+  alignas(struct inotify_event) char buf[4096];
+  const struct timespec interval = { 0, 5 * 1000 * 1000 };
+  while (!StopRequested)
+  {
+    if (fd < 0)
+    {
+      nanosleep(&interval, nullptr);
+    }
+    else if (read(fd, buf, sizeof(buf)) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      perror("inotify");
+      break;
+    }
+    ClaimSpooled(spoolDir, pool, &scheduler);
+  }
+  if (fd >= 0)
+  {
+    close(fd);
+  }
+  return 0;
+}
+
+int SubmitToSocket(const char* socketPath, const std::string& command)
+{
+  struct sockaddr_un addr;
+  if (!GetSocketAddress(socketPath, &addr))
+  {
+    return EXIT_FAILURE;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+  {
+    perror("socket");
+    return EXIT_FAILURE;
+  }
+  if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0)
+  {
+    perror(socketPath);
+    close(fd);
+    return EXIT_FAILURE;
+  }
+  std::string reply;
+  bool ok = WriteAll(fd, command) && shutdown(fd, SHUT_WR) == 0 && ReadAll(fd, &reply);
+  close(fd);
+  if (!ok || reply.compare(0, 2, "ok") != 0)
+  {
+    std::cerr << "Pushdown server replied: " << reply << std::endl;
+    return EXIT_FAILURE;
+  }
+  return 0;
+}
+
+bool ParseSchedulePolicy(const char* name, SchedulePolicy* policy)
+{
+  if (strcmp(name, "fifo") == 0)
+  {
+    *policy = SchedulePolicy::FIFO;
+    return true;
+  }
+  if (strcmp(name, "sjf") == 0)
+  {
+    *policy = SchedulePolicy::ShortestJobFirst;
+    return true;
+  }
+  return false;
+}
+
+int SubmitToSpool(const char* spoolDir, const std::string& requestId, const std::string& command)
+{
+  const std::string dir(spoolDir);
+  const std::string temp = dir + "/." + requestId + ".cmd.tmp";
+  const std::string path = dir + "/" + requestId + ".cmd";
+  const std::string done = dir + "/" + requestId + ".done";
+  std::ofstream cmd(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+  cmd << command;
+  cmd.close();
+  if (!cmd.good() || rename(temp.c_str(), path.c_str()) != 0)
+  {
+    std::cerr << "Cannot spool pushdown command " << path << std::endl;
+    return EXIT_FAILURE;
+  }
+  // The status file is renamed into place, so it is complete once it exists
+  std::string status;
+  const struct timespec interval = { 0, 1000 * 1000 };
+  const auto deadline = std::chrono::steady_clock::now() + SpoolTimeout;
+  while (!ReadFile(done.c_str(), &status))
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      // Withdrawn if still unclaimed, so a restarted server does not answer it
+      unlink(path.c_str());
+      std::cerr << "No answer to pushdown command " << path << " in " << SpoolTimeout.count()
+                << " s" << std::endl;
+      return EXIT_FAILURE;
+    }
+    nanosleep(&interval, nullptr);
+  }
+  unlink(done.c_str());
+  if (status.compare(0, 2, "ok") != 0)
+  {
+    std::cerr << "Pushdown server replied: " << status << std::endl;
+    return EXIT_FAILURE;
+  }
+  return 0;
+}
+
+std::string NewRequestId()
+{
+  static std::atomic<unsigned> sequence(0);
+  char host[256] = "host";
+  gethostname(host, sizeof(host) - 1);
+  return std::string(host) + "-" + std::to_string(getpid()) + "-" + std::to_string(sequence++);
+}
+
+const char* GetTransportName(PushdownTransport transport)
+{
+  switch (transport)
+  {
+    case PushdownTransport::Socket:
+      return "socket";
+    case PushdownTransport::Spool:
+      return "spool";
+    case PushdownTransport::CommandFile:
+      break;
+  }
+  return "file";
+}
+
+int SubmitCommand(PushdownTransport transport, const char* dest, const std::string& requestId,
+  const std::string& command)
+{
+  switch (transport)
+  {
+    case PushdownTransport::Socket:
+      return SubmitToSocket(dest, command);
+    case PushdownTransport::Spool:
+      return SubmitToSpool(dest, requestId, command);
+    case PushdownTransport::CommandFile:
+      break;
+  }
+  std::ofstream cmd;
+  cmd.open(dest, std::ios::out | std::ios::binary | std::ios::trunc);
+  cmd << command;
+  cmd.close();
+  if (!cmd.good())
+  {
+    std::cerr << "Cannot write pushdown commands" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return 0;
+}
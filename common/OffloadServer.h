@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OffloadServer_h
+#define OffloadServer_h
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+/*
+ * Answers one pushdown command. The command is the raw content of the
+ * command file (or the bytes received on the socket). Returns 0 on success.
+ */
+using QueryHandler = std::function<int(const std::string& command)>;
+
+/*
+ * One-shot mode: reads the command file once and answers it.
+ */
+int ServeOnce(const char* commandFile, const QueryHandler& handler);
+
+/*
+ * Server mode: waits for the command file to be (re)written and answers every
+ * new command in-process, so VTK initialization and warm readers are shared by
+ * all queries. Runs until SIGINT/SIGTERM.
+ */
+int ServeWatch(const char* commandFile, const QueryHandler& handler);
+
+/*
+ * Server mode: listens on a local unix socket. Each connection carries one
+ * command (terminated by the client closing its write side) and receives a
+ * one-line status reply once all result files are written.
+ */
+int ServeSocket(const char* socketPath, const QueryHandler& handler);
+
+/*
+ * Client side of ServeSocket(). Returns 0 if the server answered the command
+ * successfully.
+ */
+int SubmitToSocket(const char* socketPath, const std::string& command);
+
+/*
+ * Answers one pushdown command on one of a pool's workers (0 to workers - 1),
+ * so state that is not shared between concurrent requests can be kept per
+ * worker.
+ */
+using PooledQueryHandler = std::function<int(const std::string& command, int worker)>;
+
+/*
+ * How the pooled servers pick the next queued request: in arrival order, or
+ * the one with the smallest estimated cost first (arrival order among equals).
+ */
+enum class SchedulePolicy
+{
+  FIFO,
+  ShortestJobFirst
+};
+
+/*
+ * Accepts "fifo" and "sjf".
+ */
+bool ParseSchedulePolicy(const char* name, SchedulePolicy* policy);
+
+struct ServePool
+{
+  int Workers = 1;
+  SchedulePolicy Policy = SchedulePolicy::FIFO;
+  std::function<double(const std::string& command)> EstimateCost; // Needed for SJF
+  // Checked by ServeSpool(), if set, against the request id of the file name
+  std::function<bool(const std::string& command, const std::string& requestId)> MatchRequestId;
+};
+
+/*
+ * Server mode for many concurrent clients on a (FUSE) file system: clients
+ * drop commands into spoolDir as <request id>.cmd, renamed into place once
+ * complete, and the server queues them for pool.Workers workers. Once a
+ * request is answered the server writes <request id>.done holding "ok" or
+ * "error <rc>". A command that pool.MatchRequestId rejects for its file name
+ * is answered with an error without running. Each request's queue wait and
+ * service time are reported. Runs until SIGINT/SIGTERM.
+ */
+int ServeSpool(const char* spoolDir, const PooledQueryHandler& handler, const ServePool& pool);
+
+/*
+ * ServeSocket() answering connections concurrently on a worker pool. Commands
+ * are received from all connections at once, so a client that is slow to
+ * send its command does not hold up the others.
+ */
+int ServeSocketPool(const char* socketPath, const PooledQueryHandler& handler,
+  const ServePool& pool);
+
+/*
+ * How long SubmitToSpool() waits for an answer, queueing included, before
+ * giving up on a server that died or lost the request.
+ */
+const std::chrono::seconds SpoolTimeout(600);
+
+/*
+ * Client side of ServeSpool(): submits command as request requestId and
+ * waits for its answer. Returns 0 if it was answered successfully, nonzero
+ * on an error answer or after SpoolTimeout without one.
+ */
+int SubmitToSpool(const char* spoolDir, const std::string& requestId, const std::string& command);
+
+/*
+ * A request id unique across the clients of one server: host, process and a
+ * per-process sequence number.
+ */
+std::string NewRequestId();
+
+/*
+ * How a runner reaches the Offloader: by writing the command file, through a
+ * server socket, or through a spool directory.
+ */
+enum class PushdownTransport
+{
+  CommandFile,
+  Socket,
+  Spool
+};
+
+/*
+ * "file", "socket" or "spool".
+ */
+const char* GetTransportName(PushdownTransport transport);
+
+/*
+ * Sends command over transport to dest and returns 0 once it was answered
+ * (written, for a command file). requestId is only used by the spool.
+ */
+int SubmitCommand(PushdownTransport transport, const char* dest, const std::string& requestId,
+  const std::string& command);
+
+#endif
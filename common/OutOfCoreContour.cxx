@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "OutOfCoreContour.h"
+
+#include <vtkType.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <stdio.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+bool ReadAt(int fd, char* buf, size_t size, uint64_t offset)
+{
+  while (size)
+  {
+    ssize_t n = pread(fd, buf, size, offset);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    buf += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+/*
+ * Appends part, the surface of the slab starting at plane z, to merged, the
+ * surface of the slabs below. The only vertices they can share lie on plane
+ * z, which the vertices of merged from planeStart (the first edge id of
+ * plane z) on are, and only the triangles of the previous slab (from
+ * *lastTriangles on) reference those. Both are sorted by edge id, so the two
+ * runs are merged in order, keeping merged's edge ids ascending.
+ */
+void Stitch(IsoSurface* merged, size_t* lastTriangles, const IsoSurface& part, uint64_t planeStart)
+{
+  const size_t tailBegin =
+    std::lower_bound(merged->EdgeIds.begin(), merged->EdgeIds.end(), planeStart) -
+    merged->EdgeIds.begin();
+  const size_t tailEnd = merged->EdgeIds.size();
+  std::vector<uint64_t> tailIds(merged->EdgeIds.begin() + tailBegin, merged->EdgeIds.end());
+  std::vector<float> tailWeights(merged->Weights.begin() + tailBegin, merged->Weights.end());
+  merged->EdgeIds.resize(tailBegin);
+  merged->Weights.resize(tailBegin);
+
+  std::vector<vtkIdType> tailMap(tailIds.size());
+  std::vector<vtkIdType> partMap(part.EdgeIds.size());
+  size_t i = 0, j = 0;
+  while (i < tailIds.size() || j < part.EdgeIds.size())
+  {
+    const vtkIdType next = static_cast<vtkIdType>(merged->EdgeIds.size());
+    if (j == part.EdgeIds.size() || (i < tailIds.size() && tailIds[i] < part.EdgeIds[j]))
+    {
+      merged->EdgeIds.push_back(tailIds[i]);
+      merged->Weights.push_back(tailWeights[i]);
+      tailMap[i++] = next;
+    }
+    else if (i == tailIds.size() || part.EdgeIds[j] < tailIds[i])
+    {
+      merged->EdgeIds.push_back(part.EdgeIds[j]);
+      merged->Weights.push_back(part.Weights[j]);
+      partMap[j++] = next;
+    }
+    else
+    {
+      merged->EdgeIds.push_back(tailIds[i]);
+      merged->Weights.push_back(tailWeights[i]);
+      tailMap[i++] = next;
+      partMap[j++] = next;
+    }
+  }
+
+  for (size_t t = *lastTriangles; t < merged->Triangles.size(); t++)
+  {
+    vtkIdType& id = merged->Triangles[t];
+    if (id >= static_cast<vtkIdType>(tailBegin) && id < static_cast<vtkIdType>(tailEnd))
+    {
+      id = tailMap[id - tailBegin];
+    }
+  }
+  *lastTriangles = merged->Triangles.size();
+  for (vtkIdType id : part.Triangles)
+  {
+    merged->Triangles.push_back(partMap[id]);
+  }
+}
+
+template <typename T>
+bool ContourSlabs(int fd, const RawImageArray& volume, double value, size_t memoryBudget,
+  IsoSurface* surface, OutOfCoreStats* stats)
+{
+  int wholeDims[3];
+  for (int c = 0; c < 3; c++)
+  {
+    wholeDims[c] = volume.Extent[2 * c + 1] - volume.Extent[2 * c] + 1;
+  }
+  const uint64_t planeValues = static_cast<uint64_t>(wholeDims[0]) * wholeDims[1];
+  const uint64_t planeBytes = planeValues * sizeof(T);
+  const int slabPlanes =
+    static_cast<int>(std::min<uint64_t>(memoryBudget / (2 * planeBytes), wholeDims[2]));
+  if (slabPlanes < 2)
+  {
+    std::cerr << "Memory budget of " << memoryBudget << " bytes is below four z-planes ("
+              << 4 * planeBytes << " bytes)" << std::endl;
+    return false;
+  }
+  stats->SlabPlanes = slabPlanes;
+  stats->Voxels = planeValues * wholeDims[2];
+
+  std::vector<T> buffers[2];
+  buffers[0].resize(planeValues * slabPlanes);
+  buffers[1].resize(planeValues * slabPlanes);
+  auto readSlab = [&](int z, std::vector<T>& buffer) {
+    const int planes = std::min(slabPlanes, wholeDims[2] - z);
+    const size_t size = planeBytes * planes;
+    stats->BytesRead += size;
+    return ReadAt(
+      fd, reinterpret_cast<char*>(buffer.data()), size, volume.Offset + z * planeBytes);
+  };
+
+  *surface = IsoSurface();
+  size_t lastTriangles = 0;
+  const int step = slabPlanes - 1;
+  bool ok = readSlab(0, buffers[0]);
+  int current = 0;
+  for (int z = 0; ok && z + 1 < wholeDims[2]; z += step)
+  {
+    const int next = z + step;
+    bool prefetched = true;
+    std::thread prefetch;
+    if (next + 1 < wholeDims[2])
+    {
+      prefetch =
+        std::thread([&, next]() { prefetched = readSlab(next, buffers[1 - current]); });
+    }
+
+    const int dims[3] = { wholeDims[0], wholeDims[1], std::min(slabPlanes, wholeDims[2] - z) };
+    const int offset[3] = { 0, 0, z };
+    IsoSurface part;
+    StructuredContour(buffers[current].data(), dims, offset, wholeDims, value, &part);
+    Stitch(surface, &lastTriangles, part, z * planeValues * 3);
+    stats->Slabs++;
+
+    if (prefetch.joinable())
+    {
+      prefetch.join();
+    }
+    ok = prefetched;
+    current = 1 - current;
+  }
+  if (!ok)
+  {
+    std::cerr << "Truncated volume" << std::endl;
+  }
+  return ok;
+}
+}
+
+bool ContourOutOfCore(const char* fileName, const RawImageArray& volume, double value,
+  size_t memoryBudget, IsoSurface* surface, OutOfCoreStats* stats)
+{
+  if (volume.NumberOfComponents != 1 ||
+    (volume.Type != VTK_FLOAT && volume.Type != VTK_DOUBLE))
+  {
+    std::cerr << "Only single-component float or double volumes can be contoured out of core"
+              << std::endl;
+    return false;
+  }
+  int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    perror(fileName);
+    return false;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  const bool ok = volume.Type == VTK_FLOAT
+    ? ContourSlabs<float>(fd, volume, value, memoryBudget, surface, stats)
+    : ContourSlabs<double>(fd, volume, value, memoryBudget, surface, stats);
+  close(fd);
+  return ok;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OutOfCoreContour_h
+#define OutOfCoreContour_h
+
+#include "MappedImageReader.h"
+#include "StructuredContour.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * What an out-of-core pass read and processed.
+ */
+struct OutOfCoreStats
+{
+  int Slabs = 0;
+  int SlabPlanes = 0; // z-planes per slab, including the one shared with the next
+  uint64_t BytesRead = 0;
+  uint64_t Voxels = 0;
+};
+
+/*
+ * Contours a single-component float or double volume that need not fit in
+ * memory. The volume is read with pread in z-slabs, consecutive slabs
+ * sharing one plane. Each slab is contoured with the structured kernel as it
+ * arrives and stitched to the surface so far by edge id, so the result
+ * equals a single pass over the whole volume. The next slab is read while the
+ * current one is contoured; the two slab buffers together stay within
+ * memoryBudget bytes, which must hold at least four z-planes. Returns false,
+ * after printing why, on read failures or too small a budget.
+ */
+bool ContourOutOfCore(const char* fileName, const RawImageArray& volume, double value,
+  size_t memoryBudget, IsoSurface* surface, OutOfCoreStats* stats);
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PartitionedGrid.h"
+#include "ThreadPool.h"
+
+#include <vtkAppendPolyData.h>
+#include <vtkDataArraySelection.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+int PartitionManifest::FindArray(const std::string& name) const
+{
+  auto it = std::find(this->Arrays.begin(), this->Arrays.end(), name);
+  return it == this->Arrays.end() ? -1 : static_cast<int>(it - this->Arrays.begin());
+}
+
+bool PartitionManifest::IsActive(size_t piece, const ContourRequest& request) const
+{
+  const int a = this->FindArray(request.Array);
+  if (a < 0)
+  {
+    return false;
+  }
+  const std::vector<double>& ranges = this->Pieces[piece].Ranges;
+  return ranges[2 * a] <= request.Value && request.Value <= ranges[2 * a + 1];
+}
+
+bool WritePartitionManifest(const PartitionManifest& manifest, const char* fileName)
+{
+  std::ofstream output(fileName, std::ios::out | std::ios::trunc);
+  output.precision(std::numeric_limits<double>::max_digits10);
+  output << "CBP 1" << std::endl << "arrays " << manifest.Arrays.size();
+  for (const std::string& array : manifest.Arrays)
+  {
+    output << " " << array;
+  }
+  output << std::endl << "pieces " << manifest.Pieces.size() << std::endl;
+  for (const PartitionManifest::Piece& piece : manifest.Pieces)
+  {
+    output << piece.File;
+    for (double b : piece.Bounds)
+    {
+      output << " " << b;
+    }
+    for (double r : piece.Ranges)
+    {
+      output << " " << r;
+    }
+    output << std::endl;
+  }
+  output.close();
+  if (!output.good())
+  {
+    std::cerr << "Cannot write partition manifest: " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ReadPartitionManifest(const char* fileName, PartitionManifest* manifest)
+{
+  std::ifstream input(fileName);
+  std::string magic, key;
+  int version = 0;
+  size_t numArrays = 0, numPieces = 0;
+  if (!(input >> magic >> version >> key >> numArrays) || magic != "CBP" || version != 1 ||
+    key != "arrays")
+  {
+    std::cerr << "Not a partition manifest: " << fileName << std::endl;
+    return false;
+  }
+  manifest->Arrays.resize(numArrays);
+  for (std::string& array : manifest->Arrays)
+  {
+    input >> array;
+  }
+  input >> key >> numPieces;
+  manifest->Pieces.resize(numPieces);
+  for (PartitionManifest::Piece& piece : manifest->Pieces)
+  {
+    input >> piece.File;
+    for (double& b : piece.Bounds)
+    {
+      input >> b;
+    }
+    piece.Ranges.resize(2 * numArrays);
+    for (double& r : piece.Ranges)
+    {
+      input >> r;
+    }
+  }
+  if (!input || key != "pieces")
+  {
+    std::cerr << "Truncated partition manifest: " << fileName << std::endl;
+    return false;
+  }
+  std::filesystem::path path(fileName);
+  manifest->Directory = path.has_parent_path() ? path.parent_path().string() : ".";
+  return true;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> ReadPiece(const PartitionManifest& manifest, size_t piece,
+  const std::vector<ContourRequest>& requests)
+{
+  const std::string path =
+    (std::filesystem::path(manifest.Directory) / manifest.Pieces[piece].File).string();
+  vtkNew<vtkXMLUnstructuredGridReader> reader;
+  reader->SetFileName(path.c_str());
+  reader->UpdateInformation();
+  vtkDataArraySelection* selection = reader->GetPointDataArraySelection();
+  selection->DisableAllArrays();
+  for (const ContourRequest& request : requests)
+  {
+    if (manifest.IsActive(piece, request))
+    {
+      selection->EnableArray(request.Array.c_str());
+    }
+  }
+  reader->GetCellDataArraySelection()->DisableAllArrays();
+  reader->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> grid = reader->GetOutput();
+  if (!grid || grid->GetNumberOfPoints() == 0)
+  {
+    std::cerr << "Cannot read piece " << path << std::endl;
+    return nullptr;
+  }
+  return grid;
+}
+
+std::vector<vtkSmartPointer<vtkPolyData>> ContourPiece(const PartitionManifest& manifest,
+  size_t piece, vtkUnstructuredGrid* grid, const std::vector<ContourRequest>& requests)
+{
+  std::vector<ContourRequest> active;
+  for (const ContourRequest& request : requests)
+  {
+    if (manifest.IsActive(piece, request))
+    {
+      active.push_back(request);
+    }
+  }
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes(requests.size());
+  if (active.empty())
+  {
+    return meshes;
+  }
+  std::vector<vtkSmartPointer<vtkPolyData>> pieceMeshes = FusedContour(grid, active);
+  size_t next = 0;
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    if (manifest.IsActive(piece, requests[i]))
+    {
+      meshes[i] = pieceMeshes[next++];
+    }
+  }
+  return meshes;
+}
+
+std::vector<vtkSmartPointer<vtkPolyData>> ContourPartitions(const PartitionManifest& manifest,
+  const std::vector<ContourRequest>& requests, ThreadPool* pool, PartitionStats* stats)
+{
+  std::vector<std::vector<vtkSmartPointer<vtkPolyData>>> pieceMeshes(manifest.Pieces.size());
+  std::atomic<size_t> piecesRead(0);
+  std::atomic<uint64_t> bytesRead(0);
+  std::atomic<bool> failed(false);
+  for (size_t p = 0; p < manifest.Pieces.size(); p++)
+  {
+    const bool active = std::any_of(requests.begin(), requests.end(),
+      [&](const ContourRequest& request) { return manifest.IsActive(p, request); });
+    if (!active)
+    {
+      continue;
+    }
+    pool->Submit([&, p]() {
+      vtkSmartPointer<vtkUnstructuredGrid> grid = ReadPiece(manifest, p, requests);
+      if (!grid)
+      {
+        failed = true;
+        return;
+      }
+      std::error_code ec;
+      bytesRead += std::filesystem::file_size(
+        std::filesystem::path(manifest.Directory) / manifest.Pieces[p].File, ec);
+      piecesRead++;
+      pieceMeshes[p] = ContourPiece(manifest, p, grid, requests);
+    });
+  }
+  pool->Wait();
+  stats->PiecesRead = piecesRead;
+  stats->BytesRead = bytesRead;
+
+  std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+  if (failed)
+  {
+    return meshes;
+  }
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    std::vector<vtkSmartPointer<vtkPolyData>> parts;
+    for (const std::vector<vtkSmartPointer<vtkPolyData>>& piece : pieceMeshes)
+    {
+      if (!piece.empty())
+      {
+        parts.push_back(piece[i]);
+      }
+    }
+    meshes.push_back(AppendMeshes(parts));
+  }
+  return meshes;
+}
+
+vtkSmartPointer<vtkPolyData> AppendMeshes(const std::vector<vtkSmartPointer<vtkPolyData>>& meshes)
+{
+  vtkNew<vtkAppendPolyData> append;
+  for (const vtkSmartPointer<vtkPolyData>& mesh : meshes)
+  {
+    if (mesh && mesh->GetNumberOfPoints() > 0)
+    {
+      append->AddInputData(mesh);
+    }
+  }
+  if (append->GetNumberOfInputConnections(0) == 0)
+  {
+    return vtkSmartPointer<vtkPolyData>::New();
+  }
+  append->Update();
+  return append->GetOutput();
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PartitionedGrid_h
+#define PartitionedGrid_h
+
+#include "FusedContour.h"
+
+#include <vtkSmartPointer.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+class vtkPolyData;
+class vtkUnstructuredGrid;
+
+/*
+ * An unstructured dataset kept as its original pieces, one .vtu per piece,
+ * described by a text manifest (.parts) listing every piece's file, bounds
+ * and per-array point value range:
+ *   CBP 1
+ *   arrays <count> <name>...
+ *   pieces <count>
+ *   <file> <xmin> <xmax> <ymin> <ymax> <zmin> <zmax> (<min> <max> per array)
+ *   ...
+ * Piece files are relative to the manifest's directory. A query loads and
+ * contours only the pieces whose range contains one of its isovalues.
+ */
+struct PartitionManifest
+{
+  struct Piece
+  {
+    std::string File;
+    double Bounds[6];
+    std::vector<double> Ranges; // min, max of every array
+  };
+
+  std::vector<std::string> Arrays;
+  std::vector<Piece> Pieces;
+  std::string Directory; // Of the manifest; not stored
+
+  int FindArray(const std::string& name) const;
+
+  /*
+   * Whether the range of piece spans the isovalue of request.
+   */
+  bool IsActive(size_t piece, const ContourRequest& request) const;
+};
+
+/*
+ * Bytes and pieces a partitioned query touched.
+ */
+struct PartitionStats
+{
+  size_t PiecesRead = 0;
+  uint64_t BytesRead = 0;
+};
+
+bool WritePartitionManifest(const PartitionManifest& manifest, const char* fileName);
+
+/*
+ * Reads a manifest written by WritePartitionManifest(). Returns false on
+ * failure.
+ */
+bool ReadPartitionManifest(const char* fileName, PartitionManifest* manifest);
+
+/*
+ * Reads one piece with only the arrays of the requests it is active for
+ * enabled. Returns nullptr on failure.
+ */
+vtkSmartPointer<vtkUnstructuredGrid> ReadPiece(const PartitionManifest& manifest, size_t piece,
+  const std::vector<ContourRequest>& requests);
+
+/*
+ * Contours a loaded piece for the requests it is active for, in one fused
+ * pass. Returns one mesh per request, null for the inactive ones.
+ */
+std::vector<vtkSmartPointer<vtkPolyData>> ContourPiece(const PartitionManifest& manifest,
+  size_t piece, vtkUnstructuredGrid* grid, const std::vector<ContourRequest>& requests);
+
+/*
+ * Loads and contours every active piece as one task of pool, then appends
+ * the pieces' meshes into one mesh per request. Returns an empty list if any
+ * active piece cannot be read, rather than a surface missing that piece.
+ */
+std::vector<vtkSmartPointer<vtkPolyData>> ContourPartitions(const PartitionManifest& manifest,
+  const std::vector<ContourRequest>& requests, ThreadPool* pool, PartitionStats* stats);
+
+/*
+ * Appends meshes (nulls are skipped) into one. Points shared by pieces are
+ * not merged.
+ */
+vtkSmartPointer<vtkPolyData> AppendMeshes(const std::vector<vtkSmartPointer<vtkPolyData>>& meshes);
+
+#endif
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PushdownProtocol.h"
+
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdlib.h>
+
+namespace
+{
+std::vector<std::string> SplitList(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::istringstream input(list);
+  std::string item;
+  while (std::getline(input, item, ','))
+  {
+    if (!item.empty())
+    {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/*
+ * Whether name can be used as a file name inside the result directory.
+ */
+bool IsSafeName(const std::string& name)
+{
+  return !name.empty() && name.find('/') == std::string::npos && name[0] != '.';
+}
+
+bool ParseQuery(const std::string& line, PushdownQuery* query)
+{
+  std::istringstream input(line);
+  std::string arrays, values, encoding;
+  input >> query->Name >> query->InputFile >> arrays >> values >> query->Engine >> encoding;
+  if (input.fail())
+  {
+    std::cerr << "Incomplete query: " << line << std::endl;
+    return false;
+  }
+  input >> query->Compression;
+  if (!IsSafeName(query->Name))
+  {
+    std::cerr << "Bad query name: " << query->Name << std::endl;
+    return false;
+  }
+  query->Arrays = SplitList(arrays);
+  for (const std::string& value : SplitList(values))
+  {
+    char* end;
+    query->Values.push_back(strtod(value.c_str(), &end));
+    if (*end)
+    {
+      std::cerr << "Bad isovalue in query " << query->Name << ": " << value << std::endl;
+      return false;
+    }
+  }
+  if (query->Arrays.empty() || query->Values.empty())
+  {
+    std::cerr << "Query " << query->Name << " names no array or no isovalue" << std::endl;
+    return false;
+  }
+  if (!ParseMeshEncoding(encoding.c_str(), &query->Encoding))
+  {
+    std::cerr << "Unknown encoding in query " << query->Name << ": " << encoding << std::endl;
+    return false;
+  }
+  // Edge meshes are only written by some single-file paths, never whole
+  if (query->Encoding == MeshEncoding::Edge)
+  {
+    std::cerr << "Edge encoding is not batched, query " << query->Name << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+bool IsBatchCommand(const std::string& command)
+{
+  return command.compare(0, 3, "CBQ") == 0;
+}
+
+bool ParseBatchCommand(
+  const std::string& command, std::vector<PushdownQuery>* queries, std::string* requestId)
+{
+  std::istringstream input(command);
+  std::string header;
+  std::getline(input, header);
+  std::istringstream headerInput(header);
+  std::string magic, id;
+  int version = 0;
+  headerInput >> magic >> version >> id;
+  if (magic != "CBQ" || version != 2)
+  {
+    std::cerr << "Unsupported pushdown command version: " << magic << " " << version << std::endl;
+    return false;
+  }
+  if (!id.empty() && !IsSafeName(id))
+  {
+    std::cerr << "Bad request id: " << id << std::endl;
+    return false;
+  }
+  if (requestId)
+  {
+    *requestId = id;
+  }
+  queries->clear();
+  std::set<std::string> names;
+  std::string line;
+  while (std::getline(input, line))
+  {
+    const size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#')
+    {
+      continue;
+    }
+    PushdownQuery query;
+    if (!ParseQuery(line, &query))
+    {
+      return false;
+    }
+    if (!names.insert(query.Name).second)
+    {
+      std::cerr << "Duplicate query name: " << query.Name << std::endl;
+      return false;
+    }
+    queries->push_back(query);
+  }
+  return true;
+}
+
+bool MatchesRequestId(const std::string& command, const std::string& requestId)
+{
+  if (!IsBatchCommand(command))
+  {
+    return true;
+  }
+  std::istringstream header(command.substr(0, command.find('\n')));
+  std::string magic, version, id;
+  header >> magic >> version >> id;
+  return id == requestId;
+}
+
+std::string FormatBatchCommand(
+  const std::vector<PushdownQuery>& queries, const std::string& requestId)
+{
+  std::ostringstream command;
+  command.precision(17);
+  command << "CBQ 2" << (requestId.empty() ? "" : " ") << requestId << std::endl;
+  for (const PushdownQuery& query : queries)
+  {
+    command << query.Name << " " << query.InputFile << " ";
+    for (size_t i = 0; i < query.Arrays.size(); i++)
+    {
+      command << (i ? "," : "") << query.Arrays[i];
+    }
+    command << " ";
+    for (size_t i = 0; i < query.Values.size(); i++)
+    {
+      command << (i ? "," : "") << query.Values[i];
+    }
+    command << " " << query.Engine << " " << GetMeshEncodingName(query.Encoding) << " "
+            << query.Compression << std::endl;
+  }
+  return command.str();
+}
+
+std::string GetRequestResultDir(const std::string& resultDir, const std::string& requestId)
+{
+  return requestId.empty() ? resultDir : resultDir + "/" + requestId;
+}
+
+double EstimateCommandCost(const std::string& command)
+{
+  std::error_code ec;
+  if (!IsBatchCommand(command))
+  {
+    std::istringstream input(command);
+    std::string inputFile;
+    input >> inputFile;
+    const uintmax_t size = std::filesystem::file_size(inputFile, ec);
+    return ec ? 0 : static_cast<double>(size);
+  }
+  std::vector<PushdownQuery> queries;
+  if (!ParseBatchCommand(command, &queries))
+  {
+    return 0;
+  }
+  double cost = 0;
+  for (const PushdownQuery& query : queries)
+  {
+    const uintmax_t size = std::filesystem::file_size(query.InputFile, ec);
+    if (!ec)
+    {
+      cost += static_cast<double>(size) * query.Arrays.size() * query.Values.size();
+    }
+  }
+  return cost;
+}
+
+void GetQueryRequests(const PushdownQuery& query, const std::string& resultDir,
+  std::vector<ContourRequest>* requests, std::vector<std::string>* resultFiles)
+{
+  requests->clear();
+  resultFiles->clear();
+  for (const std::string& array : query.Arrays)
+  {
+    std::string fileArray = array; // HDF5 dataset paths have slashes
+    std::replace(fileArray.begin(), fileArray.end(), '/', '_');
+    for (size_t k = 0; k < query.Values.size(); k++)
+    {
+      requests->push_back({ array, query.Values[k] });
+      resultFiles->push_back(
+        resultDir + "/" + query.Name + "." + fileArray + "." + std::to_string(k));
+    }
+  }
+}
+
+int SubmitBatch(PushdownTransport transport, const char* dest,
+  const std::vector<PushdownQuery>& queries, const std::string& resultDir)
+{
+  const std::string requestId = NewRequestId();
+  const std::string command = FormatBatchCommand(queries, requestId);
+  auto t0 = std::chrono::high_resolution_clock::now();
+  if (SubmitCommand(transport, dest, requestId, command) != 0)
+  {
+    std::cerr << "Cannot submit pushdown commands" << std::endl;
+    return EXIT_FAILURE;
+  }
+  auto ts = std::chrono::high_resolution_clock::now();
+
+  uintmax_t resultBytes = 0;
+  for (const PushdownQuery& query : queries)
+  {
+    std::vector<ContourRequest> requests;
+    std::vector<std::string> resultFiles;
+    GetQueryRequests(
+      query, GetRequestResultDir(resultDir, requestId), &requests, &resultFiles);
+    vtkIdType cells = 0, points = 0;
+    for (const std::string& resultFile : resultFiles)
+    {
+      std::error_code ec;
+      resultBytes += std::filesystem::file_size(resultFile, ec);
+      if (query.Encoding == MeshEncoding::Stream)
+      {
+        continue;
+      }
+      vtkSmartPointer<vtkPolyData> mesh = ReadMesh(resultFile.c_str(), query.Encoding);
+      if (!mesh)
+      {
+        std::cerr << "Cannot read pushdown result " << resultFile << std::endl;
+        return EXIT_FAILURE;
+      }
+      cells += mesh->GetNumberOfCells();
+      points += mesh->GetNumberOfPoints();
+    }
+    std::cout << query.Name << "-mesh: " << cells << ", " << points << std::endl;
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+  // Every request has its own result directory; do not let them pile up
+  std::error_code ec;
+  std::filesystem::remove_all(GetRequestResultDir(resultDir, requestId), ec);
+
+  std::cout << "batch-queries: " << queries.size() << std::endl
+            << "io-contouring: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+            << " - decode: " << std::chrono::duration<double>(t1 - ts).count() << std::endl
+            << "result-bytes: " << resultBytes << std::endl;
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PushdownProtocol_h
+#define PushdownProtocol_h
+
+#include "FusedContour.h"
+#include "MeshIO.h"
+#include "OffloadServer.h"
+
+#include <string>
+#include <vector>
+
+/*
+ * Version 2 of the pushdown command, carrying a batch of queries so that one
+ * round trip (one FUSE command write, one socket connection) answers a whole
+ * analysis session:
+ *
+ *   CBQ 2 [request_id]
+ *   <name> <input_file> <arrays> <isovalues> <engine> <encoding> [compression]
+ *   ...
+ *
+ * One query per line; blank lines and lines starting with '#' are skipped.
+ * arrays and isovalues are comma-separated and every array is contoured at
+ * every isovalue. engine is one the Offloader knows, or "default" for the
+ * one it was started with. encoding is a mesh encoding name (xml, binary,
+ * stream; edge is rejected), compression applies to xml as in WriteMesh(). Each isosurface is
+ * written to its own result file, see GetQueryRequests(), in the directory of
+ * the Offloader's first result file, or in its request_id subdirectory when
+ * the command names one so that concurrent clients do not overwrite each
+ * other's results. Commands not starting with "CBQ" are version 1:
+ * "input_file ..." answered with fixed fields and isovalues.
+ */
+struct PushdownQuery
+{
+  std::string Name;
+  std::string InputFile;
+  std::vector<std::string> Arrays;
+  std::vector<double> Values;
+  std::string Engine = "default";
+  MeshEncoding Encoding = MeshEncoding::XML;
+  int Compression = 0;
+};
+
+bool IsBatchCommand(const std::string& command);
+
+/*
+ * Returns false, after printing why, if command is not a well-formed
+ * version 2 command. Query names and the request id must be unique and
+ * cannot contain '/' or start with '.', so results stay inside the result
+ * directory. requestId is left empty if the command has none.
+ */
+bool ParseBatchCommand(const std::string& command, std::vector<PushdownQuery>* queries,
+  std::string* requestId = nullptr);
+
+std::string FormatBatchCommand(
+  const std::vector<PushdownQuery>& queries, const std::string& requestId = std::string());
+
+/*
+ * Whether command may be answered as the spooled request requestId: a
+ * version 2 command must carry that id, or its results would land in another
+ * request's directory. Version 1 commands carry none and always match.
+ */
+bool MatchesRequestId(const std::string& command, const std::string& requestId);
+
+/*
+ * Where the results of request requestId (may be empty) go.
+ */
+std::string GetRequestResultDir(const std::string& resultDir, const std::string& requestId);
+
+/*
+ * Relative cost of answering a command of either version, for shortest job
+ * first scheduling: the bytes of input each query contours, once per
+ * isosurface.
+ */
+double EstimateCommandCost(const std::string& command);
+
+/*
+ * The contour requests of query, array-major, and the result file of each:
+ * <resultDir>/<name>.<array>.<isovalue index>, with any '/' of the array name
+ * (HDF5 datasets) replaced by '_'.
+ */
+void GetQueryRequests(const PushdownQuery& query, const std::string& resultDir,
+  std::vector<ContourRequest>* requests, std::vector<std::string>* resultFiles);
+
+/*
+ * Client side: sends queries as one version 2 command with a new request id
+ * over transport (see SubmitCommand()), then reads back every result,
+ * reporting the round trip, the decode time, the result bytes and each
+ * query's triangles and points. Results in stream encoding are not read back.
+ * Returns 0 on success.
+ */
+int SubmitBatch(PushdownTransport transport, const char* dest,
+  const std::vector<PushdownQuery>& queries, const std::string& resultDir);
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RawImageWriter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace
+{
+bool WriteAt(int fd, const void* buf, size_t size, uint64_t offset)
+{
+  const char* p = static_cast<const char*>(buf);
+  while (size)
+  {
+    ssize_t n = pwrite(fd, p, size, offset);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+}
+
+RawImageWriter::~RawImageWriter()
+{
+  if (this->Fd >= 0)
+  {
+    close(this->Fd);
+  }
+}
+
+bool RawImageWriter::Open(const char* fileName, const int dims[3], const double origin[3],
+  const double spacing[3], const std::vector<std::string>& arrays)
+{
+  this->FileName = fileName;
+  this->NumberOfArrays = arrays.size();
+  this->SliceSize = static_cast<uint64_t>(dims[0]) * dims[1];
+  this->ArrayBytes = this->SliceSize * dims[2] * sizeof(float);
+  this->ArrayStride = (8 + this->ArrayBytes + 7) / 8 * 8;
+  std::ostringstream header;
+  header.precision(17);
+  header << "<?xml version=\"1.0\"?>\n"
+         << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"LittleEndian\" "
+            "header_type=\"UInt64\">\n"
+         << "  <ImageData WholeExtent=\"0 " << dims[0] - 1 << " 0 " << dims[1] - 1 << " 0 "
+         << dims[2] - 1 << "\" Origin=\"" << origin[0] << " " << origin[1] << " " << origin[2]
+         << "\" Spacing=\"" << spacing[0] << " " << spacing[1] << " " << spacing[2]
+         << "\" Direction=\"1 0 0 0 1 0 0 0 1\">\n"
+         << "  <Piece Extent=\"0 " << dims[0] - 1 << " 0 " << dims[1] - 1 << " 0 " << dims[2] - 1
+         << "\">\n"
+         << "    <PointData>\n";
+  for (size_t a = 0; a < arrays.size(); a++)
+  {
+    header << "      <DataArray type=\"Float32\" Name=\"" << arrays[a]
+           << "\" format=\"appended\" offset=\"" << a * this->ArrayStride << "\"/>\n";
+  }
+  header << "    </PointData>\n"
+         << "    <CellData>\n"
+         << "    </CellData>\n"
+         << "  </Piece>\n"
+         << "  </ImageData>\n"
+         << "  <AppendedData encoding=\"raw\">\n"
+         << "   ";
+  // Padded with spaces before the '_' so that the data starts 8-byte aligned
+  std::string text = header.str();
+  text.append(7 - text.size() % 8, ' ');
+  text += '_';
+  this->DataStart = text.size();
+
+  this->Fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (this->Fd < 0)
+  {
+    perror(fileName);
+    return false;
+  }
+  this->Ok = WriteAt(this->Fd, text.data(), text.size(), 0);
+  for (size_t a = 0; a < arrays.size() && this->Ok; a++)
+  {
+    this->Ok = WriteAt(this->Fd, &this->ArrayBytes, sizeof(this->ArrayBytes),
+      this->DataStart + a * this->ArrayStride);
+  }
+  return this->Ok;
+}
+
+bool RawImageWriter::WriteSlab(size_t array, int k0, int numPlanes, const float* values)
+{
+  const uint64_t offset = this->DataStart + array * this->ArrayStride + 8 +
+    static_cast<uint64_t>(k0) * this->SliceSize * sizeof(float);
+  this->Ok = this->Ok &&
+    WriteAt(this->Fd, values, this->SliceSize * numPlanes * sizeof(float), offset);
+  return this->Ok;
+}
+
+bool RawImageWriter::Close()
+{
+  const std::string trailer = "\n  </AppendedData>\n</VTKFile>\n";
+  this->Ok = this->Ok &&
+    WriteAt(this->Fd, trailer.data(), trailer.size(),
+      this->DataStart + this->NumberOfArrays * this->ArrayStride);
+  if (this->Fd >= 0 && close(this->Fd) != 0)
+  {
+    this->Ok = false;
+  }
+  this->Fd = -1;
+  if (!this->Ok)
+  {
+    std::cerr << "Cannot write image: " << this->FileName << std::endl;
+  }
+  return this->Ok;
+}
+
+bool ParseDimensions(const char* text, int dims[3])
+{
+  int n = sscanf(text, "%dx%dx%d", &dims[0], &dims[1], &dims[2]);
+  if (n == 1)
+  {
+    dims[1] = dims[2] = dims[0];
+  }
+  else if (n != 3)
+  {
+    return false;
+  }
+  return dims[0] > 0 && dims[1] > 0 && dims[2] > 0;
+}
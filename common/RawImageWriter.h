@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RawImageWriter_h
+#define RawImageWriter_h
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+ * Writes a .vti file with raw appended Float32 point arrays (UInt64 headers,
+ * readable by vtkXMLImageDataReader and ReadMappedImage()) z-slab by z-slab,
+ * so images larger than memory can be produced. The file is laid out up
+ * front; slabs of any array may then be written in any order. Every array's
+ * values start 8-byte aligned in the file, so ReadMappedImage() can wrap
+ * them without copying.
+ */
+class RawImageWriter
+{
+public:
+  RawImageWriter() = default;
+  ~RawImageWriter();
+
+  /*
+   * Creates fileName for a dims[0] x dims[1] x dims[2] image holding arrays.
+   * Returns false, after printing why, on failure.
+   */
+  bool Open(const char* fileName, const int dims[3], const double origin[3],
+    const double spacing[3], const std::vector<std::string>& arrays);
+
+  /*
+   * Writes the values of z-planes [k0, k0 + numPlanes) of the array-th array,
+   * x fastest.
+   */
+  bool WriteSlab(size_t array, int k0, int numPlanes, const float* values);
+
+  /*
+   * Finishes the file. Returns false, after printing why, if any write
+   * failed.
+   */
+  bool Close();
+
+private:
+  RawImageWriter(const RawImageWriter&) = delete;
+  void operator=(const RawImageWriter&) = delete;
+
+  std::string FileName;
+  int Fd = -1;
+  bool Ok = true;
+  size_t NumberOfArrays = 0;
+  uint64_t SliceSize = 0; // Values per z-plane
+  uint64_t ArrayBytes = 0;
+  uint64_t ArrayStride = 0; // Size header, values and padding of one array
+  uint64_t DataStart = 0;
+};
+
+/*
+ * Parses an image size given on the command line as "N" (a cube) or
+ * "NxMxK". Returns false unless every dimension is positive.
+ */
+bool ParseDimensions(const char* text, int dims[3]);
+
+#endif
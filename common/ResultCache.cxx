@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ResultCache.h"
+#include "MultiBlockContour.h"
+#include "PartitionedGrid.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+
+namespace
+{
+/*
+ * Files other than inputFile that its contents come from: the pieces of a
+ * .parts manifest, the blocks of a .vtm and the index of a bricked volume.
+ * Returns false if inputFile cannot be read to list them.
+ */
+bool GetInputParts(const char* inputFile, std::vector<std::string>* parts)
+{
+  const std::string extension = std::filesystem::path(inputFile).extension().string();
+  if (extension == ".parts")
+  {
+    PartitionManifest manifest;
+    if (!ReadPartitionManifest(inputFile, &manifest))
+    {
+      return false;
+    }
+    for (const PartitionManifest::Piece& piece : manifest.Pieces)
+    {
+      parts->push_back((std::filesystem::path(manifest.Directory) / piece.File).string());
+    }
+    return true;
+  }
+  if (extension == ".vtm")
+  {
+    return GetBlockFiles(inputFile, parts);
+  }
+  if (extension == ".brk")
+  {
+    parts->push_back(std::string(inputFile) + ".idx");
+  }
+  return true;
+}
+}
+
+std::string MakeResultKey(const char* inputFile, const std::string& field, double value,
+  const std::string& engine, MeshEncoding encoding, int compression)
+{
+  struct stat st;
+  if (stat(inputFile, &st) != 0)
+  {
+    return std::string();
+  }
+  std::ostringstream key;
+  key.precision(17);
+  key << inputFile << '\n'
+      << st.st_size << ' ' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec << '\n';
+  std::vector<std::string> parts;
+  if (!GetInputParts(inputFile, &parts))
+  {
+    return std::string();
+  }
+  for (const std::string& part : parts)
+  {
+    if (stat(part.c_str(), &st) != 0)
+    {
+      return std::string();
+    }
+    key << part << ' ' << st.st_size << ' ' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec
+        << '\n';
+  }
+  key << field << ' ' << value << ' ' << engine << ' ' << static_cast<int>(encoding) << ' '
+      << compression;
+  return key.str();
+}
+
+ResultStamp GetResultStamp(const char* outputFile)
+{
+  ResultStamp stamp;
+  struct stat st;
+  if (stat(outputFile, &st) == 0)
+  {
+    stamp.Exists = true;
+    stamp.ModifyTime = st.st_mtim;
+  }
+  return stamp;
+}
+
+bool ResultCache::Serve(const std::string& key, const char* outputFile)
+{
+  std::shared_ptr<const std::string> content;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    auto it = this->Index.find(key);
+    if (it == this->Index.end())
+    {
+      this->Misses++;
+      return false;
+    }
+    this->Entries.splice(this->Entries.begin(), this->Entries, it->second);
+    content = it->second->Content;
+  }
+  // Written without the lock, so other lookups do not wait on the disk
+  std::ofstream output(outputFile, std::ios::out | std::ios::binary | std::ios::trunc);
+  output.write(content->data(), content->size());
+  output.close();
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (!output)
+  {
+    std::cerr << "Cannot write cached result to " << outputFile << std::endl;
+    this->Misses++;
+    return false;
+  }
+  this->Hits++;
+  this->BytesSaved += content->size();
+  return true;
+}
+
+void ResultCache::Store(const std::string& key, const char* outputFile, const ResultStamp& before)
+{
+  if (key.empty())
+  {
+    return;
+  }
+  const ResultStamp after = GetResultStamp(outputFile);
+  if (!after.Exists ||
+    (before.Exists && after.ModifyTime.tv_sec == before.ModifyTime.tv_sec &&
+      after.ModifyTime.tv_nsec == before.ModifyTime.tv_nsec))
+  {
+    std::cerr << "Not caching " << outputFile << ": not written by this query" << std::endl;
+    return;
+  }
+  std::ifstream input(outputFile, std::ios::in | std::ios::binary);
+  if (!input)
+  {
+    return;
+  }
+  std::ostringstream content;
+  content << input.rdbuf();
+  Entry entry{ key, std::make_shared<const std::string>(content.str()) };
+  const size_t size = entry.Content->size();
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (size > this->Budget || this->Index.count(key))
+  {
+    return;
+  }
+  while (this->Bytes + size > this->Budget)
+  {
+    const Entry& last = this->Entries.back();
+    this->Bytes -= last.Content->size();
+    this->Index.erase(last.Key);
+    this->Entries.pop_back();
+  }
+  this->Bytes += size;
+  this->Entries.push_front(std::move(entry));
+  this->Index[key] = this->Entries.begin();
+}
+
+void ResultCache::Print(std::ostream& os) const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  os << "cache-hits: " << this->Hits << std::endl
+     << "cache-misses: " << this->Misses << std::endl
+     << "cache-bytes-saved: " << this->BytesSaved << std::endl
+     << "cache-entries: " << this->Entries.size() << std::endl
+     << "cache-bytes: " << this->Bytes << std::endl;
+}
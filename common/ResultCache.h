@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ResultCache_h
+#define ResultCache_h
+
+#include "MeshIO.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stddef.h>
+#include <string>
+#include <time.h>
+#include <unordered_map>
+
+/*
+ * Identifies one result file of a pushdown query: the input (path, size and
+ * modification time, so a rewritten input never hits, and the same for every
+ * piece, block or index file it is read from), the contoured field and
+ * isovalue, the engine and the output encoding. Returns an empty key if any
+ * of these files cannot be stat'ed; such results are not cached.
+ */
+std::string MakeResultKey(const char* inputFile, const std::string& field, double value,
+  const std::string& engine, MeshEncoding encoding, int compression);
+
+/*
+ * What a result file looked like before a query ran: whether it existed and
+ * when it was last modified.
+ */
+struct ResultStamp
+{
+  bool Exists = false;
+  struct timespec ModifyTime = {};
+};
+
+ResultStamp GetResultStamp(const char* outputFile);
+
+/*
+ * In-memory cache of result file contents, evicting the least recently used
+ * entries beyond a byte budget. A hit rewrites the result file from memory,
+ * skipping loading, contouring and encoding. A budget of 0 disables it.
+ * Concurrent requests of a worker pool may share one cache.
+ */
+class ResultCache
+{
+public:
+  void SetBudget(size_t bytes) { this->Budget = bytes; }
+  bool IsEnabled() const { return this->Budget > 0; }
+
+  /*
+   * Writes the cached result of key to outputFile. Returns false on a miss.
+   */
+  bool Serve(const std::string& key, const char* outputFile);
+
+  /*
+   * Caches outputFile, just written by a missed query, as the result of key.
+   * before is its stamp from before the query ran: a file the query did not
+   * rewrite (a stale result of an earlier request) is not cached.
+   */
+  void Store(const std::string& key, const char* outputFile, const ResultStamp& before);
+
+  /*
+   * Reports hits, misses, bytes served from memory and the cache footprint.
+   */
+  void Print(std::ostream& os) const;
+
+private:
+  struct Entry
+  {
+    std::string Key;
+    std::shared_ptr<const std::string> Content; // Shared with Serve() calls writing it out
+  };
+
+  size_t Budget = 0;
+  mutable std::mutex Mutex;
+  size_t Bytes = 0;
+  std::list<Entry> Entries; // Most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> Index;
+  long long Hits = 0;
+  long long Misses = 0;
+  long long BytesSaved = 0;
+};
+
+#endif
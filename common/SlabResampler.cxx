@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SlabResampler.h"
+#include "RawImageWriter.h"
+
+#include <vtkAbstractCellLocator.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkGenericCell.h>
+#include <vtkNew.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkStaticCellLocator.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+struct ProbeBlock
+{
+  vtkDataSet* Data;
+  double Bounds[6];
+  std::vector<vtkDataArray*> Values; // Null where the block lacks the array
+  vtkIdType MaxCellSize;
+  vtkNew<vtkStaticCellLocator> Locator;
+};
+
+bool Overlaps(const double bounds[6], int axis, double lo, double hi)
+{
+  return bounds[2 * axis] <= hi && lo <= bounds[2 * axis + 1];
+}
+}
+
+bool ResampleToImageSlabs(const std::vector<vtkSmartPointer<vtkDataSet>>& blocks,
+  const std::vector<std::string>& arrays, const int dims[3], int slabDepth, const char* fileName)
+{
+  double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN,
+    VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  std::vector<ProbeBlock> probes(blocks.size());
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    ProbeBlock& probe = probes[b];
+    probe.Data = blocks[b];
+    probe.Data->GetBounds(probe.Bounds);
+    probe.MaxCellSize = probe.Data->GetMaxCellSize();
+    for (int c = 0; c < 3; c++)
+    {
+      bounds[2 * c] = std::min(bounds[2 * c], probe.Bounds[2 * c]);
+      bounds[2 * c + 1] = std::max(bounds[2 * c + 1], probe.Bounds[2 * c + 1]);
+    }
+    for (const std::string& array : arrays)
+    {
+      probe.Values.push_back(probe.Data->GetCellData()->GetArray(array.c_str()));
+    }
+  }
+  if (probes.empty())
+  {
+    std::cerr << "Nothing to resample" << std::endl;
+    return false;
+  }
+  // Built up front and shared read-only by the probing threads of every slab
+  vtkSMPTools::For(0, static_cast<vtkIdType>(probes.size()), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType b = begin; b < end; b++)
+    {
+      probes[b].Locator->SetDataSet(probes[b].Data);
+      probes[b].Locator->BuildLocator();
+    }
+  });
+
+  double origin[3], spacing[3], length2 = 0;
+  for (int c = 0; c < 3; c++)
+  {
+    origin[c] = bounds[2 * c];
+    spacing[c] = dims[c] > 1 ? (bounds[2 * c + 1] - bounds[2 * c]) / (dims[c] - 1) : 1;
+    length2 += (bounds[2 * c + 1] - bounds[2 * c]) * (bounds[2 * c + 1] - bounds[2 * c]);
+  }
+  // Small relative tolerance, so samples right on block faces are found
+  const double tol2 = length2 * 1e-12;
+
+  RawImageWriter writer;
+  bool ok = writer.Open(fileName, dims, origin, spacing, arrays);
+
+  const vtkIdType rowSize = dims[0];
+  const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+  std::vector<std::vector<float>> slab(arrays.size());
+  vtkSMPThreadLocalObject<vtkGenericCell> cells;
+  vtkSMPThreadLocal<std::vector<double>> weights;
+  vtkSMPThreadLocal<std::vector<const ProbeBlock*>> candidates;
+  for (int k0 = 0; k0 < dims[2] && ok; k0 += slabDepth)
+  {
+    const int k1 = std::min(k0 + slabDepth, dims[2]);
+    std::cout << "Resampling slab " << k0 << "-" << k1 - 1 << " ..." << std::endl;
+    const vtkIdType slabPoints = sliceSize * (k1 - k0);
+    for (std::vector<float>& values : slab)
+    {
+      values.assign(slabPoints, 0.0f);
+    }
+    std::vector<const ProbeBlock*> slabBlocks;
+    for (const ProbeBlock& probe : probes)
+    {
+      if (Overlaps(probe.Bounds, 2, origin[2] + k0 * spacing[2], origin[2] + (k1 - 1) * spacing[2]))
+      {
+        slabBlocks.push_back(&probe);
+      }
+    }
+
+    // One row of x samples per iteration; only the blocks crossing the row
+    // are tried for its points
+    vtkSMPTools::For(0, slabPoints / rowSize, [&](vtkIdType beginRow, vtkIdType endRow) {
+      vtkGenericCell* cell = cells.Local();
+      std::vector<double>& w = weights.Local();
+      std::vector<const ProbeBlock*>& rowBlocks = candidates.Local();
+      for (vtkIdType row = beginRow; row < endRow; row++)
+      {
+        const vtkIdType j = row % dims[1];
+        const vtkIdType k = k0 + row / dims[1];
+        double x[3] = { 0, origin[1] + j * spacing[1], origin[2] + k * spacing[2] };
+        rowBlocks.clear();
+        for (const ProbeBlock* probe : slabBlocks)
+        {
+          if (Overlaps(probe->Bounds, 1, x[1], x[1]) && Overlaps(probe->Bounds, 2, x[2], x[2]))
+          {
+            rowBlocks.push_back(probe);
+          }
+        }
+        for (vtkIdType i = 0; i < rowSize && !rowBlocks.empty(); i++)
+        {
+          x[0] = origin[0] + i * spacing[0];
+          for (const ProbeBlock* probe : rowBlocks)
+          {
+            if (!Overlaps(probe->Bounds, 0, x[0], x[0]))
+            {
+              continue;
+            }
+            w.resize(std::max<size_t>(probe->MaxCellSize, 8));
+            int subId;
+            double pcoords[3];
+            const vtkIdType cellId =
+              probe->Locator->FindCell(x, tol2, cell, subId, pcoords, w.data());
+            if (cellId < 0)
+            {
+              continue;
+            }
+            for (size_t a = 0; a < probe->Values.size(); a++)
+            {
+              if (probe->Values[a])
+              {
+                slab[a][row * rowSize + i] =
+                  static_cast<float>(probe->Values[a]->GetComponent(cellId, 0));
+              }
+            }
+            break;
+          }
+        }
+      }
+    });
+
+    for (size_t a = 0; a < arrays.size() && ok; a++)
+    {
+      ok = writer.WriteSlab(a, k0, k1 - k0, slab[a].data());
+    }
+  }
+  return writer.Close() && ok;
+}
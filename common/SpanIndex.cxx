@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SpanIndex.h"
+
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string.h>
+
+namespace
+{
+struct SpanIndexHeader
+{
+  char Magic[4];
+  uint32_t HeaderSize;
+  uint64_t NumberOfCells;
+  uint32_t NumberOfArrays;
+  uint32_t Reserved;
+};
+static_assert(sizeof(SpanIndexHeader) == 24, "Unexpected span index header layout");
+static_assert(sizeof(SpanIndex::Entry) == 12, "Unexpected span index entry layout");
+
+const char SpanIndexMagic[4] = { 'C', 'B', 'X', '1' };
+const size_t ArrayNameSize = 64;
+}
+
+const SpanIndex::Array* SpanIndex::FindArray(const std::string& name) const
+{
+  for (const Array& array : this->Arrays)
+  {
+    if (array.Name == name)
+    {
+      return &array;
+    }
+  }
+  return nullptr;
+}
+
+bool AddSpanIndexArray(vtkDataSet* input, const std::string& name, SpanIndex* index)
+{
+  vtkDataArray* const scalars = input->GetPointData()->GetArray(name.c_str());
+  const vtkIdType numCells = input->GetNumberOfCells();
+  if (!scalars || numCells > std::numeric_limits<uint32_t>::max() ||
+    name.size() >= ArrayNameSize)
+  {
+    std::cerr << "Cannot index point array " << name << std::endl;
+    return false;
+  }
+  if (!index->Arrays.empty() && index->NumberOfCells != numCells)
+  {
+    std::cerr << "Span index was built for another dataset" << std::endl;
+    return false;
+  }
+  index->NumberOfCells = numCells;
+
+  SpanIndex::Array array;
+  array.Name = name;
+  array.Entries.resize(numCells);
+  vtkSMPThreadLocalObject<vtkIdList> ptIds;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ids = ptIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+      input->GetCellPoints(cellId, ids);
+      float lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); i++)
+      {
+        const float s = static_cast<float>(scalars->GetComponent(ids->GetId(i), 0));
+        lo = std::min(lo, s);
+        hi = std::max(hi, s);
+      }
+      array.Entries[cellId] = { static_cast<uint32_t>(cellId), lo, hi };
+    }
+  });
+
+  vtkSMPTools::Sort(array.Entries.begin(), array.Entries.end(),
+    [](const SpanIndex::Entry& a, const SpanIndex::Entry& b) { return a.Min < b.Min; });
+  // About sqrt(n) bins balance the per-bin overhead against the inactive
+  // cells scanned in the one bin that straddles the isovalue
+  const uint64_t numBins =
+    std::max<uint64_t>(1, static_cast<uint64_t>(std::sqrt(static_cast<double>(numCells))));
+  for (uint64_t b = 0; b <= numBins; b++)
+  {
+    array.BinOffsets.push_back(b * numCells / numBins);
+  }
+  for (uint64_t b = 0; b < numBins; b++)
+  {
+    auto first = array.Entries.begin() + array.BinOffsets[b];
+    auto last = array.Entries.begin() + array.BinOffsets[b + 1];
+    array.BinMins.push_back(first == last ? std::numeric_limits<float>::max() : first->Min);
+    std::sort(first, last,
+      [](const SpanIndex::Entry& a, const SpanIndex::Entry& b) { return a.Max > b.Max; });
+  }
+
+  for (SpanIndex::Array& existing : index->Arrays)
+  {
+    if (existing.Name == name)
+    {
+      existing = std::move(array);
+      return true;
+    }
+  }
+  index->Arrays.push_back(std::move(array));
+  return true;
+}
+
+bool WriteSpanIndex(const SpanIndex& index, const char* fileName)
+{
+  SpanIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, SpanIndexMagic, sizeof(header.Magic));
+  header.HeaderSize = sizeof(header);
+  header.NumberOfCells = index.NumberOfCells;
+  header.NumberOfArrays = static_cast<uint32_t>(index.Arrays.size());
+
+  std::ofstream output(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const SpanIndex::Array& array : index.Arrays)
+  {
+    char name[ArrayNameSize] = {};
+    memcpy(name, array.Name.data(), array.Name.size());
+    const uint32_t bins[2] = { static_cast<uint32_t>(array.BinMins.size()), 0 };
+    output.write(name, sizeof(name));
+    output.write(reinterpret_cast<const char*>(bins), sizeof(bins));
+    output.write(
+      reinterpret_cast<const char*>(array.BinMins.data()), sizeof(float) * array.BinMins.size());
+    output.write(reinterpret_cast<const char*>(array.BinOffsets.data()),
+      sizeof(uint64_t) * array.BinOffsets.size());
+    output.write(reinterpret_cast<const char*>(array.Entries.data()),
+      sizeof(SpanIndex::Entry) * array.Entries.size());
+  }
+  output.close();
+  if (!output.good())
+  {
+    std::cerr << "Cannot write span index: " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ReadSpanIndex(const char* fileName, SpanIndex* index)
+{
+  std::ifstream input(fileName, std::ios::in | std::ios::binary);
+  SpanIndexHeader header;
+  if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+    memcmp(header.Magic, SpanIndexMagic, 4) != 0 || header.HeaderSize < sizeof(header))
+  {
+    return false;
+  }
+  // The counts size the allocations below, so check them against the bytes
+  // the file has left before trusting them
+  std::error_code ec;
+  const uint64_t fileSize = std::filesystem::file_size(fileName, ec);
+  const uint64_t arrayHeaderBytes = ArrayNameSize + 2 * sizeof(uint32_t);
+  const uint64_t entryBytes = sizeof(SpanIndex::Entry);
+  uint64_t pos = header.HeaderSize;
+  if (ec || pos > fileSize ||
+    header.NumberOfArrays > (fileSize - pos) / (arrayHeaderBytes + sizeof(uint64_t)) ||
+    header.NumberOfCells > (fileSize - pos) / entryBytes)
+  {
+    std::cerr << "Truncated span index: " << fileName << std::endl;
+    return false;
+  }
+  input.seekg(header.HeaderSize);
+  index->NumberOfCells = header.NumberOfCells;
+  index->Arrays.resize(header.NumberOfArrays);
+  for (SpanIndex::Array& array : index->Arrays)
+  {
+    char name[ArrayNameSize + 1] = {};
+    uint32_t bins[2];
+    input.read(name, ArrayNameSize);
+    input.read(reinterpret_cast<char*>(bins), sizeof(bins));
+    pos += arrayHeaderBytes;
+    const uint64_t arrayBytes = (sizeof(float) + sizeof(uint64_t)) * bins[0] +
+      sizeof(uint64_t) + entryBytes * header.NumberOfCells;
+    if (!input || pos > fileSize || arrayBytes > fileSize - pos)
+    {
+      std::cerr << "Truncated span index: " << fileName << std::endl;
+      return false;
+    }
+    pos += arrayBytes;
+    array.Name = name;
+    array.BinMins.resize(bins[0]);
+    array.BinOffsets.resize(bins[0] + 1);
+    array.Entries.resize(header.NumberOfCells);
+    input.read(reinterpret_cast<char*>(array.BinMins.data()), sizeof(float) * bins[0]);
+    input.read(
+      reinterpret_cast<char*>(array.BinOffsets.data()), sizeof(uint64_t) * (bins[0] + 1));
+    input.read(reinterpret_cast<char*>(array.Entries.data()),
+      sizeof(SpanIndex::Entry) * array.Entries.size());
+    if (!input)
+    {
+      std::cerr << "Truncated span index: " << fileName << std::endl;
+      return false;
+    }
+    // Queries walk the entries through the bin offsets and hand the cell ids
+    // to the dataset, so both must stay in range
+    bool valid = array.BinOffsets.front() == 0 && array.BinOffsets.back() == header.NumberOfCells;
+    for (uint32_t b = 0; valid && b < bins[0]; b++)
+    {
+      valid = array.BinOffsets[b] <= array.BinOffsets[b + 1];
+    }
+    for (const SpanIndex::Entry& entry : array.Entries)
+    {
+      valid = valid && entry.Cell < header.NumberOfCells;
+    }
+    if (!valid)
+    {
+      std::cerr << "Corrupt span index: " << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoadSpanIndex(vtkDataSet* input, const char* dataFile, const std::vector<std::string>& arrays,
+  SpanIndex* index, bool* built)
+{
+  const std::string spanFile = std::string(dataFile) + ".span";
+  std::error_code ec1, ec2;
+  const auto dataTime = std::filesystem::last_write_time(dataFile, ec1);
+  const auto spanTime = std::filesystem::last_write_time(spanFile, ec2);
+  index->Arrays.clear();
+  if (ec1 || ec2 || spanTime < dataTime || !ReadSpanIndex(spanFile.c_str(), index) ||
+    index->NumberOfCells != input->GetNumberOfCells())
+  {
+    index->Arrays.clear();
+  }
+  *built = false;
+  for (const std::string& array : arrays)
+  {
+    if (!index->FindArray(array))
+    {
+      if (!AddSpanIndexArray(input, array, index))
+      {
+        return false;
+      }
+      *built = true;
+    }
+  }
+  if (*built)
+  {
+    // Failing to save only costs a rebuild next time
+    WriteSpanIndex(*index, spanFile.c_str());
+  }
+  return true;
+}
+
+void GetActiveCells(const SpanIndex::Array& array, double value, std::vector<vtkIdType>* cells)
+{
+  cells->clear();
+  for (size_t b = 0; b < array.BinMins.size() && array.BinMins[b] <= value; b++)
+  {
+    for (uint64_t e = array.BinOffsets[b]; e < array.BinOffsets[b + 1]; e++)
+    {
+      const SpanIndex::Entry& entry = array.Entries[e];
+      if (entry.Max < value)
+      {
+        break;
+      }
+      if (entry.Min <= value)
+      {
+        cells->push_back(entry.Cell);
+      }
+    }
+  }
+  std::sort(cells->begin(), cells->end());
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SpanIndex_h
+#define SpanIndex_h
+
+#include <vtkType.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class vtkDataSet;
+
+/*
+ * Span-space index of the cells of a dataset, per point scalar array, so a
+ * contour query visits only the cells whose scalar range contains the
+ * isovalue instead of every cell.
+ *
+ * The cells of an array are sorted by their minimum and cut into bins of
+ * equal count; within a bin they are sorted by decreasing maximum. A query
+ * for value scans only the bins whose lowest minimum is <= value, and each of
+ * those only while the maximum is >= value, so the work is proportional to
+ * the number of active cells plus the number of bins.
+ *
+ * Stored as a sidecar file (by convention <dataset file>.span):
+ *   char     magic[4] = "CBX1"
+ *   uint32_t header size (24)
+ *   uint64_t number of cells of the dataset
+ *   uint32_t number of arrays
+ *   uint32_t reserved
+ *   per array:
+ *     char     name[64]
+ *     uint32_t number of bins
+ *     uint32_t reserved
+ *     float    lowest minimum of every bin[number of bins]
+ *     uint64_t first entry of every bin[number of bins + 1]
+ *     entries[number of cells]: uint32_t cell id, float min, float max
+ */
+struct SpanIndex
+{
+  struct Entry
+  {
+    uint32_t Cell;
+    float Min;
+    float Max;
+  };
+
+  struct Array
+  {
+    std::string Name;
+    std::vector<float> BinMins;
+    std::vector<uint64_t> BinOffsets;
+    std::vector<Entry> Entries;
+  };
+
+  vtkIdType NumberOfCells = 0;
+  std::vector<Array> Arrays;
+
+  /*
+   * The index of the named array, or nullptr.
+   */
+  const Array* FindArray(const std::string& name) const;
+};
+
+/*
+ * Indexes the cells of input over the named point array and adds (or
+ * replaces) it in index. Returns false if the array is missing.
+ */
+bool AddSpanIndexArray(vtkDataSet* input, const std::string& array, SpanIndex* index);
+
+bool WriteSpanIndex(const SpanIndex& index, const char* fileName);
+
+/*
+ * Reads an index written by WriteSpanIndex(). Returns false on failure.
+ */
+bool ReadSpanIndex(const char* fileName, SpanIndex* index);
+
+/*
+ * Reads the sidecar <dataFile>.span of input, unless it is older than
+ * dataFile, and indexes (then saves) the listed arrays it lacks. Sets *built
+ * if anything had to be indexed. Returns false if an array cannot be indexed.
+ */
+bool LoadSpanIndex(vtkDataSet* input, const char* dataFile, const std::vector<std::string>& arrays,
+  SpanIndex* index, bool* built);
+
+/*
+ * Ids, ascending, of the cells whose range of array contains value.
+ */
+void GetActiveCells(const SpanIndex::Array& array, double value, std::vector<vtkIdType>* cells);
+
+#endif
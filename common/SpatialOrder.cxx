@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SpatialOrder.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+const int Bits = 21;
+
+/*
+ * Spreads the low 21 bits of v two bits apart, so that three spread values
+ * can be interleaved.
+ */
+uint64_t Spread(uint64_t v)
+{
+  v &= 0x1fffff;
+  v = (v | v << 32) & 0x1f00000000ffffULL;
+  v = (v | v << 16) & 0x1f0000ff0000ffULL;
+  v = (v | v << 8) & 0x100f00f00f00f00fULL;
+  v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+  v = (v | v << 2) & 0x1249249249249249ULL;
+  return v;
+}
+
+/*
+ * Turns grid coordinates into the "transposed" Hilbert index of Skilling,
+ * "Programming the Hilbert curve" (2004): interleaving the result gives the
+ * position along the curve.
+ */
+void AxesToTranspose(uint32_t x[3])
+{
+  const uint32_t m = 1u << (Bits - 1);
+  for (uint32_t q = m; q > 1; q >>= 1)
+  {
+    const uint32_t p = q - 1;
+    for (int i = 0; i < 3; i++)
+    {
+      if (x[i] & q)
+      {
+        x[0] ^= p;
+      }
+      else
+      {
+        const uint32_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  x[1] ^= x[0];
+  x[2] ^= x[1];
+  uint32_t t = 0;
+  for (uint32_t q = m; q > 1; q >>= 1)
+  {
+    if (x[2] & q)
+    {
+      t ^= q - 1;
+    }
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    x[i] ^= t;
+  }
+}
+
+/*
+ * Returns the permutation listing ids [0, n) by increasing key.
+ */
+template <typename KeyOf>
+std::vector<vtkIdType> SortByKey(vtkIdType n, KeyOf keyOf)
+{
+  std::vector<std::pair<uint64_t, vtkIdType>> keys(n);
+  vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      keys[i] = { keyOf(i), i };
+    }
+  });
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+  std::vector<vtkIdType> order(n);
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    order[i] = keys[i].second;
+  }
+  return order;
+}
+
+/*
+ * Gives out[i] = in[order[i]] for every array of in.
+ */
+void PermuteAttributes(
+  vtkDataSetAttributes* in, vtkDataSetAttributes* out, const std::vector<vtkIdType>& order)
+{
+  vtkNew<vtkIdList> ids;
+  ids->SetNumberOfIds(static_cast<vtkIdType>(order.size()));
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    ids->SetId(static_cast<vtkIdType>(i), order[i]);
+  }
+  for (int a = 0; a < in->GetNumberOfArrays(); a++)
+  {
+    vtkAbstractArray* src = in->GetAbstractArray(a);
+    vtkSmartPointer<vtkAbstractArray> dst =
+      vtkSmartPointer<vtkAbstractArray>::Take(vtkAbstractArray::CreateArray(src->GetDataType()));
+    dst->SetName(src->GetName());
+    dst->SetNumberOfComponents(src->GetNumberOfComponents());
+    dst->SetNumberOfTuples(ids->GetNumberOfIds());
+    src->GetTuples(ids, dst);
+    out->AddArray(dst);
+  }
+}
+}
+
+bool ParseSpaceFillingCurve(const char* name, SpaceFillingCurve* curve)
+{
+  if (strcmp(name, "none") == 0)
+  {
+    *curve = SpaceFillingCurve::None;
+  }
+  else if (strcmp(name, "morton") == 0)
+  {
+    *curve = SpaceFillingCurve::Morton;
+  }
+  else if (strcmp(name, "hilbert") == 0)
+  {
+    *curve = SpaceFillingCurve::Hilbert;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+const char* GetSpaceFillingCurveName(SpaceFillingCurve curve)
+{
+  switch (curve)
+  {
+    case SpaceFillingCurve::Morton:
+      return "morton";
+    case SpaceFillingCurve::Hilbert:
+      return "hilbert";
+    default:
+      return "none";
+  }
+}
+
+uint64_t GetCurveKey(SpaceFillingCurve curve, const double x[3], const double bounds[6])
+{
+  if (curve == SpaceFillingCurve::None)
+  {
+    return 0;
+  }
+  const double maxCoord = (1u << Bits) - 1;
+  uint32_t q[3];
+  for (int c = 0; c < 3; c++)
+  {
+    const double extent = bounds[2 * c + 1] - bounds[2 * c];
+    const double t = extent > 0 ? (x[c] - bounds[2 * c]) / extent : 0;
+    q[c] = static_cast<uint32_t>(std::min(std::max(t, 0.0), 1.0) * maxCoord);
+  }
+  if (curve == SpaceFillingCurve::Hilbert)
+  {
+    AxesToTranspose(q);
+  }
+  return Spread(q[0]) << 2 | Spread(q[1]) << 1 | Spread(q[2]);
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> ReorderGrid(
+  vtkUnstructuredGrid* input, SpaceFillingCurve curve)
+{
+  const vtkIdType numPoints = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+  {
+    if (input->GetCellType(cellId) == VTK_POLYHEDRON)
+    {
+      std::cerr << "Cannot reorder polyhedral cells" << std::endl;
+      return nullptr;
+    }
+  }
+  double bounds[6];
+  input->GetBounds(bounds); // Not thread safe the first time
+
+  const std::vector<vtkIdType> pointOrder = SortByKey(numPoints, [&](vtkIdType ptId) {
+    double x[3];
+    input->GetPoint(ptId, x);
+    return GetCurveKey(curve, x, bounds);
+  });
+  vtkSMPThreadLocalObject<vtkIdList> cellPoints;
+  const std::vector<vtkIdType> cellOrder = SortByKey(numCells, [&](vtkIdType cellId) {
+    vtkIdList* ids = cellPoints.Local();
+    input->GetCellPoints(cellId, ids);
+    double center[3] = { 0, 0, 0 };
+    double x[3];
+    for (vtkIdType i = 0; i < ids->GetNumberOfIds(); i++)
+    {
+      input->GetPoint(ids->GetId(i), x);
+      center[0] += x[0];
+      center[1] += x[1];
+      center[2] += x[2];
+    }
+    const double n = std::max<vtkIdType>(ids->GetNumberOfIds(), 1);
+    center[0] /= n;
+    center[1] /= n;
+    center[2] /= n;
+    return GetCurveKey(curve, center, bounds);
+  });
+
+  std::vector<vtkIdType> newPointId(numPoints);
+  vtkNew<vtkPoints> points;
+  points->SetDataType(input->GetPoints()->GetDataType());
+  points->SetNumberOfPoints(numPoints);
+  for (vtkIdType i = 0; i < numPoints; i++)
+  {
+    newPointId[pointOrder[i]] = i;
+    points->SetPoint(i, input->GetPoint(pointOrder[i]));
+  }
+
+  vtkNew<vtkCellArray> cells;
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numCells);
+  vtkNew<vtkIdList> ids;
+  std::vector<vtkIdType> cell;
+  for (vtkIdType i = 0; i < numCells; i++)
+  {
+    input->GetCellPoints(cellOrder[i], ids);
+    cell.resize(ids->GetNumberOfIds());
+    for (vtkIdType k = 0; k < ids->GetNumberOfIds(); k++)
+    {
+      cell[k] = newPointId[ids->GetId(k)];
+    }
+    cells->InsertNextCell(static_cast<vtkIdType>(cell.size()), cell.data());
+    types->SetValue(i, static_cast<unsigned char>(input->GetCellType(cellOrder[i])));
+  }
+
+  vtkSmartPointer<vtkUnstructuredGrid> output = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->SetPoints(points);
+  output->SetCells(types, cells);
+  PermuteAttributes(input->GetPointData(), output->GetPointData(), pointOrder);
+  PermuteAttributes(input->GetCellData(), output->GetCellData(), cellOrder);
+  return output;
+}
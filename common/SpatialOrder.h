@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SpatialOrder_h
+#define SpatialOrder_h
+
+#include <vtkSmartPointer.h>
+
+#include <stdint.h>
+
+class vtkUnstructuredGrid;
+
+/*
+ * Space-filling curves points and cells can be sorted along.
+ */
+enum class SpaceFillingCurve
+{
+  None,
+  Morton,
+  Hilbert
+};
+
+/*
+ * Parses "none", "morton" or "hilbert". Returns false on anything else.
+ */
+bool ParseSpaceFillingCurve(const char* name, SpaceFillingCurve* curve);
+
+const char* GetSpaceFillingCurveName(SpaceFillingCurve curve);
+
+/*
+ * Position of x along the curve, with each axis of bounds quantized to 21
+ * bits (63-bit keys).
+ */
+uint64_t GetCurveKey(SpaceFillingCurve curve, const double x[3], const double bounds[6]);
+
+/*
+ * Returns a copy of input with its points sorted by their own curve key and
+ * its cells by the key of their centroid, with connectivity renumbered and
+ * point and cell data permuted to match. Cells touching nearby space then
+ * sit next to each other and gather their points from nearby memory.
+ * Returns nullptr on polyhedral cells, which would need their face streams
+ * renumbered too.
+ */
+vtkSmartPointer<vtkUnstructuredGrid> ReorderGrid(
+  vtkUnstructuredGrid* input, SpaceFillingCurve curve);
+
+#endif
@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "StructuredContour.h"
+
+#include <vtkAlgorithm.h>
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMarchingCubesTriangleCases.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+// Hexahedron vertex and edge numbering used by vtkMarchingCubesTriangleCases
+const int CubeVertices[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 0, 0, 1 },
+  { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+const int CubeEdges[12][2] = { { 0, 1 }, { 1, 2 }, { 3, 2 }, { 0, 3 }, { 4, 5 }, { 5, 6 },
+  { 7, 6 }, { 4, 7 }, { 0, 4 }, { 1, 5 }, { 3, 7 }, { 2, 6 } };
+
+/*
+ * A cube edge as a lattice edge: the offset of its lower end from the cube
+ * origin, and its axis.
+ */
+struct CubeEdge
+{
+  int Offset[3];
+  int Axis;
+};
+
+struct CubeEdgeTable
+{
+  CubeEdge Edges[12];
+
+  CubeEdgeTable()
+  {
+    for (int e = 0; e < 12; e++)
+    {
+      const int* a = CubeVertices[CubeEdges[e][0]];
+      const int* b = CubeVertices[CubeEdges[e][1]];
+      for (int c = 0; c < 3; c++)
+      {
+        this->Edges[e].Offset[c] = std::min(a[c], b[c]);
+        if (a[c] != b[c])
+        {
+          this->Edges[e].Axis = c;
+        }
+      }
+    }
+  }
+};
+
+/*
+ * Crossing edges owned by one z-plane: its x and y edges and the z edges
+ * leaving it upwards. Local ids are (j * nx + i) * 3 + axis, ascending.
+ */
+struct PlaneEdges
+{
+  std::vector<uint32_t> Local;
+  std::vector<float> Weights;
+  vtkIdType Base = 0;
+};
+
+inline void AddCrossing(PlaneEdges* plane, uint32_t local, double s0, double s1, double value)
+{
+  plane->Local.push_back(local);
+  plane->Weights.push_back(static_cast<float>((value - s0) / (s1 - s0)));
+}
+}
+
+template <typename T>
+void StructuredContour(const T* scalars, const int dims[3], const int offset[3],
+  const int wholeDims[3], double value, IsoSurface* surface)
+{
+  surface->EdgeIds.clear();
+  surface->Weights.clear();
+  surface->Triangles.clear();
+  const vtkIdType nx = dims[0], ny = dims[1], nz = dims[2];
+  if (nx < 2 || ny < 2 || nz < 2)
+  {
+    return;
+  }
+  const vtkIdType sliceSize = nx * ny;
+  std::vector<PlaneEdges> planes(nz);
+
+  // Pass 1: crossing edges and their weights, per plane
+  vtkSMPTools::For(0, nz, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType k = begin; k < end; k++)
+    {
+      PlaneEdges* plane = &planes[k];
+      const T* slice = scalars + k * sliceSize;
+      for (vtkIdType j = 0; j < ny; j++)
+      {
+        const T* row = slice + j * nx;
+        for (vtkIdType i = 0; i < nx; i++)
+        {
+          const double s0 = row[i];
+          const bool in0 = s0 >= value;
+          const uint32_t local = static_cast<uint32_t>((j * nx + i) * 3);
+          if (i + 1 < nx && (row[i + 1] >= value) != in0)
+          {
+            AddCrossing(plane, local, s0, row[i + 1], value);
+          }
+          if (j + 1 < ny && (row[i + nx] >= value) != in0)
+          {
+            AddCrossing(plane, local + 1, s0, row[i + nx], value);
+          }
+          if (k + 1 < nz && (row[i + sliceSize] >= value) != in0)
+          {
+            AddCrossing(plane, local + 2, s0, row[i + sliceSize], value);
+          }
+        }
+      }
+    }
+  });
+
+  vtkIdType numVerts = 0;
+  for (PlaneEdges& plane : planes)
+  {
+    plane.Base = numVerts;
+    numVerts += static_cast<vtkIdType>(plane.Local.size());
+  }
+
+  // Pass 2: triangles, per cube layer
+  static const CubeEdgeTable table;
+  vtkMarchingCubesTriangleCases* cases = vtkMarchingCubesTriangleCases::GetCases();
+  std::vector<std::vector<vtkIdType>> layers(nz - 1);
+  vtkSMPTools::For(0, nz - 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType k = begin; k < end; k++)
+    {
+      std::vector<vtkIdType>& tris = layers[k];
+      const T* s0 = scalars + k * sliceSize;
+      const T* s1 = s0 + sliceSize;
+      for (vtkIdType j = 0; j + 1 < ny; j++)
+      {
+        for (vtkIdType i = 0; i + 1 < nx; i++)
+        {
+          const vtkIdType p = j * nx + i;
+          const double v[8] = { static_cast<double>(s0[p]), static_cast<double>(s0[p + 1]),
+            static_cast<double>(s0[p + 1 + nx]), static_cast<double>(s0[p + nx]),
+            static_cast<double>(s1[p]), static_cast<double>(s1[p + 1]),
+            static_cast<double>(s1[p + 1 + nx]), static_cast<double>(s1[p + nx]) };
+          int index = 0;
+          for (int c = 0; c < 8; c++)
+          {
+            if (v[c] >= value)
+            {
+              index |= 1 << c;
+            }
+          }
+          if (index == 0 || index == 255)
+          {
+            continue;
+          }
+          for (const int* edge = cases[index].edges; edge[0] > -1; edge += 3)
+          {
+            for (int m = 0; m < 3; m++)
+            {
+              const CubeEdge& ce = table.Edges[edge[m]];
+              const PlaneEdges& plane = planes[k + ce.Offset[2]];
+              const uint32_t local =
+                static_cast<uint32_t>(((j + ce.Offset[1]) * nx + i + ce.Offset[0]) * 3 + ce.Axis);
+              auto it = std::lower_bound(plane.Local.begin(), plane.Local.end(), local);
+              tris.push_back(plane.Base + (it - plane.Local.begin()));
+            }
+          }
+        }
+      }
+    }
+  });
+
+  // Gather both passes into the flat output arrays
+  std::vector<vtkIdType> layerBase(layers.size() + 1, 0);
+  for (size_t k = 0; k < layers.size(); k++)
+  {
+    layerBase[k + 1] = layerBase[k] + static_cast<vtkIdType>(layers[k].size());
+  }
+  surface->EdgeIds.resize(numVerts);
+  surface->Weights.resize(numVerts);
+  surface->Triangles.resize(layerBase.back());
+  const uint64_t NX = wholeDims[0], NY = wholeDims[1];
+  vtkSMPTools::For(0, nz, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType k = begin; k < end; k++)
+    {
+      const PlaneEdges& plane = planes[k];
+      const uint64_t gk = offset[2] + k;
+      for (size_t e = 0; e < plane.Local.size(); e++)
+      {
+        const uint32_t local = plane.Local[e];
+        const uint64_t point = local / 3;
+        const uint64_t gi = offset[0] + point % nx;
+        const uint64_t gj = offset[1] + point / nx;
+        surface->EdgeIds[plane.Base + e] = ((gk * NY + gj) * NX + gi) * 3 + local % 3;
+        surface->Weights[plane.Base + e] = plane.Weights[e];
+      }
+      if (k < nz - 1)
+      {
+        std::copy(layers[k].begin(), layers[k].end(), surface->Triangles.begin() + layerBase[k]);
+      }
+    }
+  });
+}
+
+template void StructuredContour<float>(const float*, const int[3], const int[3], const int[3],
+  double, IsoSurface*);
+template void StructuredContour<double>(const double*, const int[3], const int[3], const int[3],
+  double, IsoSurface*);
+
+void MergeIsoSurfaces(const std::vector<IsoSurface>& parts, IsoSurface* merged)
+{
+  std::vector<std::pair<uint64_t, float>> vertices;
+  size_t numTris = 0;
+  for (const IsoSurface& part : parts)
+  {
+    for (size_t v = 0; v < part.EdgeIds.size(); v++)
+    {
+      vertices.emplace_back(part.EdgeIds[v], part.Weights[v]);
+    }
+    numTris += part.Triangles.size();
+  }
+  std::sort(vertices.begin(), vertices.end());
+  vertices.erase(std::unique(vertices.begin(), vertices.end(),
+                   [](const std::pair<uint64_t, float>& a, const std::pair<uint64_t, float>& b) {
+                     return a.first == b.first;
+                   }),
+    vertices.end());
+
+  merged->EdgeIds.resize(vertices.size());
+  merged->Weights.resize(vertices.size());
+  for (size_t v = 0; v < vertices.size(); v++)
+  {
+    merged->EdgeIds[v] = vertices[v].first;
+    merged->Weights[v] = vertices[v].second;
+  }
+  merged->Triangles.clear();
+  merged->Triangles.reserve(numTris);
+  for (const IsoSurface& part : parts)
+  {
+    // Each part's edge ids ascend, so its vertices map in order
+    std::vector<vtkIdType> remap(part.EdgeIds.size());
+    auto it = merged->EdgeIds.begin();
+    for (size_t v = 0; v < part.EdgeIds.size(); v++)
+    {
+      it = std::lower_bound(it, merged->EdgeIds.end(), part.EdgeIds[v]);
+      remap[v] = it - merged->EdgeIds.begin();
+    }
+    for (vtkIdType t : part.Triangles)
+    {
+      merged->Triangles.push_back(remap[t]);
+    }
+  }
+}
+
+vtkSmartPointer<vtkPolyData> IsoSurfaceToPolyData(const IsoSurface& surface,
+  const int wholeDims[3], const double origin[3], const double spacing[3])
+{
+  const vtkIdType numVerts = static_cast<vtkIdType>(surface.EdgeIds.size());
+  const vtkIdType numTris = static_cast<vtkIdType>(surface.Triangles.size() / 3);
+  vtkNew<vtkFloatArray> coords;
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(numVerts);
+  float* xyz = coords->GetPointer(0);
+  const uint64_t NX = wholeDims[0], NY = wholeDims[1];
+  vtkSMPTools::For(0, numVerts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType v = begin; v < end; v++)
+    {
+      const uint64_t id = surface.EdgeIds[v];
+      const uint64_t point = id / 3;
+      double ijk[3] = { static_cast<double>(point % NX), static_cast<double>(point / NX % NY),
+        static_cast<double>(point / NX / NY) };
+      ijk[id % 3] += surface.Weights[v];
+      for (int c = 0; c < 3; c++)
+      {
+        xyz[3 * v + c] = static_cast<float>(origin[c] + ijk[c] * spacing[c]);
+      }
+    }
+  });
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numTris + 1);
+  for (vtkIdType t = 0; t <= numTris; t++)
+  {
+    offsets->SetValue(t, 3 * t);
+  }
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numTris);
+  std::copy(surface.Triangles.begin(), surface.Triangles.end(), connectivity->GetPointer(0));
+
+  vtkNew<vtkPoints> points;
+  points->SetData(coords);
+  vtkNew<vtkCellArray> polys;
+  polys->SetData(offsets, connectivity);
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+  return mesh;
+}
+
+bool ContourImage(vtkImageData* image, vtkDataArray* scalars, double value, IsoSurface* surface)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  return ContourImageSlab(image, scalars, value, 0, dims[2] - 1, surface);
+}
+
+bool ContourImageSlab(vtkImageData* image, vtkDataArray* scalars, double value, int zBegin,
+  int zEnd, IsoSurface* surface)
+{
+  if (!scalars || scalars->GetNumberOfComponents() != 1)
+  {
+    return false;
+  }
+  int dims[3];
+  image->GetDimensions(dims);
+  const int slab[3] = { dims[0], dims[1], zEnd - zBegin + 1 };
+  const int offset[3] = { 0, 0, zBegin };
+  const vtkIdType start = static_cast<vtkIdType>(zBegin) * dims[0] * dims[1];
+  if (vtkFloatArray* fa = vtkArrayDownCast<vtkFloatArray>(scalars))
+  {
+    StructuredContour(fa->GetPointer(start), slab, offset, dims, value, surface);
+  }
+  else if (vtkDoubleArray* da = vtkArrayDownCast<vtkDoubleArray>(scalars))
+  {
+    StructuredContour(da->GetPointer(start), slab, offset, dims, value, surface);
+  }
+  else
+  {
+    vtkNew<vtkDoubleArray> copy;
+    copy->DeepCopy(scalars);
+    StructuredContour(copy->GetPointer(start), slab, offset, dims, value, surface);
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkPolyData> IsoSurfaceToPolyData(const IsoSurface& surface, vtkImageData* image)
+{
+  int extent[6], dims[3];
+  image->GetExtent(extent);
+  image->GetDimensions(dims);
+  double origin[3], spacing[3];
+  image->GetOrigin(origin);
+  image->GetSpacing(spacing);
+  for (int c = 0; c < 3; c++)
+  {
+    origin[c] += extent[2 * c] * spacing[c];
+  }
+  return IsoSurfaceToPolyData(surface, dims, origin, spacing);
+}
+
+vtkStandardNewMacro(StructuredContourFilter);
+
+int StructuredContourFilter::RequestData(
+  vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+  vtkDataArray* scalars = this->GetInputArrayToProcess(0, inputVector);
+  IsoSurface surface;
+  if (!input || !ContourImage(input, scalars, this->Value, &surface))
+  {
+    vtkErrorMacro(<< "No single-component point scalars to contour");
+    return 0;
+  }
+
+  output->ShallowCopy(IsoSurfaceToPolyData(surface, input));
+  return 1;
+}
+
+int StructuredContourFilter::FillInputPortInformation(int, vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  return 1;
+}
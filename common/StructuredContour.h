@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef StructuredContour_h
+#define StructuredContour_h
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+#include <cstdint>
+#include <vector>
+
+class vtkDataArray;
+class vtkImageData;
+class vtkPolyData;
+
+/*
+ * Isosurface of a scalar field sampled on a regular lattice, kept in lattice
+ * terms: every vertex sits on a lattice edge, so it is stored as the edge id
+ * plus the interpolation weight along that edge.
+ *
+ * Edge (i, j, k, axis) starts at lattice point (i, j, k) and runs one step
+ * along axis (0=x, 1=y, 2=z). Its id is ((k * NY + j) * NX + i) * 3 + axis for
+ * whole lattice dimensions NX x NY x NZ, so ids of the same edge agree across
+ * blocks of one lattice and can be used to stitch them.
+ */
+struct IsoSurface
+{
+  std::vector<uint64_t> EdgeIds; // One per vertex, ascending
+  std::vector<float> Weights;    // 0 at the lower lattice point of the edge, 1 at the upper
+  std::vector<vtkIdType> Triangles; // Three vertex indices per triangle
+};
+
+/*
+ * Marching cubes over a block of dims[0] x dims[1] x dims[2] samples (x
+ * fastest) that starts at lattice point offset of a lattice with wholeDims
+ * points. Runs in parallel over z through vtkSMPTools: one pass finds the
+ * crossing edges of every z-plane, a second emits the triangles of every
+ * cube layer, referencing the vertices of the two planes around it.
+ */
+template <typename T>
+void StructuredContour(const T* scalars, const int dims[3], const int offset[3],
+  const int wholeDims[3], double value, IsoSurface* surface);
+
+/*
+ * Contours the single-component point scalars of image, taking the image's
+ * own point dimensions as the whole lattice. Returns false if scalars cannot
+ * be contoured.
+ */
+bool ContourImage(vtkImageData* image, vtkDataArray* scalars, double value, IsoSurface* surface);
+
+/*
+ * Same, limited to the cubes between point planes zBegin and zEnd (inclusive,
+ * in image point indices). Edge ids are still those of the whole image.
+ */
+bool ContourImageSlab(vtkImageData* image, vtkDataArray* scalars, double value, int zBegin,
+  int zEnd, IsoSurface* surface);
+
+/*
+ * Stitches isosurfaces of blocks of one lattice into one. Blocks that share a
+ * face both emit the vertices on it; those are merged by edge id, so the
+ * result is the surface a single pass over the union of the blocks gives.
+ */
+void MergeIsoSurfaces(const std::vector<IsoSurface>& parts, IsoSurface* merged);
+
+/*
+ * Converts an isosurface to a triangle mesh. The world position of lattice
+ * point (i, j, k) is origin + (i, j, k) * spacing.
+ */
+vtkSmartPointer<vtkPolyData> IsoSurfaceToPolyData(const IsoSurface& surface,
+  const int wholeDims[3], const double origin[3], const double spacing[3]);
+
+/*
+ * Same, for an isosurface of image's own lattice, placed with its origin,
+ * spacing and extent.
+ */
+vtkSmartPointer<vtkPolyData> IsoSurfaceToPolyData(const IsoSurface& surface, vtkImageData* image);
+
+/*
+ * The in-house structured contour engine as a pipeline filter, contouring the
+ * input array to process of a vtkImageData at a single isovalue.
+ */
+class StructuredContourFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static StructuredContourFilter* New();
+  vtkTypeMacro(StructuredContourFilter, vtkPolyDataAlgorithm);
+
+  vtkSetMacro(Value, double);
+  vtkGetMacro(Value, double);
+
+protected:
+  StructuredContourFilter() = default;
+  ~StructuredContourFilter() override = default;
+
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+
+  double Value = 0;
+
+private:
+  StructuredContourFilter(const StructuredContourFilter&) = delete;
+  void operator=(const StructuredContourFilter&) = delete;
+};
+
+#endif
@@ -32,49 +32,53 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "BenchStats.h"
+#include "ContourEngine.h"
+#include "ImageArrayReader.h"
+#include "MappedImageReader.h"
+#include "NyxHDF5Reader.h"
+#include "OutOfCoreContour.h"
+
 #include <vtkActor.h>
-#include <vtkContourFilter.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkOutlineFilter.h>
 #include <vtkPNGWriter.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
 #include <vtkWindowToImageFilter.h>
-#include <vtkXMLImageDataReader.h>
 #include <vtkXMLPolyDataWriter.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <getopt.h>
 #include <iostream>
+#include <sstream>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
+#include <vector>
 
-void Run0(vtkAlgorithm* input, const char* outputPng)
+/*
+ * Renders mesh within the outline of the volume and reports the timings,
+ * given the time it took to contour it.
+ */
+void Render(vtkPolyData* mesh, vtkImageData* volume, double contouring, const char* outputPng,
+  const char* engine)
 {
-  auto t0 = std::chrono::high_resolution_clock::now();
-  // baryon_density
-  vtkNew<vtkContourFilter> cf;
-  cf->SetInputConnection(input->GetOutputPort());
-  cf->ComputeScalarsOff();
-  cf->ComputeNormalsOff();
-  cf->SetInputArrayToProcess(
-    0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "baryon_density");
-  cf->SetValue(0, 81.66);
-  cf->Update();
-
   auto t1 = std::chrono::high_resolution_clock::now();
 
   vtkNew<vtkRenderer> renderer;
   renderer->SetBackground(0.321, 0.341, 0.431);
 
   vtkNew<vtkOutlineFilter> of;
-  of->SetInputConnection(input->GetOutputPort());
+  of->SetInputData(volume);
 
   vtkNew<vtkPolyDataMapper> mp0;
   mp0->SetInputConnection(of->GetOutputPort());
@@ -88,7 +92,7 @@ void Run0(vtkAlgorithm* input, const char* outputPng)
 
   // baryon_density
   vtkNew<vtkPolyDataMapper> mp1;
-  mp1->SetInputConnection(cf->GetOutputPort());
+  mp1->SetInputData(mesh);
   mp1->ScalarVisibilityOff();
 
   vtkNew<vtkActor> ac1;
@@ -118,9 +122,10 @@ void Run0(vtkAlgorithm* input, const char* outputPng)
 
   auto t3 = std::chrono::high_resolution_clock::now();
 
-  std::cout << "baryon-mesh, " << cf->GetOutput()->GetNumberOfCells() << ", "
-            << cf->GetOutput()->GetNumberOfPoints() << std::endl;
-  std::cout << "contouring: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+  std::cout << "baryon-mesh, " << mesh->GetNumberOfCells() << ", " << mesh->GetNumberOfPoints()
+            << std::endl;
+  std::cout << "engine: " << engine << std::endl;
+  std::cout << "contouring: " << contouring << std::endl
             << "rendering: " << std::chrono::duration<double>(t3 - t1).count() << std::endl
             << " - win2image: " << std::chrono::duration<double>(t2 - t1).count() << std::endl
             << " - png: " << std::chrono::duration<double>(t3 - t2).count() << std::endl;
@@ -128,37 +133,223 @@ void Run0(vtkAlgorithm* input, const char* outputPng)
   vtkNew<vtkXMLPolyDataWriter> writer;
   writer->SetCompressorTypeToNone();
   writer->EncodeAppendedDataOff();
-  writer->SetInputConnection(cf->GetOutputPort());
+  writer->SetInputData(mesh);
   writer->SetWriteToOutputString(true);
   writer->Write();
   std::cout << "baryon-size, " << writer->GetOutputString().size() << std::endl;
+  std::cout << "peak-rss-kb: " << GetPeakRSS() << std::endl;
+}
+
+void Run0(vtkImageData* input, const char* outputPng, ContourEngine engine)
+{
+  auto t0 = std::chrono::high_resolution_clock::now();
+  // baryon_density
+  vtkSmartPointer<vtkPolyDataAlgorithm> cf = NewContourFilter(engine, "baryon_density", 81.66);
+  cf->SetInputData(input);
+  cf->Update();
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  Render(cf->GetOutput(), input, std::chrono::duration<double>(t1 - t0).count(), outputPng,
+    GetContourEngineName(engine));
+}
+
+/*
+ * Streams the volume through a memory budget in z-slabs instead of loading
+ * it whole. Reading overlaps contouring, so "contouring" covers both. A raw
+ * volume is headerless float32 of rawDims (x fastest).
+ */
+void RunOutOfCore(const char* inputVTK, const char* outputPng, size_t budget, const int* rawDims)
+{
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  RawImageArray volume;
+  if (rawDims)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      volume.Extent[2 * c] = 0;
+      volume.Extent[2 * c + 1] = rawDims[c] - 1;
+      volume.Origin[c] = 0;
+      volume.Spacing[c] = 1;
+    }
+    volume.Type = VTK_FLOAT;
+    volume.NumberOfComponents = 1;
+    volume.Offset = 0;
+  }
+  else if (!LocateRawImageArray(inputVTK, "baryon_density", &volume))
+  {
+    exit(EXIT_FAILURE);
+  }
+  IsoSurface surface;
+  OutOfCoreStats stats;
+  if (!ContourOutOfCore(inputVTK, volume, 81.66, budget, &surface, &stats))
+  {
+    exit(EXIT_FAILURE);
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  const double seconds = std::chrono::duration<double>(t1 - t0).count();
+  std::cout << "reader: out-of-core" << std::endl
+            << "memory-budget: " << budget << std::endl
+            << "slabs: " << stats.Slabs << " x " << stats.SlabPlanes << " planes" << std::endl
+            << "bytes-read: " << stats.BytesRead << std::endl
+            << "voxels-per-sec: " << stats.Voxels / seconds << std::endl;
+
+  // Only its geometry is used, for the outline
+  vtkNew<vtkImageData> outline;
+  outline->SetExtent(volume.Extent);
+  outline->SetOrigin(volume.Origin);
+  outline->SetSpacing(volume.Spacing);
+  int wholeDims[3];
+  double origin[3];
+  for (int c = 0; c < 3; c++)
+  {
+    wholeDims[c] = volume.Extent[2 * c + 1] - volume.Extent[2 * c] + 1;
+    origin[c] = volume.Origin[c] + volume.Extent[2 * c] * volume.Spacing[c];
+  }
+  vtkSmartPointer<vtkPolyData> mesh =
+    IsoSurfaceToPolyData(surface, wholeDims, origin, volume.Spacing);
+  surface = IsoSurface();
+  Render(mesh, outline, seconds, outputPng, "structured-out-of-core");
 }
 
-void Run(const char* inputVTK, const char* outputPng)
+/*
+ * Only the point arrays listed in arrays are read; baryon_density, the one
+ * contoured, comes first.
+ */
+void Run(const char* inputVTK, const char* outputPng, ContourEngine engine, bool mapped,
+  const std::string& dataset, const int* extent, const std::vector<std::string>& arrays)
 {
+  IOCounters io0, io1;
+  const bool haveIO = GetIOCounters(&io0);
   auto t0 = std::chrono::high_resolution_clock::now();
 
-  vtkNew<vtkXMLImageDataReader> reader;
-  reader->SetFileName(inputVTK);
-  reader->Update();
+  vtkSmartPointer<vtkImageData> image;
+  const bool hdf5 = IsHDF5File(inputVTK);
+  if (hdf5)
+  {
+    image = ReadNyxHDF5(inputVTK, dataset, "baryon_density", extent);
+    if (!image)
+    {
+      exit(EXIT_FAILURE);
+    }
+  }
+  else if (mapped)
+  {
+    image = ReadMappedImage(inputVTK, arrays);
+    if (!image)
+    {
+      exit(EXIT_FAILURE);
+    }
+  }
+  else
+  {
+    image = ReadImageArrays(inputVTK, arrays);
+    if (!image)
+    {
+      exit(EXIT_FAILURE);
+    }
+  }
 
   auto t1 = std::chrono::high_resolution_clock::now();
 
   std::cout << "io: " << std::chrono::duration<double>(t1 - t0).count() << std::endl;
+  std::cout << "reader: " << (hdf5 ? "hdf5" : mapped ? "mapped" : "xml") << std::endl;
+  if (hdf5)
+  {
+    std::cout << "dataset: " << dataset << std::endl;
+  }
+  else
+  {
+    if (mapped)
+    {
+      std::cout << "mapped-copied-bytes: " << GetMappedCopiedBytes() << std::endl;
+    }
+    std::cout << "arrays: " << arrays.size() << std::endl;
+  }
+  if (haveIO && GetIOCounters(&io1))
+  {
+    std::cout << "bytes-read: " << io1.ReadChars - io0.ReadChars << std::endl
+              << "storage-bytes-read: " << io1.StorageBytes - io0.StorageBytes << std::endl;
+  }
 
-  Run0(reader.Get(), outputPng);
+  Run0(image, outputPng, engine);
 }
 
 int main(int argc, char* argv[])
 {
+  ContourEngine engine = ContourEngine::Generic;
+  int numThreads = 0;
+  bool mapped = false;
+  size_t budget = 0;
+  int rawDims[3];
+  bool raw = false;
+  std::string dataset = NyxDensityDataset;
+  int extent[6];
+  bool subset = false;
+  std::vector<std::string> arrays = { "baryon_density" };
   int c;
-  while ((c = getopt(argc, argv, "h")) != -1)
+  while ((c = getopt(argc, argv, "e:n:mo:r:D:k:a:h")) != -1)
   {
     switch (c)
     {
+      case 'e':
+        if (!ParseContourEngine(optarg, &engine))
+        {
+          std::cerr << "Unknown contour engine: " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'n':
+        numThreads = atoi(optarg);
+        break;
+      case 'm':
+        mapped = true;
+        break;
+      case 'o': /* contour out of core within this many MiB of slab buffers */
+        budget = static_cast<size_t>(atol(optarg)) << 20;
+        break;
+      case 'r': /* the input is a headerless float32 volume of NxMxK */
+        raw = sscanf(optarg, "%dx%dx%d", &rawDims[0], &rawDims[1], &rawDims[2]) == 3;
+        if (!raw)
+        {
+          std::cerr << "Bad raw volume dimensions: " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'D': /* HDF5 dataset holding the density */
+        dataset = optarg;
+        break;
+      case 'k': /* read only this extent of an HDF5 dataset */
+        subset = ParseExtent(optarg, extent);
+        if (!subset)
+        {
+          std::cerr << "Bad extent: " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'a': /* also read these comma-separated point arrays */
+      {
+        std::istringstream list(optarg);
+        std::string name;
+        while (std::getline(list, name, ','))
+        {
+          if (!name.empty() && std::find(arrays.begin(), arrays.end(), name) == arrays.end())
+          {
+            arrays.push_back(name);
+          }
+        }
+        break;
+      }
       case 'h':
       default:
-        std::cerr << "Usage: " << argv[0] << " <VTK filename>" << std::endl;
+        std::cerr << "Usage: " << argv[0]
+                  << " [-e generic|flying-edges|synchronized-templates|structured] [-n threads]"
+                  << " [-m] [-o budget-MiB [-r NxMxK]] [-D dataset] [-k x0,x1,y0,y1,z0,z1]"
+                  << " [-a array,...]"
+                  << " <VTK or HDF5 filename>" << std::endl;
         exit(EXIT_FAILURE);
     }
   }
@@ -172,6 +363,20 @@ int main(int argc, char* argv[])
   std::string outputPng = std::filesystem::path(argv[0]).stem().string() + ".png";
   std::cout << "vtk file: " << argv[0] << std::endl;
   std::cout << "output png: " << outputPng << std::endl;
-  Run(argv[0], outputPng.c_str());
+  std::cout << "threads: " << InitializeContourThreads(numThreads, engine) << std::endl;
+  if (raw && !budget)
+  {
+    std::cerr << "Raw volumes (-r) are only read out of core (-o)" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (budget)
+  {
+    RunOutOfCore(argv[0], outputPng.c_str(), budget, raw ? rawDims : nullptr);
+  }
+  else
+  {
+    Run(argv[0], outputPng.c_str(), engine, mapped, dataset, subset ? extent : nullptr,
+      arrays);
+  }
   return 0;
 }
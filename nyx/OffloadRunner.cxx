@@ -32,56 +32,115 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "EdgeMesh.h"
+#include "MeshIO.h"
+#include "MeshStream.h"
+#include "NyxHDF5Reader.h"
+#include "OffloadServer.h"
+#include "PushdownProtocol.h"
+
 #include <vtkActor.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkOutlineFilter.h>
 #include <vtkPNGWriter.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
 #include <vtkWindowToImageFilter.h>
-#include <vtkXMLPolyDataReader.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <filesystem>
-#include <fstream>
 #include <getopt.h>
 #include <iostream>
+#include <sstream>
 #include <stdlib.h>
 #include <string>
+#include <thread>
+#include <vector>
 
-void Run(const char* pushdown_command_dest, const char* result1, const char* result2,
-  const char* result3, const char* inputVtk, const char* outputPng)
+void Run(const char* pushdown_command_dest, PushdownTransport transport,
+  const std::string& requestId, const std::string& command, const char* result1,
+  const char* result2, const char* result3, const char* outputPng, MeshEncoding encoding)
 {
-  auto t0 = std::chrono::high_resolution_clock::now();
+  // Geometry of the Nyx volume
+  const double origin[3] = { 0, 0, 0 };
+  const double spacing[3] = { 1, 1, 1 };
 
+  const bool streaming = encoding == MeshEncoding::Stream;
+  if (streaming)
   {
-    std::ofstream cmd;
-    cmd.open(pushdown_command_dest, std::ios::out | std::ios::binary | std::ios::trunc);
-    cmd << inputVtk << std::endl;
-    cmd.close();
-    if (!cmd.good())
+    // The stream is polled as it grows, so a stale one must not be mistaken
+    // for this query's result
+    std::error_code ec;
+    std::filesystem::remove(result1, ec);
+  }
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  decltype(t0) ts, tf, t1;
+  vtkSmartPointer<vtkPolyData> mesh;
+  uintmax_t resultBytes = 0;
+  std::atomic<bool> failed(false);
+
+  // The pushdown (submission and result reads) runs on its own thread while
+  // this one sets up the offscreen context and the static scene, keeping
+  // every GL call on the main thread. The stream is consumed on this thread
+  // instead, so that it can render it as it grows; the pushdown thread then
+  // only waits for the server to reply once the stream is closed.
+  // It reports errors through failed and leaves exiting to this thread,
+  // which joins it first
+  std::thread pushdown([&]() {
+    if (streaming)
     {
-      std::cerr << "Cannot write pushdown commands" << std::endl;
-      exit(EXIT_FAILURE);
+      failed = SubmitCommand(transport, pushdown_command_dest, requestId, command) != 0;
+      return;
+    }
+    if (SubmitCommand(transport, pushdown_command_dest, requestId, command) != 0)
+    {
+      std::cerr << "Cannot submit pushdown commands" << std::endl;
+      failed = true;
+      return;
     }
-  }
 
-  vtkNew<vtkXMLPolyDataReader> rd;
-  rd->SetFileName(result1);
-  rd->Update();
+    ts = std::chrono::high_resolution_clock::now();
 
-  auto t1 = std::chrono::high_resolution_clock::now();
+    if (encoding == MeshEncoding::Edge)
+    {
+      IsoSurface surface;
+      int dims[3];
+      double meshOrigin[3], meshSpacing[3];
+      if (ReadEdgeMesh(result1, &surface, dims, meshOrigin, meshSpacing))
+      {
+        mesh = IsoSurfaceToPolyData(surface, dims, meshOrigin, meshSpacing);
+      }
+    }
+    else
+    {
+      mesh = ReadMesh(result1, encoding);
+    }
+    if (!mesh)
+    {
+      std::cerr << "Cannot read pushdown results" << std::endl;
+      failed = true;
+      return;
+    }
+    std::error_code ec;
+    resultBytes = std::filesystem::file_size(result1, ec);
+
+    t1 = std::chrono::high_resolution_clock::now();
+  });
 
   vtkNew<vtkRenderer> renderer;
   renderer->SetBackground(0.321, 0.341, 0.431);
 
   vtkNew<vtkImageData> img;
   img->SetExtent(0, 511, 0, 511, 0, 511);
-  img->SetOrigin(0, 0, 0);
-  img->SetSpacing(1, 1, 1);
+  img->SetOrigin(origin);
+  img->SetSpacing(spacing);
 
   vtkNew<vtkOutlineFilter> of;
   of->SetInputData(img);
@@ -96,22 +155,70 @@ void Run(const char* pushdown_command_dest, const char* result1, const char* res
   ac0->GetProperty()->SetColor(1, 1, 1);
   renderer->AddActor(ac0);
 
+  // The result actor exists up front; a streamed mesh is shown from the first
+  // render on, any other once it has been read
   vtkNew<vtkPolyDataMapper> mp1;
-  mp1->SetInputConnection(rd->GetOutputPort());
   mp1->ScalarVisibilityOff();
 
   vtkNew<vtkActor> ac1;
   ac1->SetMapper(mp1);
   ac1->GetProperty()->LightingOff();
   ac1->GetProperty()->SetColor(0, 1, 1);
-  renderer->AddActor(ac1);
+  if (streaming)
+  {
+    mesh = vtkSmartPointer<vtkPolyData>::New();
+    InitializeStreamMesh(mesh);
+    mp1->SetInputData(mesh);
+    renderer->AddActor(ac1);
+  }
 
   vtkNew<vtkRenderWindow> window;
   window->AddRenderer(renderer);
   window->SetOffScreenRendering(true);
   window->SetSize(1024, 768);
 
-  renderer->ResetCamera();
+  // The results lie within the known extents, so the camera does not need them
+  renderer->ResetCamera(img->GetBounds());
+  window->Render();
+
+  auto tr = std::chrono::high_resolution_clock::now();
+
+  int streamRenders = 0;
+  if (streaming)
+  {
+    ts = std::chrono::high_resolution_clock::now();
+    tf = ts;
+    auto lastRender = ts;
+    uint64_t bytes = 0;
+    bool ok = ReceiveMeshStreams(
+      { result1 }, { mesh.Get() }, failed, StreamIdleTimeout, &tf, &bytes, [&]() {
+        auto now = std::chrono::high_resolution_clock::now();
+        if (now - lastRender >= StreamRenderInterval)
+        {
+          window->Render();
+          lastRender = now;
+          streamRenders++;
+        }
+      });
+    pushdown.join();
+    if (!ok || failed)
+    {
+      std::cerr << "Cannot receive pushdown result streams" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    resultBytes = bytes;
+    t1 = std::chrono::high_resolution_clock::now();
+  }
+  else
+  {
+    pushdown.join();
+    if (failed)
+    {
+      exit(EXIT_FAILURE);
+    }
+    mp1->SetInputData(mesh);
+    renderer->AddActor(ac1);
+  }
 
   vtkNew<vtkWindowToImageFilter> w2i;
   w2i->SetInput(window);
@@ -127,34 +234,123 @@ void Run(const char* pushdown_command_dest, const char* result1, const char* res
 
   auto t3 = std::chrono::high_resolution_clock::now();
 
-  std::cout << "baryon-mesh, " << rd->GetOutput()->GetNumberOfCells() << ", "
-            << rd->GetOutput()->GetNumberOfPoints() << std::endl;
+  std::cout << "baryon-mesh, " << mesh->GetNumberOfCells() << ", " << mesh->GetNumberOfPoints()
+            << std::endl;
+  std::cout << "result-bytes: " << resultBytes << std::endl;
 
   std::cout << "io-contouring: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
-            << "rendering: " << std::chrono::duration<double>(t3 - t1).count() << std::endl
+            << " - decode: " << std::chrono::duration<double>(t1 - ts).count() << std::endl;
+  if (streaming)
+  {
+    std::cout << "first-chunk: " << std::chrono::duration<double>(tf - t0).count() << std::endl
+              << "stream-renders: " << streamRenders << std::endl;
+  }
+  std::cout << "rendering: " << std::chrono::duration<double>(t3 - t1).count() << std::endl
+            << " - setup: " << std::chrono::duration<double>(tr - t0).count() << std::endl
+            << " - hidden: " << std::chrono::duration<double>(std::min(tr, t1) - t0).count()
+            << std::endl
             << " - win2image: " << std::chrono::duration<double>(t2 - t1).count() << std::endl
             << " - png: " << std::chrono::duration<double>(t3 - t2).count() << std::endl;
 }
 
+/*
+ * The array a version 2 query contours in input. HDF5 inputs name the dataset
+ * instead of the array; the inputs live on the server side, so only their
+ * extension tells.
+ */
+std::string GetQueryArray(const char* input, const char* dataset)
+{
+  const std::string extension = std::filesystem::path(input).extension().string();
+  const bool hdf5 = extension == ".h5" || extension == ".hdf5";
+  return hdf5 ? (dataset ? dataset : NyxDensityDataset) : "baryon_density";
+}
+
+/*
+ * Several inputs: a single version 2 command asks for all of them, one query
+ * per input at the given isovalues (81.66 by default). Results are read back
+ * but not rendered.
+ */
+int RunBatch(const char* pushdown_command_dest, PushdownTransport transport,
+  const char* result_prefix, int numInputs, char* inputs[], MeshEncoding encoding,
+  const char* dataset, const std::string& isovalues)
+{
+  PushdownQuery query;
+  query.Encoding = encoding;
+  std::istringstream list(isovalues);
+  std::string value;
+  while (std::getline(list, value, ','))
+  {
+    query.Values.push_back(atof(value.c_str()));
+  }
+  if (query.Values.empty())
+  {
+    query.Values = { 81.66 };
+  }
+  std::vector<PushdownQuery> queries;
+  for (int f = 0; f < numInputs; f++)
+  {
+    query.Name = "q" + std::to_string(f);
+    query.InputFile = inputs[f];
+    query.Arrays = { GetQueryArray(inputs[f], dataset) };
+    queries.push_back(query);
+  }
+  const std::filesystem::path prefix(result_prefix);
+  const std::string resultDir = prefix.has_parent_path() ? prefix.parent_path().string() : ".";
+  return SubmitBatch(transport, pushdown_command_dest, queries, resultDir);
+}
+
 int main(int argc, char* argv[])
 {
   const char* pushdown_command_dest = "/fuse/command";
   const char* result_prefix = "/fuse/result";
+  PushdownTransport transport = PushdownTransport::CommandFile;
+  MeshEncoding encoding = MeshEncoding::XML;
+  const char* dataset = nullptr;
+  std::string isovalues;
   int c;
-  while ((c = getopt(argc, argv, "d:s:h")) != -1)
+  while ((c = getopt(argc, argv, "d:u:q:s:D:i:bEch")) != -1)
   {
     switch (c)
     {
+      case 'i':
+        isovalues = optarg;
+        break;
+      case 'b':
+        encoding = MeshEncoding::Binary;
+        break;
+      case 'E': // -e is the contour engine of the Offloader and the baseline
+        encoding = MeshEncoding::Edge;
+        break;
+      case 'c':
+        encoding = MeshEncoding::Stream;
+        break;
       case 'd':
         pushdown_command_dest = optarg;
         break;
+      case 'u':
+        pushdown_command_dest = optarg;
+        transport = PushdownTransport::Socket;
+        break;
+      case 'q':
+        pushdown_command_dest = optarg;
+        transport = PushdownTransport::Spool;
+        break;
       case 's':
         result_prefix = optarg;
         break;
+      case 'D':
+        dataset = optarg;
+        break;
       case 'h':
       default:
         std::cerr
-          << "-d to specify pushdown command file, and -s to specify pushdown result file prefix"
+          << "-d to specify pushdown command file (or -u for a pushdown server socket, "
+          << "-q for its spool directory), "
+          << "-b, -E or -c to receive results as binary, edge-encoded or chunked streamed "
+          << "meshes instead of XML, "
+          << "-s to specify pushdown result file prefix, "
+          << "and -D to name the dataset of an HDF5 input; "
+          << "with several vtk files, all are queried in one batch (-i to give its isovalues)"
           << std::endl;
         exit(EXIT_FAILURE);
     }
@@ -166,13 +362,78 @@ int main(int argc, char* argv[])
     std::cerr << "Lack target vtk filename" << std::endl;
     exit(EXIT_FAILURE);
   }
+  const bool batched = argc > 1 || transport == PushdownTransport::Spool;
+  if (batched && encoding == MeshEncoding::Edge)
+  {
+    std::cerr << "Edge encoding is not batched" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (argc > 1)
+  {
+    std::cout << "pushdown analysis command " << GetTransportName(transport) << ": "
+              << pushdown_command_dest << std::endl
+              << "vtk files: " << argc << std::endl
+              << "encoding: " << GetMeshEncodingName(encoding) << std::endl;
+    return RunBatch(
+      pushdown_command_dest, transport, result_prefix, argc, argv, encoding, dataset, isovalues);
+  }
   std::string r0 = std::string(result_prefix) + "0";
   std::string r1 = std::string(result_prefix) + "1";
   std::string r2 = std::string(result_prefix) + "2";
+  std::string requestId;
+  std::string command;
+  std::string requestDir;
+  if (transport == PushdownTransport::Spool)
+  {
+    // Other clients share the spool, so the fixed result files of a version 1
+    // command could be overwritten under us; ask for a request of our own
+    const std::filesystem::path prefix(result_prefix);
+    requestId = NewRequestId();
+    requestDir = GetRequestResultDir(
+      prefix.has_parent_path() ? prefix.parent_path().string() : ".", requestId);
+    PushdownQuery query;
+    query.Name = "q0";
+    query.InputFile = argv[0];
+    query.Arrays = { GetQueryArray(argv[0], dataset) };
+    query.Values = { 81.66 };
+    query.Encoding = encoding;
+    std::vector<ContourRequest> requests;
+    std::vector<std::string> resultFiles;
+    GetQueryRequests(query, requestDir, &requests, &resultFiles);
+    r0 = resultFiles[0];
+    command = FormatBatchCommand({ query }, requestId);
+  }
+  else
+  {
+    std::ostringstream cmd;
+    cmd << argv[0] << " " << static_cast<int>(encoding);
+    if (dataset)
+    {
+      cmd << " " << dataset;
+    }
+    cmd << std::endl;
+    command = cmd.str();
+  }
   std::string outputPng = std::filesystem::path(argv[0]).stem().string() + ".png";
-  std::cout << "pushdown analysis command file: " << pushdown_command_dest << std::endl;
-  std::cout << "pushdown result file: " << result_prefix << "[0-2]" << std::endl;
+  std::cout << "pushdown analysis command " << GetTransportName(transport) << ": "
+            << pushdown_command_dest << std::endl;
+  if (requestDir.empty())
+  {
+    std::cout << "pushdown result file: " << result_prefix << "[0-2]" << std::endl;
+  }
+  else
+  {
+    std::cout << "request id: " << requestId << std::endl;
+    std::cout << "pushdown result dir: " << requestDir << std::endl;
+  }
   std::cout << "vtk file: " << argv[0] << std::endl;
-  Run(pushdown_command_dest, r0.c_str(), r1.c_str(), r2.c_str(), argv[0], outputPng.c_str());
+  std::cout << "encoding: " << GetMeshEncodingName(encoding) << std::endl;
+  Run(pushdown_command_dest, transport, requestId, command, r0.c_str(), r1.c_str(), r2.c_str(),
+    outputPng.c_str(), encoding);
+  if (!requestDir.empty())
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(requestDir, ec);
+  }
   return 0;
 }
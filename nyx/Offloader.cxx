@@ -32,58 +32,719 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <vtkContourFilter.h>
-#include <vtkDataObject.h>
+#include "BenchStats.h"
+#include "ContourEngine.h"
+#include "EdgeMesh.h"
+#include "MappedImageReader.h"
+#include "MeshIO.h"
+#include "MeshStream.h"
+#include "NyxHDF5Reader.h"
+#include "OffloadServer.h"
+#include "OutOfCoreContour.h"
+#include "PushdownProtocol.h"
+#include "ResultCache.h"
+
+#include <vtkDataArray.h>
+#include <vtkDataArraySelection.h>
+#include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 #include <vtkXMLImageDataReader.h>
-#include <vtkXMLPolyDataWriter.h>
 
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <sstream>
 #include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * State that outlives a single query. In server mode one context answers
+ * every query, so the reader and the contour filter stay warm and a repeated
+ * query on an unchanged file re-uses the previous isosurface. With mapped set
+ * the volume is mapped with ReadMappedImage() instead of parsed by
+ * vtkXMLImageDataReader. With a memory budget the volume is never loaded
+ * whole but streamed through ContourOutOfCore(). HDF5 inputs are read with
+ * ReadNyxHDF5(), from the dataset the query names. Only the point arrays the
+ * query contours are read from .vti inputs; the rest are never decoded.
+ */
+class OffloadContext
+{
+public:
+  OffloadContext(ContourEngine engine, bool mapped, size_t budget);
+  vtkPolyDataAlgorithm* Contour(const char* inputFile);
+  const IsoSurface* ContourEdges(
+    const char* inputFile, int dims[3], double origin[3], double spacing[3]);
+  bool ContourToStream(const char* inputFile, const char* outputFile);
+  const IsoSurface* ContourOutOfCore(const char* inputFile, RawImageArray* volume);
+  vtkSmartPointer<vtkPolyData> ContourQuery(
+    const char* inputFile, const ContourRequest& request, ContourEngine engine);
+  size_t GetBudget() const { return this->Budget; }
+  void SetDataset(const std::string& dataset) { this->Dataset = dataset; }
+  void SetArrays(const std::vector<std::string>& arrays) { this->Arrays = arrays; }
+  void SetSubset(const int extent[6]);
+
+private:
+  vtkImageData* Load(const char* inputFile);
+  vtkImageData* Read(const char* inputFile, bool* reread);
+  bool HasArrays() const;
+
+  bool Mapped;
+  vtkNew<vtkXMLImageDataReader> Reader;
+  vtkSmartPointer<vtkImageData> Image;
+  vtkSmartPointer<vtkPolyDataAlgorithm> Filter;
+  std::string FileName;
+  std::filesystem::file_time_type FileTime;
+  IsoSurface Edges;
+  vtkMTimeType EdgesTime = 0;
+  size_t Budget;
+  std::string Dataset = NyxDensityDataset;
+  std::string LoadedDataset;
+  int Subset[6];
+  bool HasSubset = false;
+  std::vector<std::string> Arrays;
+  std::vector<std::string> LoadedArrays;
+  RawImageArray Volume;
+  IsoSurface Streamed;
+  std::string StreamedName;
+  std::filesystem::file_time_type StreamedTime;
+};
+
+OffloadContext::OffloadContext(ContourEngine engine, bool mapped, size_t budget)
+  : Mapped(mapped)
+  , Budget(budget)
+{
+  this->Filter = NewContourFilter(engine, "baryon_density", 81.66);
+  this->Arrays = { "baryon_density" };
+  if (!mapped)
+  {
+    this->Filter->SetInputConnection(this->Reader->GetOutputPort());
+  }
+}
+
+/*
+ * Restricts HDF5 reads to a hyperslab.
+ */
+void OffloadContext::SetSubset(const int extent[6])
+{
+  std::copy(extent, extent + 6, this->Subset);
+  this->HasSubset = true;
+}
+
+/*
+ * Returns the (possibly cached) volume of inputFile, or nullptr if it cannot
+ * be mapped or read, and reports how many bytes a fresh read cost.
+ */
+vtkImageData* OffloadContext::Load(const char* inputFile)
+{
+  IOCounters io0, io1;
+  const bool haveIO = GetIOCounters(&io0);
+  bool reread = false;
+  vtkImageData* const image = this->Read(inputFile, &reread);
+  if (image && reread && haveIO && GetIOCounters(&io1))
+  {
+    std::cout << "bytes-read: " << io1.ReadChars - io0.ReadChars << std::endl
+              << "storage-bytes-read: " << io1.StorageBytes - io0.StorageBytes << std::endl;
+  }
+  return image;
+}
+
+/*
+ * Whether the loaded .vti volume holds every array queries need now.
+ */
+bool OffloadContext::HasArrays() const
+{
+  for (const std::string& array : this->Arrays)
+  {
+    if (std::find(this->LoadedArrays.begin(), this->LoadedArrays.end(), array) ==
+      this->LoadedArrays.end())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+vtkImageData* OffloadContext::Read(const char* inputFile, bool* reread)
+{
+  std::error_code ec;
+  std::filesystem::file_time_type fileTime = std::filesystem::last_write_time(inputFile, ec);
+  const bool hdf5 = IsHDF5File(inputFile);
+  const bool changed = this->FileName != inputFile || this->FileTime != fileTime ||
+    (hdf5 ? this->LoadedDataset != this->Dataset : !this->HasArrays());
+  if (changed)
+  {
+    this->FileName = inputFile;
+    this->FileTime = fileTime;
+  }
+  *reread = changed;
+  if (hdf5)
+  {
+    if (changed || !this->Image)
+    {
+      *reread = true;
+      this->Image = ReadNyxHDF5(
+        inputFile, this->Dataset, "baryon_density", this->HasSubset ? this->Subset : nullptr);
+      if (!this->Image)
+      {
+        this->FileName.clear();
+        return nullptr;
+      }
+      this->LoadedDataset = this->Dataset;
+      this->Filter->SetInputData(this->Image);
+    }
+    return this->Image;
+  }
+  if (this->Mapped)
+  {
+    if (changed || !this->Image)
+    {
+      *reread = true;
+      const uint64_t copied = GetMappedCopiedBytes();
+      this->Image = ReadMappedImage(inputFile, this->Arrays);
+      if (!this->Image)
+      {
+        this->FileName.clear();
+        return nullptr;
+      }
+      std::cout << "mapped-copied-bytes: " << GetMappedCopiedBytes() - copied << std::endl;
+      this->LoadedArrays = this->Arrays;
+      this->Filter->SetInputData(this->Image);
+    }
+    return this->Image;
+  }
+  if (changed)
+  {
+    this->Image = nullptr;
+    this->Reader->SetFileName(inputFile);
+    this->Reader->Modified(); // The file may have been rewritten under the same name
+    this->Filter->SetInputConnection(this->Reader->GetOutputPort()); // In case HDF5 was read
+    // Arrays first seen in this file come up enabled, so select again
+    this->Reader->UpdateInformation();
+    vtkDataArraySelection* selection = this->Reader->GetPointDataArraySelection();
+    selection->DisableAllArrays();
+    for (const std::string& array : this->Arrays)
+    {
+      selection->EnableArray(array.c_str());
+    }
+    this->Reader->GetCellDataArraySelection()->DisableAllArrays();
+    this->LoadedArrays = this->Arrays;
+  }
+  this->Reader->Update();
+  return this->Reader->GetOutput();
+}
 
-int Run(
-  const char* inputFile, const char* outputFile1, const char* outputFile2, const char* outputFile3)
+vtkPolyDataAlgorithm* OffloadContext::Contour(const char* inputFile)
 {
-  vtkNew<vtkXMLImageDataReader> reader;
-  reader->SetFileName(inputFile);
-  reader->Update();
+  if (!this->Load(inputFile))
+  {
+    return nullptr;
+  }
+  this->Filter->Update();
+  return this->Filter;
+}
+
+/*
+ * Edge encoding needs every vertex as a lattice edge, which only the
+ * structured kernel keeps, so this path always uses it. origin and spacing
+ * place the lattice, as IsoSurfaceToPolyData() would for the image.
+ */
+const IsoSurface* OffloadContext::ContourEdges(
+  const char* inputFile, int dims[3], double origin[3], double spacing[3])
+{
+  vtkImageData* const image = this->Load(inputFile);
+  if (!image)
+  {
+    return nullptr;
+  }
+  int extent[6];
+  image->GetExtent(extent);
+  image->GetDimensions(dims);
+  image->GetOrigin(origin);
+  image->GetSpacing(spacing);
+  for (int c = 0; c < 3; c++)
+  {
+    origin[c] += extent[2 * c] * spacing[c];
+  }
+  if (this->EdgesTime != image->GetMTime())
+  {
+    if (!ContourImage(
+          image, image->GetPointData()->GetArray("baryon_density"), 81.66, &this->Edges))
+    {
+      return nullptr;
+    }
+    this->EdgesTime = image->GetMTime();
+  }
+  return &this->Edges;
+}
+
+/*
+ * Contours the volume slab by slab along z with the structured kernel and
+ * appends each slab's triangles to the result stream as soon as it is done.
+ */
+bool OffloadContext::ContourToStream(const char* inputFile, const char* outputFile)
+{
+  const int slabPlanes = 32;
+  MeshStreamWriter writer;
+  if (!writer.Open(outputFile))
+  {
+    return false;
+  }
+  vtkImageData* const image = this->Load(inputFile);
+  if (!image)
+  {
+    writer.Close();
+    return false;
+  }
+  vtkDataArray* const scalars = image->GetPointData()->GetArray("baryon_density");
+  int dims[3];
+  image->GetDimensions(dims);
+  IsoSurface surface;
+  for (int z = 0; z + 1 < dims[2]; z += slabPlanes)
+  {
+    if (!ContourImageSlab(
+          image, scalars, 81.66, z, std::min(z + slabPlanes, dims[2] - 1), &surface))
+    {
+      writer.Close();
+      return false;
+    }
+    if (!writer.Write(IsoSurfaceToPolyData(surface, image)))
+    {
+      writer.Close();
+      return false;
+    }
+  }
+  return writer.Close();
+}
+
+/*
+ * Re-streams the volume only if it changed since the last query; the
+ * stitched isosurface is kept in between.
+ */
+const IsoSurface* OffloadContext::ContourOutOfCore(const char* inputFile, RawImageArray* volume)
+{
+  std::error_code ec;
+  std::filesystem::file_time_type fileTime = std::filesystem::last_write_time(inputFile, ec);
+  if (this->StreamedName != inputFile || this->StreamedTime != fileTime)
+  {
+    this->StreamedName.clear();
+    OutOfCoreStats stats;
+    if (!LocateRawImageArray(inputFile, "baryon_density", &this->Volume) ||
+      !::ContourOutOfCore(inputFile, this->Volume, 81.66, this->Budget, &this->Streamed, &stats))
+    {
+      return nullptr;
+    }
+    std::cout << "slabs: " << stats.Slabs << " x " << stats.SlabPlanes << " planes" << std::endl
+              << "bytes-read: " << stats.BytesRead << std::endl;
+    this->StreamedName = inputFile;
+    this->StreamedTime = fileTime;
+  }
+  *volume = this->Volume;
+  return &this->Streamed;
+}
 
-  vtkNew<vtkContourFilter> cf;
-  cf->SetInputConnection(reader->GetOutputPort());
-  cf->ComputeScalarsOff();
-  cf->ComputeNormalsOff();
-  cf->SetInputArrayToProcess(
-    0, 0, 0, vtkDataObject::FieldAssociations::FIELD_ASSOCIATION_POINTS, "baryon_density");
-  cf->SetValue(0, 81.66);
+/*
+ * Dimensions and origin of the whole lattice a raw volume array spans.
+ */
+void GetVolumeGeometry(const RawImageArray& volume, int dims[3], double origin[3])
+{
+  for (int c = 0; c < 3; c++)
+  {
+    dims[c] = volume.Extent[2 * c + 1] - volume.Extent[2 * c] + 1;
+    origin[c] = volume.Origin[c] + volume.Extent[2 * c] * volume.Spacing[c];
+  }
+}
+
+/*
+ * Contours one request of a batch query. With a budget the array is streamed
+ * through ContourOutOfCore() on its own; otherwise it is contoured in the
+ * loaded volume, which holds all arrays of the query (for HDF5 inputs the
+ * array names the dataset). Returns nullptr on failure.
+ */
+vtkSmartPointer<vtkPolyData> OffloadContext::ContourQuery(
+  const char* inputFile, const ContourRequest& request, ContourEngine engine)
+{
+  if (this->Budget)
+  {
+    RawImageArray volume;
+    IsoSurface surface;
+    OutOfCoreStats stats;
+    if (!LocateRawImageArray(inputFile, request.Array, &volume) ||
+      !::ContourOutOfCore(inputFile, volume, request.Value, this->Budget, &surface, &stats))
+    {
+      return nullptr;
+    }
+    int dims[3];
+    double origin[3];
+    GetVolumeGeometry(volume, dims, origin);
+    return IsoSurfaceToPolyData(surface, dims, origin, volume.Spacing);
+  }
+  const bool hdf5 = IsHDF5File(inputFile);
+  if (hdf5)
+  {
+    this->Dataset = request.Array;
+  }
+  vtkImageData* const image = this->Load(inputFile);
+  const char* const array = hdf5 ? "baryon_density" : request.Array.c_str();
+  if (!image || !image->GetPointData()->GetArray(array))
+  {
+    std::cerr << "No point array " << request.Array << " in " << inputFile << std::endl;
+    return nullptr;
+  }
+  vtkSmartPointer<vtkPolyDataAlgorithm> cf = NewContourFilter(engine, array, request.Value);
+  cf->SetInputData(image);
   cf->Update();
+  vtkSmartPointer<vtkPolyData> mesh = cf->GetOutput();
+  return mesh;
+}
 
-  vtkNew<vtkXMLPolyDataWriter> wr;
-  wr->SetCompressorTypeToNone();
-  wr->EncodeAppendedDataOff();
-  wr->SetInputConnection(cf->GetOutputPort());
-  wr->SetFileName(outputFile1);
-  wr->Write();
+/*
+ * Writes a finished mesh; stream encoding sends it as a single chunk.
+ */
+bool WriteResult(vtkPolyData* mesh, const char* outputFile, MeshEncoding encoding, int compression)
+{
+  if (encoding == MeshEncoding::Stream)
+  {
+    MeshStreamWriter writer;
+    if (!writer.Open(outputFile))
+    {
+      return false;
+    }
+    const bool written = writer.Write(mesh);
+    return writer.Close() && written;
+  }
+  return WriteMesh(mesh, outputFile, encoding, compression);
+}
 
-  return 0;
+/*
+ * Out-of-core queries: every encoding is served from the stitched lattice
+ * surface.
+ */
+int RunOutOfCore(OffloadContext* ctx, const char* inputFile, const char* outputFile,
+  MeshEncoding encoding)
+{
+  RawImageArray volume;
+  const IsoSurface* const surface = ctx->ContourOutOfCore(inputFile, &volume);
+  if (!surface)
+  {
+    return EXIT_FAILURE;
+  }
+  int dims[3];
+  double origin[3];
+  GetVolumeGeometry(volume, dims, origin);
+  if (encoding == MeshEncoding::Edge)
+  {
+    return WriteEdgeMesh(*surface, dims, origin, volume.Spacing, outputFile) ? 0 : EXIT_FAILURE;
+  }
+  vtkSmartPointer<vtkPolyData> mesh = IsoSurfaceToPolyData(*surface, dims, origin, volume.Spacing);
+  return WriteResult(mesh, outputFile, encoding, 0) ? 0 : EXIT_FAILURE;
+}
+
+int Run(OffloadContext* ctx, const char* inputFile, const char* outputFile1,
+  const char* outputFile2, const char* outputFile3, MeshEncoding encoding)
+{
+  if (ctx->GetBudget())
+  {
+    return RunOutOfCore(ctx, inputFile, outputFile1, encoding);
+  }
+
+  if (encoding == MeshEncoding::Stream)
+  {
+    return ctx->ContourToStream(inputFile, outputFile1) ? 0 : EXIT_FAILURE;
+  }
+
+  if (encoding == MeshEncoding::Edge)
+  {
+    int dims[3];
+    double origin[3], spacing[3];
+    const IsoSurface* const surface = ctx->ContourEdges(inputFile, dims, origin, spacing);
+    if (!surface || !WriteEdgeMesh(*surface, dims, origin, spacing, outputFile1))
+    {
+      return EXIT_FAILURE;
+    }
+    return 0;
+  }
+
+  vtkPolyDataAlgorithm* const cf = ctx->Contour(inputFile);
+
+  return cf && WriteMesh(cf->GetOutput(), outputFile1, encoding, 0) ? 0 : EXIT_FAILURE;
+}
+
+/*
+ * Runs a query through the result cache: a repeated query on an unchanged
+ * input is answered from it, the result of any other is cached once written.
+ */
+int RunCached(OffloadContext* ctx, ResultCache* cache, const char* inputFile,
+  const char* const resultFiles[3], MeshEncoding encoding, const std::string& field,
+  const char* engine)
+{
+  const std::string key = MakeResultKey(inputFile, field, 81.66, engine, encoding, 0);
+  if (!key.empty() && cache->Serve(key, resultFiles[0]))
+  {
+    std::cout << "baryon-cache: hit" << std::endl;
+    cache->Print(std::cout);
+    return 0;
+  }
+  const ResultStamp stamp = GetResultStamp(resultFiles[0]);
+  int rc = Run(ctx, inputFile, resultFiles[0], resultFiles[1], resultFiles[2], encoding);
+  if (rc == 0)
+  {
+    cache->Store(key, resultFiles[0], stamp);
+  }
+  cache->Print(std::cout);
+  return rc;
+}
+
+/*
+ * Answers a version 2 command, query by query. A query's engine is a contour
+ * engine name or default for the server's own; edge encoding never gets
+ * here, ParseBatchCommand() rejects it. Returns nonzero if any query failed;
+ * the others are answered regardless.
+ */
+int RunBatch(OffloadContext* ctx, ResultCache* cache, const std::vector<PushdownQuery>& queries,
+  const std::string& resultDir, ContourEngine defaultEngine)
+{
+  int failed = 0;
+  for (const PushdownQuery& query : queries)
+  {
+    ContourEngine engine = defaultEngine;
+    if (query.Engine != "default" && !ParseContourEngine(query.Engine.c_str(), &engine))
+    {
+      std::cerr << "Unknown engine in query " << query.Name << ": " << query.Engine << std::endl;
+      failed++;
+      continue;
+    }
+    const char* const inputFile = query.InputFile.c_str();
+    const char* const engineName =
+      ctx->GetBudget() ? "out-of-core" : GetContourEngineName(engine);
+    std::vector<ContourRequest> requests;
+    std::vector<std::string> resultFiles;
+    GetQueryRequests(query, resultDir, &requests, &resultFiles);
+    ctx->SetArrays(query.Arrays);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    bool ok = true;
+    for (size_t i = 0; i < requests.size() && ok; i++)
+    {
+      const char* const resultFile = resultFiles[i].c_str();
+      std::string key;
+      if (cache->IsEnabled())
+      {
+        key = MakeResultKey(inputFile, requests[i].Array, requests[i].Value, engineName,
+          query.Encoding, query.Compression);
+        if (!key.empty() && cache->Serve(key, resultFile))
+        {
+          continue;
+        }
+      }
+      const ResultStamp stamp = GetResultStamp(resultFile);
+      vtkSmartPointer<vtkPolyData> mesh = ctx->ContourQuery(inputFile, requests[i], engine);
+      ok = mesh && WriteResult(mesh, resultFile, query.Encoding, query.Compression);
+      if (ok && cache->IsEnabled())
+      {
+        cache->Store(key, resultFile, stamp);
+      }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "query-" << query.Name << ": " << std::chrono::duration<double>(t1 - t0).count()
+              << std::endl;
+    if (!ok)
+    {
+      std::cerr << "Query " << query.Name << " failed" << std::endl;
+      failed++;
+    }
+  }
+  ctx->SetArrays({ "baryon_density" });
+  std::cout << "batch-queries: " << queries.size() << std::endl;
+  if (cache->IsEnabled())
+  {
+    cache->Print(std::cout);
+  }
+  return failed ? EXIT_FAILURE : 0;
 }
 
 /*
- * Usage: argc=5, argv1=command_file, argv2=result_file1, argv3=result_file2,
- *   argv4=result_file3
+ * Usage: [-w | -u | -q] [-p workers [-P fifo|sjf]] [-e engine] [-n threads] [-m]
+ *        [-o budget-MiB] [-k extent] [-c cache-MiB]
+ *        command_file result_file1 result_file2 result_file3
+ *   -w: keep running and answer every rewrite of command_file
+ *   -u: keep running and accept commands on the unix socket command_file
+ *   -q: keep running and answer the commands clients spool into the
+ *       directory command_file (see ServeSpool())
+ *   -p: answer up to this many socket or spool requests concurrently, each
+ *       worker with its own warm reader and filter
+ *   -P: which queued request a free worker takes: the oldest (fifo, the
+ *       default) or the one with the least input to contour (sjf)
+ *   -e: contour engine (generic, flying-edges, synchronized-templates or structured)
+ *   -n: number of contouring threads (default: all cores)
+ *   -m: map the input volume instead of parsing it (raw appended .vti only)
+ *   -o: contour out of core, streaming z-slabs through this many MiB (raw appended .vti only)
+ *   -k: read only this extent (x0,x1,y0,y1,z0,z1) of HDF5 inputs
+ *   -c: keep up to this many MiB of results in memory and answer repeated
+ *       queries on unchanged inputs from them
+ * A version 1 command is "input_file [encoding [hdf5_dataset]]"; version 2
+ * batches are described in PushdownProtocol.h, their results are written
+ * next to result_file1. Only version 2 commands with a request id keep the
+ * results of concurrent requests apart.
  */
 int main(int argc, char* argv[])
 {
-  if (argc < 5)
+  bool watch = false, useSocket = false, spool = false;
+  ContourEngine engine = ContourEngine::Generic;
+  int numThreads = 0;
+  bool mapped = false;
+  size_t budget = 0;
+  int extent[6];
+  bool subset = false;
+  ResultCache cache;
+  ServePool pool;
+  pool.Workers = 0;
+  pool.EstimateCost = EstimateCommandCost;
+  pool.MatchRequestId = MatchesRequestId;
+  int c;
+  while ((c = getopt(argc, argv, "wuqp:P:e:n:mo:k:c:")) != -1)
   {
-    exit(EXIT_FAILURE);
+    switch (c)
+    {
+      case 'q':
+        spool = true;
+        break;
+      case 'p':
+        pool.Workers = atoi(optarg);
+        break;
+      case 'P':
+        if (!ParseSchedulePolicy(optarg, &pool.Policy))
+        {
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'c':
+        cache.SetBudget(static_cast<size_t>(atol(optarg)) << 20);
+        break;
+      case 'e':
+        if (!ParseContourEngine(optarg, &engine))
+        {
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'n':
+        numThreads = atoi(optarg);
+        break;
+      case 'm':
+        mapped = true;
+        break;
+      case 'o':
+        budget = static_cast<size_t>(atol(optarg)) << 20;
+        break;
+      case 'k':
+        subset = ParseExtent(optarg, extent);
+        if (!subset)
+        {
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 'w':
+        watch = true;
+        break;
+      case 'u':
+        useSocket = true;
+        break;
+      default:
+        exit(EXIT_FAILURE);
+    }
   }
-  std::ifstream input(argv[1] /* command file */);
-  std::string fileName;
-  input >> fileName;
-  if (!input.good())
+  argc -= optind;
+  argv += optind;
+  if (argc < 4)
   {
     exit(EXIT_FAILURE);
   }
-  return Run(fileName.c_str(), argv[2], argv[3], argv[4] /* result files */);
+  const char* commandFile = argv[0];
+  const char* const resultFiles[3] = { argv[1], argv[2], argv[3] };
+
+  std::cout << "engine: " << GetContourEngineName(engine) << std::endl
+            << "threads: " << InitializeContourThreads(numThreads, engine) << std::endl
+            << "reader: " << (budget ? "out-of-core" : mapped ? "mapped" : "xml") << std::endl;
+  // One context per worker: readers and filters are not shared between
+  // concurrent requests
+  std::vector<std::unique_ptr<OffloadContext>> contexts(std::max(pool.Workers, 1));
+  for (std::unique_ptr<OffloadContext>& context : contexts)
+  {
+    context.reset(new OffloadContext(engine, mapped, budget));
+    if (subset)
+    {
+      context->SetSubset(extent);
+    }
+  }
+  const std::filesystem::path resultPath(resultFiles[0]);
+  const std::string resultDir =
+    resultPath.has_parent_path() ? resultPath.parent_path().string() : ".";
+  PooledQueryHandler handler = [&](const std::string& command, int worker) {
+    OffloadContext& ctx = *contexts[worker];
+    if (IsBatchCommand(command))
+    {
+      std::vector<PushdownQuery> queries;
+      std::string requestId;
+      if (!ParseBatchCommand(command, &queries, &requestId))
+      {
+        return EXIT_FAILURE;
+      }
+      const std::string requestDir = GetRequestResultDir(resultDir, requestId);
+      std::error_code ec;
+      std::filesystem::create_directories(requestDir, ec);
+      return RunBatch(&ctx, &cache, queries, requestDir, engine);
+    }
+    std::istringstream input(command);
+    std::string fileName;
+    input >> fileName;
+    if (input.fail())
+    {
+      return EXIT_FAILURE;
+    }
+    int value = 0; // Optional, older runners only send the file name
+    input >> value;
+    MeshEncoding encoding;
+    if (!GetMeshEncoding(value, &encoding))
+    {
+      std::cerr << "Unknown encoding " << value << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::string dataset; // Optional too, for HDF5 inputs
+    input >> dataset;
+    if (dataset.empty())
+    {
+      dataset = NyxDensityDataset;
+    }
+    ctx.SetDataset(dataset);
+    if (cache.IsEnabled())
+    {
+      const std::string field = IsHDF5File(fileName.c_str()) ? dataset : "baryon_density";
+      return RunCached(&ctx, &cache, fileName.c_str(), resultFiles, encoding, field,
+        budget ? "out-of-core" : GetContourEngineName(engine));
+    }
+    return Run(&ctx, fileName.c_str(), resultFiles[0], resultFiles[1], resultFiles[2], encoding);
+  };
+  if (spool)
+  {
+    return ServeSpool(commandFile, handler, pool);
+  }
+  if (useSocket && pool.Workers > 0)
+  {
+    return ServeSocketPool(commandFile, handler, pool);
+  }
+  QueryHandler single = [&](const std::string& command) { return handler(command, 0); };
+  if (useSocket)
+  {
+    return ServeSocket(commandFile, single);
+  }
+  if (watch)
+  {
+    return ServeWatch(commandFile, single);
+  }
+  return ServeOnce(commandFile, single);
 }
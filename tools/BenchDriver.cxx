@@ -0,0 +1,662 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BenchStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <map>
+#include <sched.h>
+#include <signal.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * One cell of the benchmark matrix.
+ */
+struct BenchConfig
+{
+  std::string Path; // "baseline" or "offload"
+  std::string Dataset;
+  std::string Fields;
+  std::string Compression;
+  int Threads;
+};
+
+/*
+ * Stage samples of one cell, by stage name, and the repetitions that failed.
+ */
+struct BenchResult
+{
+  BenchConfig Config;
+  std::map<std::string, LatencyStats> Stages;
+  int Failures = 0;
+};
+
+std::vector<std::string> SplitList(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::istringstream input(list);
+  std::string item;
+  while (std::getline(input, item, ','))
+  {
+    if (!item.empty())
+    {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/*
+ * Drops the cached pages of an input: the file itself, or every file under
+ * it for a directory, and the sibling files sharing its stem (.brk.idx
+ * indexes, .parts pieces, ...). Only clean pages are dropped, which is all
+ * a read-only benchmark leaves behind.
+ */
+void EvictFromPageCache(const std::filesystem::path& input)
+{
+  std::vector<std::filesystem::path> files;
+  std::error_code ec;
+  if (std::filesystem::is_directory(input, ec))
+  {
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(input, ec))
+    {
+      files.push_back(entry.path());
+    }
+  }
+  else
+  {
+    const std::string stem = input.stem().string();
+    const std::filesystem::path dir = input.has_parent_path() ? input.parent_path() : ".";
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+    {
+      if (entry.path().filename().string().compare(0, stem.size(), stem) == 0)
+      {
+        files.push_back(entry.path());
+      }
+    }
+    files.push_back(input);
+  }
+  for (const std::filesystem::path& file : files)
+  {
+    if (!std::filesystem::is_regular_file(file, ec))
+    {
+      continue;
+    }
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+      continue;
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+/*
+ * Starts args in workDir with its stdout on outFd, pinned to the first cpus
+ * CPUs (all if 0).
+ */
+pid_t StartProcess(const std::vector<std::string>& args, const std::string& workDir, int cpus,
+  int outFd)
+{
+  std::vector<std::string> copy(args);
+  std::vector<char*> argv;
+  for (std::string& arg : copy)
+  {
+    argv.push_back(&arg[0]);
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid = fork();
+  if (pid != 0)
+  {
+    return pid;
+  }
+  dup2(outFd, STDOUT_FILENO);
+  if (chdir(workDir.c_str()) != 0)
+  {
+    perror(workDir.c_str());
+    _exit(127);
+  }
+  cpu_set_t allowed;
+  if (cpus > 0 && sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+  {
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    for (int cpu = 0, n = 0; cpu < CPU_SETSIZE && n < cpus; cpu++)
+    {
+      if (CPU_ISSET(cpu, &allowed))
+      {
+        CPU_SET(cpu, &pinned);
+        n++;
+      }
+    }
+    sched_setaffinity(0, sizeof(pinned), &pinned);
+  }
+  execv(argv[0], argv.data());
+  perror(argv[0]);
+  _exit(127);
+}
+
+/*
+ * Runs args to completion, collecting its stdout. Returns its exit status,
+ * or -1 if it did not exit normally.
+ */
+int RunProcess(const std::vector<std::string>& args, const std::string& workDir, int cpus,
+  std::string* output)
+{
+  int fds[2];
+  if (pipe2(fds, O_CLOEXEC) != 0)
+  {
+    perror("pipe");
+    return -1;
+  }
+  pid_t pid = StartProcess(args, workDir, cpus, fds[1]);
+  close(fds[1]);
+  if (pid < 0)
+  {
+    close(fds[0]);
+    return -1;
+  }
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(fds[0], buf, sizeof(buf))) != 0)
+  {
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    output->append(buf, n);
+  }
+  close(fds[0]);
+  int status;
+  if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+  {
+    return -1;
+  }
+  return WEXITSTATUS(status);
+}
+
+/*
+ * Waits up to 30 s for an Offloader to listen on socketPath. The probe
+ * connection carries no command, which the server ignores.
+ */
+bool WaitForSocket(const std::string& socketPath, pid_t server)
+{
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (std::chrono::steady_clock::now() < deadline)
+  {
+    if (waitpid(server, nullptr, WNOHANG) == server)
+    {
+      return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    bool ok = fd >= 0 && connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+    if (ok)
+    {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+void StopServer(pid_t server)
+{
+  kill(server, SIGTERM);
+  waitpid(server, nullptr, 0);
+}
+
+/*
+ * Records the "<stage>: <number>" lines of a runner's output for the given
+ * stages.
+ */
+void ParseStages(
+  const std::string& output, const std::vector<std::string>& stages, BenchResult* result)
+{
+  std::istringstream input(output);
+  std::string line;
+  while (std::getline(input, line))
+  {
+    const size_t colon = line.find(": ");
+    if (colon == std::string::npos)
+    {
+      continue;
+    }
+    const std::string key = line.substr(0, colon);
+    if (std::find(stages.begin(), stages.end(), key) == stages.end())
+    {
+      continue;
+    }
+    const char* value = line.c_str() + colon + 2;
+    char* end;
+    double number = strtod(value, &end);
+    if (end != value)
+    {
+      result->Stages[key].Add(number);
+    }
+  }
+}
+
+class BenchDriver
+{
+public:
+  std::string Kind = "asteroid";
+  std::string BinDir;
+  std::string WorkDir;
+  std::vector<std::string> Stages;
+  int Repetitions = 5;
+  int Warmups = 1;
+  bool Cold = false;
+
+  /*
+   * Runs the warmups and repetitions of one cell.
+   */
+  BenchResult Run(const BenchConfig& config);
+
+private:
+  std::vector<std::string> GetRunnerArgs(const BenchConfig& config) const;
+  std::vector<std::string> GetOffloaderArgs(const BenchConfig& config) const;
+  pid_t StartOffloader(const BenchConfig& config);
+  bool RunOnce(const BenchConfig& config, BenchResult* result);
+
+  std::string GetSocketPath() const { return this->WorkDir + "/offload.sock"; }
+};
+
+std::vector<std::string> BenchDriver::GetRunnerArgs(const BenchConfig& config) const
+{
+  const bool nyx = this->Kind == "nyx";
+  const bool offload = config.Path == "offload";
+  std::vector<std::string> args;
+  args.push_back(this->BinDir + "/" + this->Kind + "/" + (nyx ? "Nyx" : "") +
+    (offload ? "OffloadRunner" : "BaselineRunner"));
+  if (offload)
+  {
+    args.push_back("-u");
+    args.push_back(this->GetSocketPath());
+    args.push_back("-s");
+    args.push_back(this->WorkDir + "/result");
+  }
+  if (nyx)
+  {
+    if (!offload && config.Threads > 0)
+    {
+      args.push_back("-n");
+      args.push_back(std::to_string(config.Threads));
+    }
+  }
+  else
+  {
+    args.push_back("-" + config.Fields);
+    if (config.Compression == "lz4")
+    {
+      args.push_back("-l");
+    }
+    else if (config.Compression == "gz")
+    {
+      args.push_back("-g");
+    }
+  }
+  args.push_back(config.Dataset);
+  return args;
+}
+
+std::vector<std::string> BenchDriver::GetOffloaderArgs(const BenchConfig& config) const
+{
+  const bool nyx = this->Kind == "nyx";
+  std::vector<std::string> args;
+  args.push_back(this->BinDir + "/" + this->Kind + "/" + (nyx ? "NyxOffloader" : "Offloader"));
+  if (nyx && config.Threads > 0)
+  {
+    args.push_back("-n");
+    args.push_back(std::to_string(config.Threads));
+  }
+  args.push_back("-u");
+  args.push_back(this->GetSocketPath());
+  for (int i = 0; i < 3; i++)
+  {
+    args.push_back(this->WorkDir + "/result" + std::to_string(i));
+  }
+  return args;
+}
+
+pid_t BenchDriver::StartOffloader(const BenchConfig& config)
+{
+  const std::string log = this->WorkDir + "/offloader.log";
+  int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    perror(log.c_str());
+    return -1;
+  }
+  unlink(this->GetSocketPath().c_str()); // Left behind by a server that died
+  pid_t server = StartProcess(this->GetOffloaderArgs(config), this->WorkDir, config.Threads, fd);
+  close(fd);
+  if (server < 0)
+  {
+    return -1;
+  }
+  if (!WaitForSocket(this->GetSocketPath(), server))
+  {
+    std::cerr << "Offloader did not start, see " << log << std::endl;
+    StopServer(server);
+    return -1;
+  }
+  return server;
+}
+
+bool BenchDriver::RunOnce(const BenchConfig& config, BenchResult* result)
+{
+  std::string output;
+  auto t0 = std::chrono::high_resolution_clock::now();
+  int rc = RunProcess(this->GetRunnerArgs(config), this->WorkDir, config.Threads, &output);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  if (rc != 0)
+  {
+    return false;
+  }
+  if (result)
+  {
+    ParseStages(output, this->Stages, result);
+    result->Stages["wall"].Add(std::chrono::duration<double>(t1 - t0).count());
+  }
+  return true;
+}
+
+BenchResult BenchDriver::Run(const BenchConfig& config)
+{
+  BenchResult result;
+  result.Config = config;
+  const bool offload = config.Path == "offload";
+  pid_t server = -1;
+  for (int i = 0; i < this->Warmups + this->Repetitions; i++)
+  {
+    const bool warmup = i < this->Warmups;
+    if (this->Cold)
+    {
+      // Restarted too, so no reader state survives in the Offloader either
+      if (server > 0)
+      {
+        StopServer(server);
+        server = -1;
+      }
+      EvictFromPageCache(config.Dataset);
+    }
+    if (offload && server < 0 && (server = this->StartOffloader(config)) < 0)
+    {
+      result.Failures += this->Warmups + this->Repetitions - i;
+      break;
+    }
+    if (!this->RunOnce(config, warmup ? nullptr : &result) && !warmup)
+    {
+      result.Failures++;
+    }
+  }
+  if (server > 0)
+  {
+    StopServer(server);
+  }
+  return result;
+}
+
+void PrintCSV(std::ostream& os, const std::string& kind, bool cold,
+  const std::vector<BenchResult>& results)
+{
+  os << "kind,path,dataset,fields,compression,threads,cache,failures,stage,count,median,p95,min,"
+        "max"
+     << std::endl;
+  for (const BenchResult& result : results)
+  {
+    const BenchConfig& config = result.Config;
+    std::map<std::string, LatencyStats> stages = result.Stages;
+    if (stages.empty())
+    {
+      stages["wall"]; // Every repetition failed; still report the cell
+    }
+    for (const auto& stage : stages)
+    {
+      const LatencyStats& stats = stage.second;
+      os << kind << "," << config.Path << "," << config.Dataset << "," << config.Fields << ","
+         << config.Compression << "," << config.Threads << "," << (cold ? "cold" : "warm") << ","
+         << result.Failures << "," << stage.first << "," << stats.GetCount() << ","
+         << stats.GetPercentile(50) << "," << stats.GetPercentile(95) << ","
+         << stats.GetPercentile(0) << "," << stats.GetPercentile(100) << std::endl;
+    }
+  }
+}
+
+std::string QuoteJSON(const std::string& text)
+{
+  std::string quoted = "\"";
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+void PrintJSON(std::ostream& os, const std::string& kind, bool cold,
+  const std::vector<BenchResult>& results)
+{
+  os << "[" << std::endl;
+  for (size_t r = 0; r < results.size(); r++)
+  {
+    const BenchConfig& config = results[r].Config;
+    os << "  {\"kind\": " << QuoteJSON(kind) << ", \"path\": " << QuoteJSON(config.Path)
+       << ", \"dataset\": " << QuoteJSON(config.Dataset)
+       << ", \"fields\": " << QuoteJSON(config.Fields)
+       << ", \"compression\": " << QuoteJSON(config.Compression)
+       << ", \"threads\": " << config.Threads << ", \"cache\": " << (cold ? "\"cold\"" : "\"warm\"")
+       << ", \"failures\": " << results[r].Failures << "," << std::endl
+       << "   \"stages\": {";
+    const char* separator = "";
+    for (const auto& stage : results[r].Stages)
+    {
+      const LatencyStats& stats = stage.second;
+      os << separator << std::endl
+         << "    " << QuoteJSON(stage.first) << ": {\"count\": " << stats.GetCount()
+         << ", \"median\": " << stats.GetPercentile(50)
+         << ", \"p95\": " << stats.GetPercentile(95) << ", \"min\": " << stats.GetPercentile(0)
+         << ", \"max\": " << stats.GetPercentile(100) << "}";
+      separator = ",";
+    }
+    os << "}}" << (r + 1 < results.size() ? "," : "") << std::endl;
+  }
+  os << "]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchDriver driver;
+  driver.BinDir = std::filesystem::canonical("/proc/self/exe").parent_path().parent_path();
+  driver.Stages = SplitList("io,contouring,rendering,io-contouring,first-chunk,result-bytes,"
+                            "bytes-read,storage-bytes-read,mapped-copied-bytes,peak-rss-kb");
+  std::vector<std::string> paths = { "baseline", "offload" };
+  std::vector<std::string> fields = { "23t" };
+  std::vector<std::string> compressions = { "none" };
+  std::vector<std::string> threads = { "0" };
+  std::string outputFile;
+  bool json = false;
+  int c;
+  while ((c = getopt(argc, argv, "k:b:P:f:z:n:r:w:Cs:o:jh")) != -1)
+  {
+    switch (c)
+    {
+      case 'k':
+        driver.Kind = optarg;
+        break;
+      case 'b':
+        driver.BinDir = optarg;
+        break;
+      case 'P':
+        paths = SplitList(optarg);
+        break;
+      case 'f':
+        fields = SplitList(optarg);
+        break;
+      case 'z':
+        compressions = SplitList(optarg);
+        break;
+      case 'n':
+        threads = SplitList(optarg);
+        break;
+      case 'r':
+        driver.Repetitions = atoi(optarg);
+        break;
+      case 'w':
+        driver.Warmups = atoi(optarg);
+        break;
+      case 'C':
+        driver.Cold = true;
+        break;
+      case 's':
+        driver.Stages = SplitList(optarg);
+        break;
+      case 'o':
+        outputFile = optarg;
+        break;
+      case 'j':
+        json = true;
+        break;
+      case 'h':
+      default:
+        std::cerr
+          << "Usage: " << argv[0] << " [options] <dataset>..." << std::endl
+          << "-k asteroid|nyx to pick the runners, -b to give the build directory holding "
+          << "them, -P baseline,offload to pick the paths, -f 2,3,t,23t,... for the asteroid "
+          << "field combinations, -z none,lz4,gz for the asteroid compression modes, "
+          << "-n 0,1,4,... for the thread counts (0 for all CPUs), -r and -w for the "
+          << "repetitions and warmups of each run, -C to evict the inputs from the page cache "
+          << "before every run, -s to list the reported stages, -o to write the results to a "
+          << "file and -j to write JSON instead of CSV" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+  }
+  argc -= optind;
+  argv += optind;
+  if (!argc)
+  {
+    std::cerr << "Lack dataset filenames" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (driver.Kind != "asteroid" && driver.Kind != "nyx")
+  {
+    std::cerr << "Unknown runner kind " << driver.Kind << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (driver.Kind == "nyx")
+  {
+    // The Nyx runners contour a single field and have no compression
+    fields = { "baryon_density" };
+    compressions = { "none" };
+  }
+  const std::filesystem::path workDir = std::filesystem::temp_directory_path() /
+    ("contour-bench-" + std::to_string(getpid()));
+  std::filesystem::create_directories(workDir);
+  driver.WorkDir = workDir.string();
+
+  std::vector<BenchResult> results;
+  for (int d = 0; d < argc; d++)
+  {
+    const std::string dataset = std::filesystem::absolute(argv[d]).string();
+    for (const std::string& path : paths)
+    {
+      for (const std::string& field : fields)
+      {
+        for (const std::string& compression : compressions)
+        {
+          for (const std::string& count : threads)
+          {
+            BenchConfig config{ path, dataset, field, compression, atoi(count.c_str()) };
+            std::cerr << path << " " << dataset << " " << field << " " << compression << " "
+                      << config.Threads << std::endl;
+            results.push_back(driver.Run(config));
+          }
+        }
+      }
+    }
+  }
+  std::error_code ec;
+  std::filesystem::remove_all(workDir, ec);
+
+  std::ofstream file;
+  if (!outputFile.empty())
+  {
+    file.open(outputFile, std::ios::out | std::ios::trunc);
+  }
+  std::ostream& os = outputFile.empty() ? std::cout : file;
+  if (json)
+  {
+    PrintJSON(os, driver.Kind, driver.Cold, results);
+  }
+  else
+  {
+    PrintCSV(os, driver.Kind, driver.Cold, results);
+  }
+  return 0;
+}
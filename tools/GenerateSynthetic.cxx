@@ -0,0 +1,672 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RawImageWriter.h"
+#include "ThreadPool.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLImageDataWriter.h>
+#include <vtkXMLUnstructuredGridWriter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <iostream>
+#include <iterator>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+enum class FieldShape
+{
+  Noise,  // Smooth value noise: irregular blobs
+  Gyroid, // sin x cos y + sin y cos z + sin z cos x: a regular analytic lattice
+};
+
+/*
+ * Active cells per cell and per feature of each shape, measured at the
+ * isovalue: about this / cellsPerFeature of the cells cross the isosurface,
+ * up to ~40%. Used to turn a requested selectivity into a feature size.
+ */
+const double NoiseActiveRate = 1.47;
+const double GyroidActiveRate = 4.85;
+
+/*
+ * Beyond this the features shrink to a few cells and the active fraction
+ * stops following the requested selectivity.
+ */
+const double MaxSelectivity = 0.4;
+
+/*
+ * How an array's values follow the shape n(x), so that every isosurface sits
+ * at n = 0 whatever the array's isovalue.
+ */
+enum class ValueMap
+{
+  Fraction,  // clamp(isovalue + n / 2, 0, 1), like volume fractions
+  LogNormal, // isovalue * exp(2n), like densities and temperatures
+  Linear,    // isovalue + scale * n, like velocities
+};
+
+struct SyntheticArray
+{
+  const char* Name;
+  double Isovalue;
+  ValueMap Map;
+  double Scale;
+};
+
+/*
+ * The arrays each layout holds, at the isovalues the runners contour.
+ */
+const SyntheticArray AsteroidArrays[] = {
+  { "v02", 0.8, ValueMap::Fraction, 0 },
+  { "v03", 0.5, ValueMap::Fraction, 0 },
+  { "tev", 0.1, ValueMap::LogNormal, 0 },
+};
+const SyntheticArray NyxArrays[] = {
+  { "baryon_density", 81.66, ValueMap::LogNormal, 0 },
+  // Extra arrays (-e), only read when asked for
+  { "dark_matter_density", 81.66, ValueMap::LogNormal, 0 },
+  { "temperature", 1e4, ValueMap::LogNormal, 0 },
+  { "velocity_x", 0, ValueMap::Linear, 1e7 },
+  { "velocity_y", 0, ValueMap::Linear, 1e7 },
+  { "velocity_z", 0, ValueMap::Linear, 1e7 },
+};
+
+/*
+ * Domain of the asteroid layouts: the box the asteroid runners render.
+ */
+const double AsteroidOrigin[3] = { -2300000, -500000, -1200000 };
+const double AsteroidLength[3] = { 149 * 30872.4, 149 * 18791.9, 149 * 16107.4 };
+
+/*
+ * Pieces per side of the xRAGE piece directory, as RewriteToVTU expects.
+ */
+const int PiecesPerSide = 8;
+
+uint64_t Mix(uint64_t h)
+{
+  h ^= h >> 31;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 29;
+  h *= 0x94d049bb133111ebULL;
+  return h ^ (h >> 32);
+}
+
+/*
+ * Value in [-1, 1] at integer lattice point (i, j, k).
+ */
+double LatticeValue(int64_t i, int64_t j, int64_t k, uint64_t seed)
+{
+  const uint64_t h = Mix(seed ^ (static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL) ^
+    (static_cast<uint64_t>(j) * 0xc2b2ae3d27d4eb4fULL) ^
+    (static_cast<uint64_t>(k) * 0x165667b19e3779f9ULL));
+  return (h >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+double Fade(double t)
+{
+  return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+/*
+ * The shape at x, in features (lattice cells for noise, periods for the
+ * gyroid). Deterministic in seed, so any piece can be generated on its own.
+ */
+double EvaluateShape(FieldShape shape, const double x[3], uint64_t seed)
+{
+  if (shape == FieldShape::Gyroid)
+  {
+    const double twoPi = 2 * M_PI;
+    // Each seed shifts the lattice, so the arrays do not share a surface
+    double p[3];
+    for (int c = 0; c < 3; c++)
+    {
+      p[c] = twoPi * (x[c] + (Mix(seed + c) >> 11) * (1.0 / 9007199254740992.0));
+    }
+    return std::sin(p[0]) * std::cos(p[1]) + std::sin(p[1]) * std::cos(p[2]) +
+      std::sin(p[2]) * std::cos(p[0]);
+  }
+  double f[3], w[3];
+  int64_t i[3];
+  for (int c = 0; c < 3; c++)
+  {
+    f[c] = std::floor(x[c]);
+    i[c] = static_cast<int64_t>(f[c]);
+    w[c] = Fade(x[c] - f[c]);
+  }
+  double value = 0;
+  for (int corner = 0; corner < 8; corner++)
+  {
+    const int a = corner & 1, b = (corner >> 1) & 1, d = corner >> 2;
+    value += (a ? w[0] : 1 - w[0]) * (b ? w[1] : 1 - w[1]) * (d ? w[2] : 1 - w[2]) *
+      LatticeValue(i[0] + a, i[1] + b, i[2] + d, seed);
+  }
+  return value;
+}
+
+float MapValue(const SyntheticArray& array, double n)
+{
+  switch (array.Map)
+  {
+    case ValueMap::Fraction:
+      return static_cast<float>(std::clamp(array.Isovalue + n / 2, 0.0, 1.0));
+    case ValueMap::LogNormal:
+      return static_cast<float>(array.Isovalue * std::exp(2 * n));
+    case ValueMap::Linear:
+      break;
+  }
+  return static_cast<float>(array.Isovalue + array.Scale * n);
+}
+
+struct Generator
+{
+  FieldShape Shape = FieldShape::Noise;
+  double CellsPerFeature = 1;
+  uint64_t Seed = 1;
+  int Dims[3] = { 64, 64, 64 }; // Points of the Nyx image, cells of the asteroid grids
+
+  /*
+   * Value of array a at grid position (i, j, k), in cells.
+   */
+  float Sample(const SyntheticArray& array, size_t a, double i, double j, double k) const
+  {
+    const double x[3] = { i / this->CellsPerFeature, j / this->CellsPerFeature,
+      k / this->CellsPerFeature };
+    return MapValue(array, EvaluateShape(this->Shape, x, this->Seed + 7919 * a));
+  }
+};
+
+/*
+ * Nyx layout: a raw appended .vti with Float32 point arrays on a unit
+ * lattice, baryon_density first, written slabDepth z-planes at a time.
+ */
+bool WriteNyxImage(const Generator& gen, int numArrays, int slabDepth, const char* fileName)
+{
+  std::vector<std::string> names;
+  for (int a = 0; a < numArrays; a++)
+  {
+    names.push_back(NyxArrays[a].Name);
+  }
+  const double origin[3] = { 0, 0, 0 };
+  const double spacing[3] = { 1, 1, 1 };
+  RawImageWriter writer;
+  if (!writer.Open(fileName, gen.Dims, origin, spacing, names))
+  {
+    return false;
+  }
+  const vtkIdType rowSize = gen.Dims[0];
+  const vtkIdType sliceSize = rowSize * gen.Dims[1];
+  std::vector<float> slab;
+  bool ok = true;
+  for (int k0 = 0; k0 < gen.Dims[2] && ok; k0 += slabDepth)
+  {
+    const int k1 = std::min(k0 + slabDepth, gen.Dims[2]);
+    std::cout << "Generating slab " << k0 << "-" << k1 - 1 << " ..." << std::endl;
+    slab.resize(sliceSize * (k1 - k0));
+    for (int a = 0; a < numArrays && ok; a++)
+    {
+      vtkSMPTools::For(0, sliceSize * (k1 - k0) / rowSize, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType row = begin; row < end; row++)
+        {
+          const double j = row % gen.Dims[1];
+          const double k = k0 + row / gen.Dims[1];
+          for (vtkIdType i = 0; i < rowSize; i++)
+          {
+            slab[row * rowSize + i] = gen.Sample(NyxArrays[a], a, i, j, k);
+          }
+        }
+      });
+      ok = writer.WriteSlab(a, k0, k1 - k0, slab.data());
+    }
+  }
+  return writer.Close() && ok;
+}
+
+/*
+ * Cells [begin[c], end[c]) of the asteroid grid along each axis c.
+ */
+struct Block
+{
+  int Begin[3];
+  int End[3];
+};
+
+std::vector<Block> SplitGrid(const int dims[3], int perSide)
+{
+  std::vector<Block> blocks;
+  for (int bk = 0; bk < perSide; bk++)
+  {
+    for (int bj = 0; bj < perSide; bj++)
+    {
+      for (int bi = 0; bi < perSide; bi++)
+      {
+        const int b[3] = { bi, bj, bk };
+        Block block;
+        for (int c = 0; c < 3; c++)
+        {
+          block.Begin[c] = static_cast<int>(static_cast<int64_t>(dims[c]) * b[c] / perSide);
+          block.End[c] = static_cast<int>(static_cast<int64_t>(dims[c]) * (b[c] + 1) / perSide);
+        }
+        blocks.push_back(block);
+      }
+    }
+  }
+  return blocks;
+}
+
+/*
+ * The asteroid cell arrays of block, sampled at the cell centers, x fastest.
+ */
+void AddAsteroidCellArrays(const Generator& gen, const Block& block, vtkCellData* cellData)
+{
+  const vtkIdType n[3] = { block.End[0] - block.Begin[0], block.End[1] - block.Begin[1],
+    block.End[2] - block.Begin[2] };
+  for (size_t a = 0; a < std::size(AsteroidArrays); a++)
+  {
+    vtkNew<vtkFloatArray> values;
+    values->SetName(AsteroidArrays[a].Name);
+    values->SetNumberOfTuples(n[0] * n[1] * n[2]);
+    float* p = values->GetPointer(0);
+    for (vtkIdType k = 0; k < n[2]; k++)
+    {
+      for (vtkIdType j = 0; j < n[1]; j++)
+      {
+        for (vtkIdType i = 0; i < n[0]; i++)
+        {
+          *p++ = gen.Sample(AsteroidArrays[a], a, block.Begin[0] + i + 0.5,
+            block.Begin[1] + j + 0.5, block.Begin[2] + k + 0.5);
+        }
+      }
+    }
+    cellData->AddArray(values);
+  }
+}
+
+/*
+ * One xRAGE piece: the hexahedra of block with the asteroid cell arrays.
+ * Points on piece faces get the same coordinates in both pieces, so
+ * RewriteToVTU merges them.
+ */
+vtkSmartPointer<vtkUnstructuredGrid> MakePiece(const Generator& gen, const Block& block)
+{
+  const vtkIdType n[3] = { block.End[0] - block.Begin[0], block.End[1] - block.Begin[1],
+    block.End[2] - block.Begin[2] };
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints((n[0] + 1) * (n[1] + 1) * (n[2] + 1));
+  vtkIdType id = 0;
+  for (vtkIdType k = 0; k <= n[2]; k++)
+  {
+    for (vtkIdType j = 0; j <= n[1]; j++)
+    {
+      for (vtkIdType i = 0; i <= n[0]; i++)
+      {
+        const vtkIdType g[3] = { block.Begin[0] + i, block.Begin[1] + j, block.Begin[2] + k };
+        double x[3];
+        for (int c = 0; c < 3; c++)
+        {
+          x[c] = AsteroidOrigin[c] + AsteroidLength[c] * g[c] / gen.Dims[c];
+        }
+        points->SetPoint(id++, x);
+      }
+    }
+  }
+
+  const vtkIdType numCells = n[0] * n[1] * n[2];
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> connectivity;
+  offsets->SetNumberOfValues(numCells + 1);
+  connectivity->SetNumberOfValues(8 * numCells);
+  const vtkIdType dx = 1, dy = n[0] + 1, dz = (n[0] + 1) * (n[1] + 1);
+  vtkIdType cellId = 0;
+  for (vtkIdType k = 0; k < n[2]; k++)
+  {
+    for (vtkIdType j = 0; j < n[1]; j++)
+    {
+      for (vtkIdType i = 0; i < n[0]; i++)
+      {
+        const vtkIdType p0 = i * dx + j * dy + k * dz;
+        const vtkIdType hex[8] = { p0, p0 + dx, p0 + dx + dy, p0 + dy, p0 + dz, p0 + dx + dz,
+          p0 + dx + dy + dz, p0 + dy + dz };
+        offsets->SetValue(cellId, 8 * cellId);
+        for (int v = 0; v < 8; v++)
+        {
+          connectivity->SetValue(8 * cellId + v, hex[v]);
+        }
+        cellId++;
+      }
+    }
+  }
+  offsets->SetValue(numCells, 8 * numCells);
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, connectivity);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numCells);
+  types->FillValue(VTK_HEXAHEDRON);
+
+  vtkSmartPointer<vtkUnstructuredGrid> piece = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  piece->SetPoints(points);
+  piece->SetCells(types, cells);
+  AddAsteroidCellArrays(gen, block, piece->GetCellData());
+  return piece;
+}
+
+/*
+ * Cell-data image block of the multiblock layout RewriteToVTI reads.
+ */
+vtkSmartPointer<vtkImageData> MakeImageBlock(const Generator& gen, const Block& block)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  double spacing[3], origin[3];
+  for (int c = 0; c < 3; c++)
+  {
+    spacing[c] = AsteroidLength[c] / gen.Dims[c];
+    origin[c] = AsteroidOrigin[c] + spacing[c] * block.Begin[c];
+  }
+  image->SetDimensions(block.End[0] - block.Begin[0] + 1, block.End[1] - block.Begin[1] + 1,
+    block.End[2] - block.Begin[2] + 1);
+  image->SetOrigin(origin);
+  image->SetSpacing(spacing);
+  AddAsteroidCellArrays(gen, block, image->GetCellData());
+  return image;
+}
+
+/*
+ * Writes the blocks of the grid split perSide ways along each axis, on a
+ * thread pool since each block is independent. writeBlock(b, block) returns
+ * false on failure.
+ */
+bool WriteBlocks(const Generator& gen, int perSide, int numThreads,
+  const std::function<bool(size_t, const Block&)>& writeBlock)
+{
+  const std::vector<Block> blocks = SplitGrid(gen.Dims, perSide);
+  std::atomic<bool> ok(true);
+  ThreadPool pool(numThreads);
+  for (size_t b = 0; b < blocks.size(); b++)
+  {
+    pool.Submit([&, b]() {
+      if (ok && !writeBlock(b, blocks[b]))
+      {
+        ok = false;
+      }
+    });
+  }
+  pool.Wait();
+  return ok;
+}
+
+/*
+ * xRAGE layout: dir/<name>_0_<i>.vtu for the 512 pieces, <name> being the
+ * directory name, as RewriteToVTU reads them.
+ */
+bool WritePieces(const Generator& gen, int numThreads, bool gzip, const std::string& dir)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  const std::string name = std::filesystem::path(dir).filename().string();
+  return WriteBlocks(gen, PiecesPerSide, numThreads, [&](size_t b, const Block& block) {
+    char tmp[100];
+    snprintf(tmp, sizeof(tmp), "/%s_0_%d.vtu", name.c_str(), static_cast<int>(b));
+    vtkNew<vtkXMLUnstructuredGridWriter> writer;
+    writer->SetInputData(MakePiece(gen, block));
+    writer->SetFileName((dir + tmp).c_str());
+    if (!gzip)
+    {
+      writer->SetCompressorTypeToNone();
+    }
+    return writer->Write() != 0;
+  });
+}
+
+/*
+ * Multiblock layout: fileName (.vtm) listing perSide^3 image blocks with the
+ * asteroid cell arrays, written to <stem>/<stem>_<i>.vti next to it.
+ */
+bool WriteMultiBlock(const Generator& gen, int perSide, int numThreads, bool gzip,
+  const std::string& fileName)
+{
+  const std::filesystem::path path(fileName);
+  const std::string stem = path.stem().string();
+  const std::filesystem::path blockDir = path.parent_path() / stem;
+  std::error_code ec;
+  std::filesystem::create_directories(blockDir, ec);
+  bool ok = WriteBlocks(gen, perSide, numThreads, [&](size_t b, const Block& block) {
+    const std::filesystem::path blockFile = blockDir / (stem + "_" + std::to_string(b) + ".vti");
+    vtkNew<vtkXMLImageDataWriter> writer;
+    writer->SetInputData(MakeImageBlock(gen, block));
+    writer->SetFileName(blockFile.c_str());
+    if (!gzip)
+    {
+      writer->SetCompressorTypeToNone();
+    }
+    return writer->Write() != 0;
+  });
+  if (!ok)
+  {
+    return false;
+  }
+  std::ofstream vtm(fileName, std::ios::out | std::ios::trunc);
+  vtm << "<?xml version=\"1.0\"?>\n"
+      << "<VTKFile type=\"vtkMultiBlockDataSet\" version=\"1.0\" byte_order=\"LittleEndian\" "
+         "header_type=\"UInt64\">\n"
+      << "  <vtkMultiBlockDataSet>\n";
+  const int numBlocks = perSide * perSide * perSide;
+  for (int b = 0; b < numBlocks; b++)
+  {
+    vtm << "    <DataSet index=\"" << b << "\" file=\"" << stem << "/" << stem << "_" << b
+        << ".vti\"/>\n";
+  }
+  vtm << "  </vtkMultiBlockDataSet>\n"
+      << "</VTKFile>\n";
+  vtm.close();
+  if (!vtm.good())
+  {
+    std::cerr << "Cannot write " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+uintmax_t GetOutputBytes(const std::filesystem::path& path)
+{
+  std::error_code ec;
+  if (!std::filesystem::is_directory(path, ec))
+  {
+    return std::filesystem::file_size(path, ec);
+  }
+  uintmax_t bytes = 0;
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(path, ec))
+  {
+    if (entry.is_regular_file(ec))
+    {
+      bytes += entry.file_size(ec);
+    }
+  }
+  return bytes;
+}
+
+int main(int argc, char* argv[])
+{
+  Generator gen;
+  std::string layout = "nyx";
+  double selectivity = 0.05;
+  int numExtra = 0;
+  int slabDepth = 32;
+  int perSide = 4;
+  int numThreads = 0;
+  bool gzip = false;
+  int c;
+  while ((c = getopt(argc, argv, "l:n:t:s:S:e:z:b:j:gh")) != -1)
+  {
+    switch (c)
+    {
+      case 'l':
+        layout = optarg;
+        break;
+      case 'n':
+        if (!ParseDimensions(optarg, gen.Dims))
+        {
+          std::cerr << "Bad size " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 't':
+        if (strcmp(optarg, "noise") == 0)
+        {
+          gen.Shape = FieldShape::Noise;
+        }
+        else if (strcmp(optarg, "gyroid") == 0)
+        {
+          gen.Shape = FieldShape::Gyroid;
+        }
+        else
+        {
+          std::cerr << "Unknown field " << optarg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        break;
+      case 's':
+        selectivity = atof(optarg);
+        break;
+      case 'S':
+        gen.Seed = strtoull(optarg, nullptr, 10);
+        break;
+      case 'e':
+        numExtra = std::clamp(atoi(optarg), 0, static_cast<int>(std::size(NyxArrays)) - 1);
+        break;
+      case 'z':
+        slabDepth = std::max(atoi(optarg), 1);
+        break;
+      case 'b':
+        perSide = std::max(atoi(optarg), 1);
+        break;
+      case 'j':
+        numThreads = atoi(optarg);
+        break;
+      case 'g':
+        gzip = true;
+        break;
+      case 'h':
+      default:
+        std::cerr
+          << "Usage: " << argv[0] << " [options] <output>" << std::endl
+          << "-l nyx|pieces|vtm to write a Nyx .vti, an xRAGE piece directory for "
+          << "RewriteToVTU or a multiblock .vtm for RewriteToVTI (default nyx), "
+          << "-n N or NxMxK for the size (points for nyx, cells otherwise; default 64), "
+          << "-t noise|gyroid for the field, -s for the fraction of cells the isosurfaces "
+          << "cross (default 0.05, up to 0.4), -S for the seed, "
+          << "-e to add up to 5 extra Nyx arrays, -z for the z-planes generated at a time "
+          << "(nyx), -b for the blocks per side (vtm), -j for the threads writing pieces or "
+          << "blocks, and -g to gzip them" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+  }
+  argc -= optind;
+  argv += optind;
+  if (!argc)
+  {
+    std::cerr << "Lack output filename" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (selectivity <= 0 || selectivity > MaxSelectivity)
+  {
+    std::cerr << "Selectivity must be in (0, " << MaxSelectivity << "]" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const double rate = gen.Shape == FieldShape::Gyroid ? GyroidActiveRate : NoiseActiveRate;
+  gen.CellsPerFeature = rate / selectivity;
+
+  std::cout << "layout: " << layout << std::endl
+            << "size: " << gen.Dims[0] << "x" << gen.Dims[1] << "x" << gen.Dims[2] << std::endl
+            << "field: " << (gen.Shape == FieldShape::Gyroid ? "gyroid" : "noise") << std::endl
+            << "selectivity: " << selectivity << std::endl
+            << "cells-per-feature: " << gen.CellsPerFeature << std::endl
+            << "seed: " << gen.Seed << std::endl;
+  auto t0 = std::chrono::high_resolution_clock::now();
+  bool ok;
+  if (layout == "nyx")
+  {
+    ok = WriteNyxImage(gen, 1 + numExtra, slabDepth, argv[0]);
+  }
+  else if (layout == "pieces")
+  {
+    if (std::min({ gen.Dims[0], gen.Dims[1], gen.Dims[2] }) < PiecesPerSide)
+    {
+      std::cerr << "Pieces need at least " << PiecesPerSide << " cells per side" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    ok = WritePieces(gen, numThreads, gzip, argv[0]);
+  }
+  else if (layout == "vtm")
+  {
+    if (std::min({ gen.Dims[0], gen.Dims[1], gen.Dims[2] }) < perSide)
+    {
+      std::cerr << "Blocks need at least " << perSide << " cells per side" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    ok = WriteMultiBlock(gen, perSide, numThreads, gzip, argv[0]);
+  }
+  else
+  {
+    std::cerr << "Unknown layout " << layout << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+  if (!ok)
+  {
+    exit(EXIT_FAILURE);
+  }
+  std::cout << "generate: " << std::chrono::duration<double>(t1 - t0).count() << std::endl
+            << "output-bytes: " << GetOutputBytes(argv[0]) << std::endl;
+  return 0;
+}
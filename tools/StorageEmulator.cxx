@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2025 Triad National Security, LLC, as operator of Los Alamos
+ * National Laboratory with the U.S. Department of Energy/National Nuclear
+ * Security Administration. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * with the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of TRIAD, Los Alamos National Laboratory, LANL, the
+ *    U.S. Government, nor the names of its contributors may be used to endorse
+ *    or promote products derived from this software without specific prior
+ *    written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BenchStats.h"
+#include "OffloadServer.h"
+#include "PushdownProtocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <mutex>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * The link between the computational storage device and the host. Transfers
+ * are serialized: each chunk waits for the link to be free and holds it for
+ * its size divided by the bandwidth, so concurrent requests share it as they
+ * would a real link.
+ */
+class StorageLink
+{
+public:
+  explicit StorageLink(double bytesPerSecond)
+    : BytesPerSecond(bytesPerSecond)
+  {
+  }
+
+  /*
+   * Blocks until bytes went over the link. Unlimited if the bandwidth is 0.
+   */
+  void Transfer(size_t bytes)
+  {
+    if (this->BytesPerSecond <= 0)
+    {
+      return;
+    }
+    std::chrono::high_resolution_clock::time_point done;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      auto now = std::chrono::high_resolution_clock::now();
+      done = std::max(now, this->Free) +
+        std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+          std::chrono::duration<double>(bytes / this->BytesPerSecond));
+      this->Free = done;
+    }
+    std::this_thread::sleep_until(done);
+  }
+
+private:
+  const double BytesPerSecond;
+  std::mutex Mutex;
+  std::chrono::high_resolution_clock::time_point Free;
+};
+
+/*
+ * Copies a device result to the host over link, 1 MiB at a time so that the
+ * link paces the copy. It runs only once the device has answered, so even a
+ * streamed result reaches the host after contouring is over. Returns the
+ * bytes copied, or -1.
+ */
+long long CopyOverLink(StorageLink* link, const std::filesystem::path& from,
+  const std::filesystem::path& to)
+{
+  std::ifstream input(from, std::ios::in | std::ios::binary);
+  std::ofstream output(to, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!input || !output)
+  {
+    std::cerr << "Cannot copy " << from << " to " << to << std::endl;
+    return -1;
+  }
+  std::vector<char> chunk(1 << 20);
+  long long bytes = 0;
+  while (input)
+  {
+    input.read(chunk.data(), chunk.size());
+    const std::streamsize n = input.gcount();
+    if (n <= 0)
+    {
+      break;
+    }
+    link->Transfer(static_cast<size_t>(n));
+    output.write(chunk.data(), n);
+    output.flush();
+    bytes += n;
+  }
+  output.close();
+  return output.good() ? bytes : -1;
+}
+
+/*
+ * Starts the Offloader on the device side, serving deviceSpool and writing
+ * its results under deviceDir, pinned to the first cpus CPUs (all if 0).
+ */
+pid_t StartDevice(const std::vector<std::string>& offloader, const std::string& deviceSpool,
+  const std::string& deviceDir, int cpus)
+{
+  std::vector<std::string> args(offloader);
+  args.push_back("-q");
+  args.push_back(deviceSpool);
+  for (int i = 0; i < 3; i++)
+  {
+    args.push_back(deviceDir + "/result" + std::to_string(i));
+  }
+  std::vector<char*> argv;
+  for (std::string& arg : args)
+  {
+    argv.push_back(&arg[0]);
+  }
+  argv.push_back(nullptr);
+
+  pid_t pid = fork();
+  if (pid != 0)
+  {
+    return pid;
+  }
+  // A terminal interrupt reaches only the emulator, which then stops the device
+  setpgid(0, 0);
+  cpu_set_t allowed;
+  if (cpus > 0 && sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+  {
+    cpu_set_t device;
+    CPU_ZERO(&device);
+    for (int cpu = 0, n = 0; cpu < CPU_SETSIZE && n < cpus; cpu++)
+    {
+      if (CPU_ISSET(cpu, &allowed))
+      {
+        CPU_SET(cpu, &device);
+        n++;
+      }
+    }
+    sched_setaffinity(0, sizeof(device), &device);
+  }
+  execvp(argv[0], argv.data());
+  perror(argv[0]);
+  _exit(127);
+}
+
+/*
+ * Lets the device run for percent of every 100 ms period by stopping and
+ * continuing it, as a slower device CPU would. Exits the emulator if the
+ * device dies, since its pending requests would never be answered.
+ */
+void ThrottleDevice(pid_t device, int percent, const std::atomic<bool>* stop)
+{
+  const std::chrono::milliseconds period(100);
+  const auto running = period * std::clamp(percent, 1, 100) / 100;
+  while (!*stop)
+  {
+    int status;
+    if (waitpid(device, &status, WNOHANG) == device)
+    {
+      std::cout << std::flush;
+      std::cerr << "Device Offloader exited" << std::endl;
+      _exit(EXIT_FAILURE);
+    }
+    if (running < period)
+    {
+      kill(device, SIGCONT);
+      std::this_thread::sleep_for(running);
+      kill(device, SIGSTOP);
+      std::this_thread::sleep_for(period - running);
+    }
+    else
+    {
+      std::this_thread::sleep_for(period);
+    }
+  }
+  kill(device, SIGCONT);
+}
+
+int main(int argc, char* argv[])
+{
+  double bandwidth = 0;
+  double latency = 0;
+  int cpus = 0;
+  int percent = 100;
+  ServePool pool;
+  pool.Workers = 8;
+  pool.MatchRequestId = MatchesRequestId;
+  int c;
+  // "+" stops at the first non-option, leaving the Offloader's options alone
+  while ((c = getopt(argc, argv, "+B:L:C:F:p:h")) != -1)
+  {
+    switch (c)
+    {
+      case 'B':
+        bandwidth = atof(optarg);
+        break;
+      case 'L':
+        latency = atof(optarg);
+        break;
+      case 'C':
+        cpus = atoi(optarg);
+        break;
+      case 'F':
+        percent = atoi(optarg);
+        break;
+      case 'p':
+        pool.Workers = atoi(optarg);
+        break;
+      case 'h':
+      default:
+        std::cerr
+          << "Usage: StorageEmulator [options] spool_dir result_dir device_dir offloader "
+          << "[offloader options]" << std::endl
+          << "Stands in for the computational storage mount: runners submit with "
+          << "-q spool_dir -s result_dir/result, the Offloader runs on the device side in "
+          << "device_dir, and its results are copied back over the emulated link." << std::endl
+          << "-B to limit the link bandwidth (MiB/s), -L to add a per-request latency (ms), "
+          << "-C to pin the device to that many CPUs, -F to let it run only that percentage "
+          << "of the time, and -p to set how many requests are relayed at once" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+  }
+  argc -= optind;
+  argv += optind;
+  if (argc < 4)
+  {
+    std::cerr << "Lack spool, result and device directories or the Offloader" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const std::string spoolDir = argv[0];
+  const std::string resultDir = argv[1];
+  const std::string deviceDir = argv[2];
+  const std::string deviceSpool = deviceDir + "/spool";
+  const std::vector<std::string> offloader(argv + 3, argv + argc);
+  std::error_code ec;
+  std::filesystem::create_directories(resultDir, ec);
+  std::filesystem::create_directories(deviceSpool, ec);
+
+  std::cout << "link-bandwidth-mib: " << bandwidth << std::endl
+            << "link-latency-ms: " << latency << std::endl
+            << "device-cpus: " << cpus << std::endl
+            << "device-cpu-percent: " << percent << std::endl;
+  pid_t device = StartDevice(offloader, deviceSpool, deviceDir, cpus);
+  if (device < 0)
+  {
+    perror("fork");
+    exit(EXIT_FAILURE);
+  }
+  std::atomic<bool> stop(false);
+  std::thread throttle(ThrottleDevice, device, percent, &stop);
+
+  StorageLink link(bandwidth * (1 << 20));
+  std::mutex statsMutex;
+  LatencyStats linkTimes;
+  long long linkBytes = 0;
+  PooledQueryHandler relay = [&](const std::string& command, int) {
+    std::vector<PushdownQuery> queries;
+    std::string requestId;
+    if (!IsBatchCommand(command) || !ParseBatchCommand(command, &queries, &requestId) ||
+      requestId.empty())
+    {
+      // Version 1 results have fixed names that concurrent clients would share
+      std::cerr << "Only version 2 commands with a request id are relayed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    int rc = SubmitToSpool(deviceSpool.c_str(), requestId, command);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(latency));
+    const std::filesystem::path from(GetRequestResultDir(deviceDir, requestId));
+    const std::filesystem::path to(GetRequestResultDir(resultDir, requestId));
+    std::error_code ec;
+    std::filesystem::create_directories(to, ec);
+    long long bytes = 0;
+    for (const std::filesystem::directory_entry& entry :
+      std::filesystem::directory_iterator(from, ec))
+    {
+      long long n = CopyOverLink(&link, entry.path(), to / entry.path().filename());
+      if (n < 0)
+      {
+        rc = EXIT_FAILURE;
+        continue;
+      }
+      bytes += n;
+    }
+    std::filesystem::remove_all(from, ec);
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    const double seconds = std::chrono::duration<double>(t1 - t0).count();
+    std::lock_guard<std::mutex> lock(statsMutex);
+    linkTimes.Add(seconds);
+    linkBytes += bytes;
+    std::cout << "request-" << requestId << "-link-bytes: " << bytes << std::endl
+              << "request-" << requestId << "-link: " << seconds << std::endl;
+    return rc;
+  };
+  int rc = ServeSpool(spoolDir.c_str(), relay, pool);
+
+  stop = true;
+  throttle.join();
+  kill(device, SIGTERM);
+  waitpid(device, nullptr, 0);
+  std::cout << "link-bytes: " << linkBytes << std::endl;
+  linkTimes.Print(std::cout, "link");
+  return rc;
+}